@@ -64,6 +64,8 @@
 #define HTTP_TIMEOUT 5000
 #define WIFI_CONNECT_TIMEOUT 20000
 #define KEF_POLL_TIMEOUT 50000  // KEF uses 50s polling timeout
+#define KEF_EVENT_RETRY_MS 5000 // Delay before re-subscribing after the event queue drops
+#define KEF_JSON_ARENA_SIZE 4096 // Per-connection parse arena for filtered KEF replies
 
 // ============================================================================
 // HARDWARE PIN CONFIGURATION - Waveshare ESP32-S3 1.8" LCD
@@ -137,16 +139,47 @@
 // Polling intervals (milliseconds)
 #define KEF_STATE_POLL_INTERVAL 1000   // Poll KEF state every second
 #define UI_UPDATE_INTERVAL 50           // Update UI every 50ms (20 FPS)
+#define SPOTIFY_QUEUE_POLL_MS 30000     // Re-read the Spotify queue (next cover prefetch)
+
+// Spotify now-playing poll (USB source) — see state/spotify_sync.h
+#define SPOTIFY_POLL_PLAYING_MS    10000  // Longest gap while playing (catches phone-side changes)
+#define SPOTIFY_POLL_END_MARGIN_MS 1000   // Poll this long after the predicted track end
+#define SPOTIFY_POLL_PAUSED_MS     5000   // Paused
+#define SPOTIFY_POLL_IDLE_MS       15000  // Nothing playing (HTTP 204); also the error backoff cap
+#define SPOTIFY_POLL_RETRY_MS      1000   // First retry after a failed poll, doubling
+#define SPOTIFY_POLL_CONFIRM_MS    1000   // Follow-up polls after a command
+#define SPOTIFY_TOKEN_REFRESH_AHEAD_S 300 // Background token refresh this long before expiry
+#define SPOTIFY_TOKEN_RETRY_MS     30000  // Retry spacing after a failed token refresh
+
+// Track progress clock — see state/playback_clock.h
+#define PLAYBACK_SLEW_MS           2000   // Absorb a small position error over this long
+#define PLAYBACK_SNAP_MS           1000   // ...larger errors (seek, skip) jump instead
 
 // Input control
-#define VOLUME_DEBOUNCE_MS  250   // Delay before sending volume to speaker
+#define VOLUME_DEBOUNCE_MS  250   // Initial spacing between volume sends (adapts at runtime)
+#define VOLUME_GAP_MIN_MS   100   // Adaptive volume send spacing lower bound
+#define VOLUME_GAP_MAX_MS   1000  // ...and upper bound
+#define VOLUME_GAP_STEP_MS  10    // Spacing reduction per confirmed send
+#define VOLUME_SETTLE_MS    3000  // Volume readbacks are not applied this long after a send
+#define VOLUME_CONFIRM_MS   4500  // Window for a speaker readback to confirm a send (> settle + one poll)
+#define VOLUME_MAX_RETRIES  2     // Re-sends of a rejected volume before it is dropped
 #define SWIPE_THRESHOLD     50    // Pixels of horizontal movement = swipe
+#define CMD_QUEUE_LEN       16    // Core 1 → Core 0 command ring slots (power of two)
+#define OPT_PENDING_TIMEOUT_MS  3000   // Unconfirmed optimistic mute/play/source rolls back
+#define OPT_POWER_TIMEOUT_MS    10000  // ...power gets longer: waking from standby is slow
 
 // Album artwork
 #define ALBUM_ART_SIZE       360          // Decoded canvas px — fills the round display
-#define ALBUM_ART_JPEG_SCALE 1            // TJpgDec full-res; center-crop in callback
+#define ALBUM_ART_JPEG_SCALE 1            // tjpgd full-res; center-crop in callback
 #define ALBUM_ART_JPEG_SRC   640          // Spotify standard JPEG dimension (px)
 #define ALBUM_ART_MAX_JPEG   (256 * 1024) // Max JPEG bytes to allocate in PSRAM
+#define ART_CACHE_BUDGET     (3 * 1024 * 1024) // PSRAM for decoded covers (~12 × 253 KB frames)
+#define ART_STORE_BUDGET     (3 * 1024 * 1024) // Flash (LittleFS, 3.4 MB spiffs partition) for cover JPEGs
+#define ART_STORE_FLUSH_MS   (10 * 60 * 1000)  // Longest a flash hit's recency waits to be written
+#define ART_SMALL_MAX_COST_PCT 75         // Fetch the 300 px cover only if it costs < 75% of the 640 px one
+#define ART_FADE_STEPS       8            // Cross-fade passes between covers (1 = cut)
+#define ART_FADE_ROWS        8            // Rows blended between budget checks
+#define ART_FADE_BUDGET_US   4000         // Blend time per loop() so the UI keeps its frame rate
 
 // ============================================================================
 // MICROPHONE CONFIGURATION — PDM MEMS mic (MSM261D4030H1CPM) on I2S0
@@ -154,8 +187,14 @@
 
 #define MIC_PDM_CLK_PIN    45       // PDM clock  GPIO (WS in I2S PDM RX mode)
 #define MIC_PDM_DATA_PIN   46       // PDM data   GPIO (DIN)
-#define MIC_N_BARS         20       // number of waveform bars
-#define MIC_BAR_MS         80       // ms between bar advances (20 bars = 1.6 s window)
+#define MIC_SAMPLE_RATE    16000    // Hz; one 512-sample analysis block = 32 ms
+
+// Spectrum analyser bands (audio/spectrum): MIC_BANDS log-spaced bands from
+// MIC_BAND_LO_HZ to MIC_BAND_HI_HZ.  The waveform folds them into its four waves.
+#define MIC_BANDS          4
+#define MIC_BAND_LO_HZ     62.5f
+#define MIC_BAND_HI_HZ     8000.0f
+#define MIC_BAR_MS         80       // ms between waveform frames (wave task period)
 
 // Waveform canvas dimensions (px).  Sine waves grow symmetrically from the centre line.
 // Width: 160 px — stays inside arc inner boundary (±96 px at canvas y level).
@@ -163,6 +202,23 @@
 #define WAVE_CANVAS_W      160
 #define WAVE_CANVAS_H      56
 
+// Fraction of the remaining height each wave jumps on a detected beat
+// (audio/beat_tracker via the mic snapshot).  0 turns the pulse off.
+#define WAVE_BEAT_LIFT     0.35f
+
+// Auto-level (state/auto_level): follow the room's ambient noise with the
+// volume.  Opt-in — 0 leaves the volume entirely to the user.
+#define AUTO_LEVEL_ENABLED       0
+#define AUTO_LEVEL_VOL_MIN       5        // Auto-level never turns the volume below...
+#define AUTO_LEVEL_VOL_MAX       60       // ...or above this (the user still can)
+#define AUTO_LEVEL_RANGE         10       // Most steps away from the user's own setting
+#define AUTO_LEVEL_STEPS_PER_DB  1.0f     // Volume steps per dB the room gets louder or quieter
+#define AUTO_LEVEL_DEADBAND_DB   3.0f     // Ambient changes smaller than this are ignored
+#define AUTO_LEVEL_SETTLE_MS     1500     // Speaker silent this long before the mic hears only the room
+#define AUTO_LEVEL_AVG_S         8        // Ambient estimate averages over about this many seconds
+#define AUTO_LEVEL_NUDGE_MS      4000     // At most one step per (outlasts VOLUME_SETTLE_MS)
+#define AUTO_LEVEL_HOLD_MS       30000    // No nudges this long after the user sets the volume
+
 // ============================================================================
 // HAPTIC CONFIGURATION — DRV2605 on I2C_NUM_0 (shared with touch)
 // ============================================================================
@@ -185,12 +241,14 @@
 #define HAPTIC_EFFECT_CLICK   1    // Strong Click 100%  — encoder step
 #define HAPTIC_EFFECT_STRONG  14   // Sharp Click 100%   — play/pause, power on/off
 #define HAPTIC_EFFECT_MEDIUM  10   // Strong Click 60%   — next/prev, mute, source switch
+#define HAPTIC_EFFECT_BEAT    0    // e.g. 24 Sharp Tick 100% — music beat while playing (off)
 
 // Internal event codes (used between encoder callbacks and loop())
 #define HAPTIC_NONE    0
 #define HAPTIC_CLICK   1
 #define HAPTIC_STRONG  2
 #define HAPTIC_MEDIUM  3
+#define HAPTIC_BEAT    4
 
 // ============================================================================
 // DEBUG CONFIGURATION
@@ -199,7 +257,12 @@
 // Enable serial debug output
 #define DEBUG_ENABLED 1
 
-#if DEBUG_ENABLED
+// Report the slowest loop() iteration (UI stall) and the iteration-time
+// histogram this often
+#define LOOP_STATS_INTERVAL_MS 10000
+
+// Serial only exists on the device; host test builds log nothing.
+#if DEBUG_ENABLED && defined(ARDUINO)
     #define DEBUG_PRINT(x) Serial.print(x)
     #define DEBUG_PRINTLN(x) Serial.println(x)
     #define DEBUG_PRINTF(fmt, ...) Serial.printf(fmt, ##__VA_ARGS__)
@@ -214,13 +277,25 @@
 // ============================================================================
 
 // Task priorities (higher number = higher priority)
+// The Core 0 network workers are ranked so a user tap is never queued behind
+// a slow service: control pre-empts state sync, which pre-empts Spotify and
+// album art (both HTTPS, hundreds of ms per request).
 #define UI_TASK_PRIORITY 10
-#define NETWORK_TASK_PRIORITY 5
 #define INPUT_TASK_PRIORITY 8
+#define CONTROL_TASK_PRIORITY 7
+#define STATE_TASK_PRIORITY 5
+#define SPOTIFY_TASK_PRIORITY 4
+#define ART_TASK_PRIORITY 3
+#define WAVE_TASK_PRIORITY 2   // Pure CPU; yields to everything that talks to the network
 
 // Task stack sizes
 #define UI_TASK_STACK_SIZE      (4 * 1024)   // UI handled in loop(), minimal task
-#define NETWORK_TASK_STACK_SIZE (36 * 1024)  // HTTP + JSON + TLS (KEF + Spotify HTTPS)
+#define CONTROL_TASK_STACK_SIZE (8 * 1024)   // Plain HTTP setData + MQTT publish
+#define STATE_TASK_STACK_SIZE   (8 * 1024)   // Plain HTTP getData + filtered JSON
+#define SPOTIFY_TASK_STACK_SIZE (20 * 1024)  // HTTPS (TLS handshake) + JSON
+#define ART_TASK_STACK_SIZE     (16 * 1024)  // HTTPS JPEG download
+#define KEF_EVENT_TASK_STACK_SIZE (8 * 1024) // Plain HTTP long-poll + filtered JSON
+#define WAVE_TASK_STACK_SIZE    (4 * 1024)   // Waveform render, no I/O
 
 // Task core assignments
 #define UI_TASK_CORE 1
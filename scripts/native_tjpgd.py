@@ -0,0 +1,22 @@
+"""Pre-build step for [env:native] — compiles tjpgd.c from bodmer/TJpg_Decoder
+so ui/art_decode.cpp can be benchmarked on the host.
+
+The rest of the library needs Arduino and the SD/SPIFFS file systems, so it
+is not in the env's lib_deps (the dependency finder would build all of it);
+the package is fetched into the env's libdeps dir here and only its decoder
+core is built and put on the include path.  Same version as the board env.
+"""
+import os
+
+from platformio.package.manager.library import LibraryPackageManager
+
+Import("env")  # noqa: F821 — provided by PlatformIO
+
+SPEC = "bodmer/TJpg_Decoder@^1.1.0"
+
+lm = LibraryPackageManager(env.subst("$PROJECT_LIBDEPS_DIR/$PIOENV"))
+pkg = lm.get_package(SPEC) or lm.install(SPEC)
+src = os.path.join(pkg.path, "src")
+
+env.Append(CPPPATH=[src])
+env.BuildSources(os.path.join("$BUILD_DIR", "tjpgd"), src, src_filter="-<*> +<tjpgd.c>")
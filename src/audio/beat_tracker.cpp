@@ -0,0 +1,192 @@
+#include "beat_tracker.h"
+
+#include <math.h>
+#include <string.h>
+
+#define ACF_TIME_MS      8000.0f   // autocorrelation memory
+#define STATS_TIME_MS    1000.0f   // onset threshold memory
+#define PRIOR_OCTAVES    0.7f      // spread of the tempo prior (std dev, octaves)
+#define MIN_CONFIDENCE   2.5f      // best comb score over the mean comb score
+#define PERIOD_FOLLOW    0.1f      // how fast the period follows a nearby estimate
+#define PHASE_WINDOW     0.25f     // onsets within ±this many periods steer the phase
+#define PHASE_GAIN       0.3f      // fraction of the phase error corrected per onset
+#define MAX_MISSES       8         // off-beat onsets in a row before the phase is dropped
+#define BEAT_COMB        4         // period multiples scored per candidate
+
+// ---------------------------------------------------------------------------
+// Setup
+// ---------------------------------------------------------------------------
+
+void beat_init(BeatTracker *b, float block_ms) {
+    memset(b, 0, sizeof(*b));
+    b->block_ms = block_ms > 0.0f ? block_ms : 32.0f;
+
+    float per_min = 60000.0f / b->block_ms;          // blocks per minute
+    b->lag_min = (int)floorf(per_min / BEAT_BPM_MAX);
+    b->lag_max = (int)ceilf(per_min / BEAT_BPM_MIN);
+    if (b->lag_min < 2) b->lag_min = 2;
+    if (b->lag_max > BEAT_MAX_LAG - 1) b->lag_max = BEAT_MAX_LAG - 1;
+    if (b->lag_max <= b->lag_min) b->lag_max = b->lag_min + 1;
+
+    b->decay = expf(-b->block_ms / ACF_TIME_MS);
+
+    for (int l = 1; l <= BEAT_MAX_LAG; l++) {
+        float oct = log2f(per_min / l / BEAT_BPM_PRIOR) / PRIOR_OCTAVES;
+        b->prior[l] = expf(-0.5f * oct * oct);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Tempo
+// ---------------------------------------------------------------------------
+
+// Autocorrelation mass near a fractional lag: the nearest whole lag on each
+// side of it (and the lag itself when it is whole).  Onsets land on whole
+// blocks, so a period of 14.6 blocks shows up split between lags 14 and 15;
+// summing the window scores it as fairly as a period that happens to be a
+// whole number of blocks.
+static float acf_near(const BeatTracker *b, float x) {
+    int i  = (int)x;                              // x > 0, so this is floor
+    int lo = ((float)i == x) ? i - 1 : i;         // nearest whole lag on each side
+    int hi = i + 1;
+    if (lo < 1) lo = 1;
+    if (hi > BEAT_MAX_LAG) return 0.0f;
+    float s = 0.0f;
+    for (int l = lo; l <= hi; l++) s += b->acf[l];
+    return s;
+}
+
+// Comb score of a candidate period: a real beat also repeats at 2, 3, 4…
+// periods, so its first BEAT_COMB multiples all count.
+static float comb_score(const BeatTracker *b, float p) {
+    float s = 0.0f;
+    for (int k = 1; k <= BEAT_COMB; k++) s += acf_near(b, k * p) / k;
+    return s;
+}
+
+static float prior_at(const BeatTracker *b, float p) {
+    int   l = (int)p;
+    float f = p - l;
+    return b->prior[l] + f * (b->prior[l + 1] - b->prior[l]);
+}
+
+static void update_tempo(BeatTracker *b) {
+    // Not enough history for the slowest tempo, or nothing but silence.
+    if (b->blocks < (uint32_t)(2 * b->lag_max) || b->acf[0] <= 1e-9f) {
+        b->period = 0.0f;
+        b->confidence = 0.0f;
+        return;
+    }
+
+    // Candidate periods on a quarter-block grid; the prior picks among them,
+    // but confidence is judged on the comb alone (the prior would otherwise
+    // give a flat autocorrelation a clear winner).
+    float best_p = 0.0f, best = -1.0f, best_comb = 0.0f, total = 0.0f;
+    int   count = 0;
+    for (float p = (float)b->lag_min; p <= (float)b->lag_max; p += 0.25f) {
+        float c = comb_score(b, p);
+        float s = c * prior_at(b, p);
+        total += c;
+        count++;
+        if (s > best) { best = s; best_p = p; best_comb = c; }
+    }
+    float mean = total / count;
+    b->confidence = mean > 0.0f ? best_comb / mean : 0.0f;
+    if (b->confidence < MIN_CONFIDENCE) {
+        b->period = 0.0f;
+        return;
+    }
+
+    if (b->period > 0.0f && fabsf(best_p - b->period) < 0.1f * b->period) {
+        b->period += PERIOD_FOLLOW * (best_p - b->period);
+    } else {
+        b->period = best_p;   // first estimate, or a real tempo change
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Per block
+// ---------------------------------------------------------------------------
+
+bool beat_update(BeatTracker *b, float flux) {
+    const uint32_t t = b->blocks;
+    if (flux < 0.0f) flux = 0.0f;
+
+    // Onset: the previous block was a local peak above the threshold.
+    float thresh = b->mean + BEAT_THRESH_K * b->dev;
+    bool onset = false;
+    if (t >= 2 && b->prev_flux > thresh &&
+        b->prev_flux > b->prev2_flux && b->prev_flux >= flux) {
+        uint32_t at = t - 1;
+        if (!b->have_onset || (float)(at - b->last_onset) * b->block_ms >= BEAT_MIN_IOI_MS) {
+            onset         = true;
+            b->last_onset = at;
+            b->have_onset = true;
+            b->onsets++;
+        }
+    }
+
+    // Running flux statistics (after the test, so a peak cannot raise its own bar).
+    float a = b->block_ms / STATS_TIME_MS;
+    if (a > 1.0f) a = 1.0f;
+    b->mean += a * (flux - b->mean);
+    b->dev  += a * (fabsf(flux - b->mean) - b->dev);
+
+    // Onset strength into the ring, then the leaky autocorrelation.
+    float o = flux - b->mean;
+    if (o < 0.0f) o = 0.0f;
+    const int ring = BEAT_MAX_LAG + 1;
+    int head = (int)(t % ring);
+    b->odf[head] = o;
+    for (int l = 0; l <= BEAT_MAX_LAG && (uint32_t)l <= t; l++) {
+        int i = head - l;
+        if (i < 0) i += ring;
+        b->acf[l] = b->acf[l] * b->decay + o * b->odf[i];
+    }
+
+    b->prev2_flux = b->prev_flux;
+    b->prev_flux  = flux;
+    b->blocks     = t + 1;
+
+    update_tempo(b);
+    if (b->period <= 0.0f) {
+        b->locked = false;
+        return false;
+    }
+
+    // Phase: seed on an onset, then let onsets near a prediction steer it.
+    if (onset) {
+        float at = (float)(t - 1);
+        if (!b->locked) {
+            b->next_beat = at + b->period;
+            b->locked    = true;
+            b->misses    = 0;
+        } else {
+            float err  = at - b->next_beat;
+            float errp = at - (b->next_beat - b->period);   // vs the beat just gone
+            if (fabsf(errp) < fabsf(err)) err = errp;
+            if (fabsf(err) <= PHASE_WINDOW * b->period) {
+                b->next_beat += PHASE_GAIN * err;
+                b->misses = 0;
+            } else if (++b->misses >= MAX_MISSES) {
+                b->locked = false;                          // re-seed on the next onset
+            }
+        }
+    }
+
+    if (b->locked && (float)(t - b->last_onset) * b->block_ms > BEAT_HOLD_MS) {
+        b->locked = false;   // silence or no rhythm: keep the tempo, stop the beats
+    }
+
+    if (b->locked && (float)t + 0.5f >= b->next_beat) {
+        while (b->next_beat <= (float)t + 0.5f) b->next_beat += b->period;
+        b->beats++;
+        return true;
+    }
+    return false;
+}
+
+float beat_bpm(const BeatTracker *b) {
+    if (b->period <= 0.0f) return 0.0f;
+    return 60000.0f / (b->period * b->block_ms);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Onset and beat tracker fed one spectral-flux value per mic block.
+ *
+ * Onsets: the flux is compared against an adaptive threshold — a running
+ * mean plus BEAT_THRESH_K running mean deviations — and an onset is a local
+ * peak above it, no closer than BEAT_MIN_IOI_MS to the previous one.
+ *
+ * Tempo: the onset strength (flux above its mean) feeds a leaky
+ * autocorrelation.  Candidate periods for BEAT_BPM_MIN..BEAT_BPM_MAX, on a
+ * quarter-block grid, are scored by a comb over their first four multiples;
+ * a log-normal prior around BEAT_BPM_PRIOR picks between octaves, and the
+ * tempo only counts once the best comb clearly stands out from the rest.
+ *
+ * Beats: once the tempo is confident, a predicted beat is emitted every
+ * period; onsets near a prediction pull the phase towards them (a first-
+ * order phase-locked loop), and the first onset after losing lock restarts
+ * the phase on it.  Lock is lost after MAX_MISSES off-beat onsets in a row
+ * or BEAT_HOLD_MS without any onset (the music stopped).
+ *
+ * Constant memory, no allocation, O(lags) per block.  Time is counted in
+ * blocks; the caller says how long a block is.  Pure C — no Arduino or
+ * FreeRTOS dependencies.
+ */
+
+#define BEAT_BPM_MIN       60.0f
+#define BEAT_BPM_MAX       200.0f
+#define BEAT_BPM_PRIOR     120.0f     // centre of the tempo prior
+#define BEAT_MAX_LAG       128        // blocks; 4 × the BEAT_BPM_MIN period at 32 ms blocks
+#define BEAT_THRESH_K      1.5f       // onset threshold, mean deviations above the mean
+#define BEAT_MIN_IOI_MS    100.0f     // minimum gap between onsets
+#define BEAT_HOLD_MS       2000.0f    // stop emitting beats this long after the last onset
+
+typedef struct {
+    float    block_ms;                 // duration of one block
+    int      lag_min, lag_max;         // autocorrelation lags searched (blocks)
+    float    decay;                    // per-block leak of the autocorrelation
+
+    // Onset detection
+    float    mean, dev;                // running flux mean / mean absolute deviation
+    float    prev_flux, prev2_flux;
+    uint32_t last_onset;               // block index of the last onset
+    bool     have_onset;
+
+    // Tempo
+    float    odf[BEAT_MAX_LAG + 1];    // onset strength ring buffer
+    float    acf[BEAT_MAX_LAG + 1];    // leaky autocorrelation, by lag
+    float    prior[BEAT_MAX_LAG + 1];  // tempo prior weight, by lag
+    float    period;                   // beat period in blocks, 0 = unknown
+    float    confidence;               // best score / mean score
+
+    // Beat phase
+    float    next_beat;                // block index of the next predicted beat
+    bool     locked;                   // an onset has confirmed the phase
+    uint8_t  misses;                   // off-beat onsets in a row
+
+    uint32_t blocks;                   // blocks fed so far
+    uint32_t onsets;                   // onsets detected so far
+    uint32_t beats;                    // beats emitted so far
+} BeatTracker;
+
+/** block_ms: audio per flux value (32 ms for 512 samples at 16 kHz). */
+void beat_init(BeatTracker *b, float block_ms);
+
+/**
+ * Feed one block's spectral flux.  Returns true if a beat falls in this
+ * block.  Onsets are reported one block late (the peak needs its right-hand
+ * neighbour); beats are predictions and are not.
+ */
+bool beat_update(BeatTracker *b, float flux);
+
+/** Current tempo, or 0 while there is no confident estimate. */
+float beat_bpm(const BeatTracker *b);
@@ -0,0 +1,75 @@
+#include "mic_snapshot.h"
+
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// Sequence lock
+//
+// The release fence after the odd store keeps the data stores from moving
+// above it; the final release store keeps them from moving below the even
+// one.  On the reader side the acquire fence orders the data loads before
+// the second sequence load.
+// ---------------------------------------------------------------------------
+
+void mic_slot_publish(MicSlot *slot, const MicSnapshot *snap) {
+    uint32_t s = slot->seq.load(std::memory_order_relaxed);
+    slot->seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot->data, snap, sizeof(*snap));
+    slot->seq.store(s + 2, std::memory_order_release);
+}
+
+bool mic_slot_read(MicSlot *slot, MicSnapshot *out) {
+    for (int i = 0; i < MIC_SLOT_READ_TRIES; i++) {
+        uint32_t s1 = slot->seq.load(std::memory_order_acquire);
+        if (s1 == 0) return false;       // never written
+        if (s1 & 1) continue;            // write in progress
+
+        MicSnapshot copy;
+        memcpy(&copy, &slot->data, sizeof(copy));
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot->seq.load(std::memory_order_relaxed) == s1) {
+            *out = copy;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// Consumer tracking
+// ---------------------------------------------------------------------------
+
+void mic_track_init(MicTrack *t) {
+    memset(t, 0, sizeof(*t));
+}
+
+uint32_t mic_track_push(MicTrack *t, const MicSnapshot *snap) {
+    if (snap->seq == t->cur.seq) return 0;
+
+    uint32_t skipped = 0;
+    if (t->cur.seq != 0 && snap->seq - t->cur.seq > 1) {
+        skipped = snap->seq - t->cur.seq - 1;
+    }
+    t->missed += skipped;
+    t->prev = t->cur;
+    t->cur  = *snap;
+    return skipped;
+}
+
+float mic_track_band(const MicTrack *t, int band, uint32_t now_us) {
+    if (band < 0 || band >= SPECTRUM_MAX_BANDS) return 0.0f;
+    float b = t->cur.bands[band];
+    if (t->prev.seq == 0) return b;
+
+    float a = t->prev.bands[band];
+    int32_t span = (int32_t)(t->cur.capture_us - t->prev.capture_us);
+    if (span <= 0) return b;
+
+    // Wrap-safe: everything is a signed difference from prev's capture.
+    int32_t at = (int32_t)(now_us - t->cur.block_us - t->prev.capture_us);
+    if (at <= 0)    return a;
+    if (at >= span) return b;
+    return a + (b - a) * ((float)at / (float)span);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include "spectrum.h"
+
+/**
+ * One mic block's analysis, and the lock-free slot it is published through.
+ *
+ * The mic task is the only writer; readers may run on either core at any
+ * priority.  The slot is a sequence lock: the writer makes the sequence odd,
+ * copies the snapshot in and makes it even again; a reader copies the
+ * snapshot out between two reads of the sequence and keeps the copy only if
+ * both were the same even value.  Nobody ever waits on a lock, so a reader
+ * that pre-empts the writer on its own core cannot deadlock — after
+ * MIC_SLOT_READ_TRIES torn copies mic_slot_read() gives up and the caller
+ * keeps the snapshot it already has.
+ *
+ * MicTrack is the consumer side: it keeps the last two snapshots, counts
+ * blocks a slow reader never saw, and interpolates band levels between the
+ * two so a renderer at any frame rate gets smooth motion instead of ~30 Hz
+ * steps.  Pure C++ — std::atomic only, no Arduino or FreeRTOS dependencies.
+ */
+
+// Bump when the layout or the meaning of a field changes.
+#define MIC_SNAPSHOT_VERSION 3
+
+#define MIC_SLOT_READ_TRIES  4
+
+typedef struct {
+    uint16_t version;                     // MIC_SNAPSHOT_VERSION; 0 = nothing published yet
+    uint8_t  n_bands;                     // bands in use (MIC_BANDS)
+    uint8_t  level;                       // overall smoothed amplitude 0–255
+    uint32_t seq;                         // block number, first block = 1; a gap = missed blocks
+    uint32_t capture_us;                  // µs clock (wraps) when the block's last sample arrived
+    uint32_t block_us;                    // audio covered by the block
+    float    rms;                         // block RMS, PCM counts (unsmoothed)
+    float    peak;                        // largest |sample − mean| in the block, PCM counts
+    float    flux;                        // spectral flux, PCM counts (unsmoothed)
+    uint32_t onsets;                      // onsets detected so far (audio/beat_tracker)
+    uint32_t beats;                       // beats emitted so far; a change = a new beat
+    uint32_t beat_us;                     // capture_us of the block holding the last beat
+    float    bpm;                         // tempo, 0 while there is no confident estimate
+    uint8_t  bands[SPECTRUM_MAX_BANDS];   // smoothed band energy 0–255, lowest band first
+} MicSnapshot;
+
+typedef struct {
+    std::atomic<uint32_t> seq;            // odd while a write is in progress
+    MicSnapshot           data;
+} MicSlot;
+
+/** Writer only.  Never blocks. */
+void mic_slot_publish(MicSlot *slot, const MicSnapshot *snap);
+
+/**
+ * Copy the latest snapshot into *out.  Returns false — leaving *out alone —
+ * if nothing has been published or every try raced a write.
+ */
+bool mic_slot_read(MicSlot *slot, MicSnapshot *out);
+
+typedef struct {
+    MicSnapshot prev;                     // second-newest snapshot seen
+    MicSnapshot cur;                      // newest snapshot seen
+    uint32_t    missed;                   // blocks published but never seen, total
+} MicTrack;
+
+void mic_track_init(MicTrack *t);
+
+/**
+ * Feed the snapshot just read.  Returns the number of blocks skipped since
+ * the previous new snapshot (0 when keeping up); a repeat of cur is ignored.
+ */
+uint32_t mic_track_push(MicTrack *t, const MicSnapshot *snap);
+
+/**
+ * Band level 0–255 at time now_us, interpolated between prev and cur.
+ * Playback runs one block behind capture (cur is reached block_us after it
+ * arrived), which keeps the result between two real measurements instead
+ * of extrapolating.  Holds at the ends; returns cur's value if there is no
+ * prev yet.
+ */
+float mic_track_band(const MicTrack *t, int band, uint32_t now_us);
@@ -0,0 +1,230 @@
+#include "spectrum.h"
+
+#include <math.h>
+#include <string.h>
+
+static const int N = SPECTRUM_N;
+static const int M = SPECTRUM_BINS;   // complex FFT size
+
+// ---------------------------------------------------------------------------
+// Setup
+// ---------------------------------------------------------------------------
+
+void spectrum_init(Spectrum *s, int n_bands, float lo_hz, float hi_hz, float sample_hz) {
+    memset(s, 0, sizeof(*s));
+
+    // Periodic Hann: the block repeats, so the window should too.
+    float sum_sq = 0.0f;
+    for (int i = 0; i < N; i++) {
+        float w = 0.5f - 0.5f * cosf(6.28318531f * (float)i / N);
+        s->window[i] = w;
+        sum_sq += w * w;
+    }
+    // One-sided bin power → mean square of the unwindowed signal.
+    s->power_scale = 2.0f / ((float)N * sum_sq);
+
+    for (int k = 0; k < SPECTRUM_TWIDDLES; k++) {
+        s->cos_tw[k] = cosf(6.28318531f * (float)k / N);
+        s->sin_tw[k] = sinf(6.28318531f * (float)k / N);
+    }
+
+    int bits = 0;
+    while ((1 << bits) < M) bits++;
+    for (int i = 0; i < M; i++) {
+        int r = 0;
+        for (int b = 0; b < bits; b++) {
+            if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+        }
+        s->bitrev[i] = (uint16_t)r;
+    }
+
+    // Log-spaced band edges, rounded to bins.  Bin 0 (DC) is never used and
+    // the last usable bin is Nyquist (M).
+    if (n_bands < 1) n_bands = 1;
+    if (n_bands > SPECTRUM_MAX_BANDS) n_bands = SPECTRUM_MAX_BANDS;
+    float bin_hz = sample_hz / N;
+    if (lo_hz < bin_hz) lo_hz = bin_hz;
+    if (hi_hz <= lo_hz) hi_hz = lo_hz * 2.0f;
+
+    int lo = (int)lrintf(lo_hz / bin_hz);
+    if (lo < 1) lo = 1;
+    if (lo > M) lo = M;
+    s->edge[0] = (uint16_t)lo;
+
+    int used = 0;
+    for (int b = 1; b <= n_bands; b++) {
+        float f = lo_hz * powf(hi_hz / lo_hz, (float)b / n_bands);
+        int e = (int)lrintf(f / bin_hz);
+        if (e <= s->edge[b - 1]) e = s->edge[b - 1] + 1;  // at least one bin each
+        if (e > M + 1) e = M + 1;
+        if (e <= s->edge[b - 1]) break;                    // ran out of bins
+        s->edge[b] = (uint16_t)e;
+        used = b;
+    }
+    s->n_bands = used;
+}
+
+// ---------------------------------------------------------------------------
+// FFT
+//
+// x[2m] + i·x[2m+1] is packed into one complex sequence of length M, run
+// through an in-place decimation-in-time FFT, and split back into the
+// N-point real spectrum.
+//
+// The complex FFT takes its input bit-reversed and does two radix-2 stages
+// per pass as one radix-4 butterfly: with W = e^(−2πi/4h) and
+//   B = W^2j·b,  C = W^j·c,  D = W^3j·d
+// the four outputs are a+B ± (C+D) and a−B ∓ i(C−D) — three complex
+// multiplies per four points instead of four, and half the passes over
+// the buffer.  M must be a power of four.
+// ---------------------------------------------------------------------------
+
+static void fft_complex(float *re, float *im, const float *cos_tw, const float *sin_tw) {
+    static_assert((SPECTRUM_BINS & 0x5555) == SPECTRUM_BINS, "radix-4 FFT needs M = 4^k");
+
+    // First pass (h = 1): all twiddles are 1.
+    for (int i = 0; i < M; i += 4) {
+        float ar = re[i],     ai = im[i];
+        float br = re[i + 1], bi = im[i + 1];
+        float cr = re[i + 2], ci = im[i + 2];
+        float dr = re[i + 3], di = im[i + 3];
+        float pr = ar + br, pi = ai + bi;   // a + B
+        float mr = ar - br, mi = ai - bi;   // a − B
+        float sr = cr + dr, si = ci + di;   // C + D
+        float tr = cr - dr, ti = ci - di;   // C − D
+        re[i]     = pr + sr;  im[i]     = pi + si;
+        re[i + 2] = pr - sr;  im[i + 2] = pi - si;
+        re[i + 1] = mr + ti;  im[i + 1] = mi - tr;   // a − B − i(C − D)
+        re[i + 3] = mr - ti;  im[i + 3] = mi + tr;
+    }
+
+    for (int h = 4; h < M; h <<= 2) {
+        int len   = h << 2;
+        int tstep = N / len;                  // W^j is entry j·tstep of the N-point table
+        for (int j = 0; j < h; j++) {
+            float w1r = cos_tw[j * tstep],     w1i = -sin_tw[j * tstep];
+            float w2r = cos_tw[2 * j * tstep], w2i = -sin_tw[2 * j * tstep];
+            float w3r = cos_tw[3 * j * tstep], w3i = -sin_tw[3 * j * tstep];
+            for (int i = j; i < M; i += len) {
+                int   ib = i + h, ic = i + 2 * h, id = i + 3 * h;
+                float ar = re[i], ai = im[i];
+                float Br = re[ib] * w2r - im[ib] * w2i, Bi = re[ib] * w2i + im[ib] * w2r;
+                float Cr = re[ic] * w1r - im[ic] * w1i, Ci = re[ic] * w1i + im[ic] * w1r;
+                float Dr = re[id] * w3r - im[id] * w3i, Di = re[id] * w3i + im[id] * w3r;
+                float pr = ar + Br, pi = ai + Bi;
+                float mr = ar - Br, mi = ai - Bi;
+                float sr = Cr + Dr, si = Ci + Di;
+                float tr = Cr - Dr, ti = Ci - Di;
+                re[i]  = pr + sr;  im[i]  = pi + si;
+                re[ic] = pr - sr;  im[ic] = pi - si;
+                re[ib] = mr + ti;  im[ib] = mi - tr;
+                re[id] = mr - ti;  im[id] = mi + tr;
+            }
+        }
+    }
+}
+
+// sqrt to a few percent, for the flux only (band levels use sqrtf).
+static inline float approx_sqrt(float x) {
+    union { float f; uint32_t u; } v = { x };
+    v.u = 0x1fbd1df5u + (v.u >> 1);
+    return v.f;
+}
+
+// Mean-remove, window and pack one block into s->re / s->im (bit-reversed).
+// Fills in the time-domain RMS and peak.
+static void load_block(Spectrum *s, const int16_t *pcm, int n, SpectrumFrame *out) {
+    if (n > N) n = N;
+    if (n < 0) n = 0;
+
+    float mean = 0.0f;
+    for (int i = 0; i < n; i++) mean += pcm[i];
+    mean = n > 0 ? mean / n : 0.0f;
+
+    float sq = 0.0f, peak = 0.0f;
+    for (int m = 0; m < M; m++) {
+        int   i0 = 2 * m, i1 = 2 * m + 1;
+        float a0 = i0 < n ? pcm[i0] - mean : 0.0f;
+        float a1 = i1 < n ? pcm[i1] - mean : 0.0f;
+        sq += a0 * a0 + a1 * a1;
+        peak = fmaxf(peak, fmaxf(fabsf(a0), fabsf(a1)));
+        int r = s->bitrev[m];
+        s->re[r] = a0 * s->window[i0];
+        s->im[r] = a1 * s->window[i1];
+    }
+    out->rms  = n > 0 ? sqrtf(sq / n) : 0.0f;
+    out->peak = peak;
+}
+
+// ---------------------------------------------------------------------------
+// Analysis
+// ---------------------------------------------------------------------------
+
+void spectrum_run(Spectrum *s, const int16_t *pcm, int n, SpectrumFrame *out) {
+    memset(out, 0, sizeof(*out));
+    load_block(s, pcm, n, out);
+    fft_complex(s->re, s->im, s->cos_tw, s->sin_tw);
+
+    // Split pass, only over the bins some band uses.  For Z = FFT(z):
+    //   X[k] = ½(Z[k] + Z*[M−k]) − ½i·W^k·(Z[k] − Z*[M−k]),  W = e^(−2πi/N)
+    const int first = s->edge[0];
+    const int last  = s->edge[s->n_bands];   // exclusive
+    int   band  = 0;
+    float acc   = 0.0f;
+    float flux  = 0.0f;
+    for (int k = first; k < last; k++) {
+        float xr, xi;
+        if (k == M) {                          // Nyquist: Re Z[0] − Im Z[0]
+            xr = s->re[0] - s->im[0];
+            xi = 0.0f;
+        } else {
+            int   c  = M - k;
+            float er = 0.5f * (s->re[k] + s->re[c]);
+            float ei = 0.5f * (s->im[k] - s->im[c]);
+            float orr = 0.5f * (s->re[k] - s->re[c]);
+            float oi = 0.5f * (s->im[k] + s->im[c]);
+            float wr =  s->cos_tw[k];
+            float wi = -s->sin_tw[k];
+            float tr = wr * orr - wi * oi;
+            float ti = wr * oi + wi * orr;
+            xr = er + ti;
+            xi = ei - tr;
+        }
+        float power = xr * xr + xi * xi;
+
+        while (k >= s->edge[band + 1]) {
+            out->band_rms[band] = sqrtf(acc * s->power_scale);
+            acc = 0.0f;
+            band++;
+        }
+        acc += power;
+
+        float mag = approx_sqrt(power);
+        if (s->have_prev && mag > s->mag[k]) flux += mag - s->mag[k];
+        s->mag[k] = mag;
+    }
+    out->band_rms[band] = sqrtf(acc * s->power_scale);
+
+    out->flux    = flux * sqrtf(s->power_scale);
+    s->have_prev = true;
+}
+
+void spectrum_power_ref(const Spectrum *s, const int16_t *pcm, int n, float *power) {
+    if (n > N) n = N;
+    if (n < 0) n = 0;
+
+    double mean = 0.0;
+    for (int i = 0; i < n; i++) mean += pcm[i];
+    mean = n > 0 ? mean / n : 0.0;
+
+    for (int k = 0; k <= M; k++) {
+        double re = 0.0, im = 0.0;
+        for (int i = 0; i < n; i++) {
+            double x = (pcm[i] - mean) * s->window[i];
+            double a = 6.283185307179586 * (double)k * i / N;
+            re += x * cos(a);
+            im -= x * sin(a);
+        }
+        power[k] = (float)(re * re + im * im);
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Windowed real-FFT analyser for one block of mono 16-bit PCM.
+ *
+ * Each block is mean-removed, Hann-windowed and transformed with a
+ * SPECTRUM_N-point real FFT (a SPECTRUM_N/2-point complex radix-4 FFT plus
+ * a split pass; see spectrum.cpp).  The power spectrum is summed into up to
+ * SPECTRUM_MAX_BANDS log-spaced bands, and the half-wave-rectified change
+ * in magnitude since the previous block gives the spectral flux.
+ *
+ * Band and flux values are in the same units as the time-domain RMS (PCM
+ * counts), so one noise floor works for all of them: a full-scale sine at
+ * the centre of a band reads the same RMS as its samples.
+ *
+ * The working arrays are split real/imaginary (structure of arrays) so the
+ * butterfly loops are plain strided float streams.  spectrum_power_ref() is
+ * the naive DFT the FFT is checked against.  Pure C — no Arduino or
+ * FreeRTOS dependencies; all state lives in the struct (about 9 KB), there
+ * is no allocation.
+ */
+
+#define SPECTRUM_N          512            // samples per block (power of two)
+#define SPECTRUM_BINS       (SPECTRUM_N / 2)
+#define SPECTRUM_MAX_BANDS  16
+#define SPECTRUM_TWIDDLES   (3 * SPECTRUM_N / 4)  // radix-4 passes reach W^3j
+
+typedef struct {
+    float rms;                            // time-domain RMS of the block
+    float peak;                           // largest |sample − mean|
+    float band_rms[SPECTRUM_MAX_BANDS];   // RMS of the signal inside each band
+    float flux;                           // spectral flux, 0 on the first block
+} SpectrumFrame;
+
+typedef struct {
+    int      n_bands;
+    uint16_t edge[SPECTRUM_MAX_BANDS + 1];  // band b covers bins [edge[b], edge[b+1])
+    float    power_scale;                   // bin power → mean square
+
+    float    window[SPECTRUM_N];            // Hann
+    float    cos_tw[SPECTRUM_TWIDDLES];     // e^(-2πik/N) for k < 3N/4
+    float    sin_tw[SPECTRUM_TWIDDLES];
+    uint16_t bitrev[SPECTRUM_BINS];         // complex FFT input permutation
+
+    float    re[SPECTRUM_BINS];             // complex FFT work buffer
+    float    im[SPECTRUM_BINS];
+    float    mag[SPECTRUM_BINS + 1];        // last block's bin magnitudes
+    bool     have_prev;
+} Spectrum;
+
+/**
+ * Build the tables and place n_bands log-spaced bands between lo_hz and
+ * hi_hz (clamped to 1..SPECTRUM_MAX_BANDS and to the bins that exist at
+ * sample_hz).  Every band gets at least one bin.
+ */
+void spectrum_init(Spectrum *s, int n_bands, float lo_hz, float hi_hz, float sample_hz);
+
+/**
+ * Analyse one block.  n may be short of SPECTRUM_N (the rest is treated as
+ * silence); anything past SPECTRUM_N is ignored.
+ */
+void spectrum_run(Spectrum *s, const int16_t *pcm, int n, SpectrumFrame *out);
+
+/** Reference: windowed power of bins 0..SPECTRUM_BINS by direct DFT. */
+void spectrum_power_ref(const Spectrum *s, const int16_t *pcm, int n, float *power);
@@ -0,0 +1,111 @@
+#include "art_flash.h"
+#include "config.h"
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#define ART_DIR "/art"
+
+// Flash program/erase stalls the cache on both cores, so large files are
+// written a block at a time with a yield in between rather than in one go.
+#define WRITE_CHUNK 4096
+
+// ---------------------------------------------------------------------------
+// ArtStoreFs callbacks
+// ---------------------------------------------------------------------------
+
+static void full_path(const char *name, char *out, size_t out_len) {
+    snprintf(out, out_len, ART_DIR "/%s", name);
+}
+
+static long fs_size(void *ctx, const char *name) {
+    char path[48];
+    full_path(name, path, sizeof(path));
+    if (!LittleFS.exists(path)) return -1;
+    File f = LittleFS.open(path, "r");
+    if (!f) return -1;
+    long n = (long)f.size();
+    f.close();
+    return n;
+}
+
+static bool fs_read(void *ctx, const char *name, void *buf, size_t len) {
+    char path[48];
+    full_path(name, path, sizeof(path));
+    File f = LittleFS.open(path, "r");
+    if (!f) return false;
+    size_t n = f.read((uint8_t *)buf, len);
+    f.close();
+    return n == len;
+}
+
+static bool fs_write(void *ctx, const char *name, const void *buf, size_t len) {
+    char path[48];
+    full_path(name, path, sizeof(path));
+    File f = LittleFS.open(path, "w");
+    if (!f) return false;
+
+    const uint8_t *p = (const uint8_t *)buf;
+    size_t done = 0;
+    while (done < len) {
+        size_t chunk = min((size_t)WRITE_CHUNK, len - done);
+        if (f.write(p + done, chunk) != chunk) break;
+        done += chunk;
+        if (done < len) vTaskDelay(1);
+    }
+    f.close();
+    return done == len;
+}
+
+static bool fs_remove(void *ctx, const char *name) {
+    char path[48];
+    full_path(name, path, sizeof(path));
+    return LittleFS.remove(path);
+}
+
+static bool fs_rename(void *ctx, const char *from, const char *to) {
+    char a[48], b[48];
+    full_path(from, a, sizeof(a));
+    full_path(to,   b, sizeof(b));
+    return LittleFS.rename(a, b);
+}
+
+static void fs_list(void *ctx, void (*cb)(void *arg, const char *name), void *arg) {
+    File dir = LittleFS.open(ART_DIR);
+    if (!dir || !dir.isDirectory()) return;
+
+    // Collect first: the callback may delete entries.
+    char names[ART_STORE_MAX_ENTRIES + 8][24];
+    int  n = 0;
+    for (File f = dir.openNextFile(); f && n < (int)(sizeof(names) / sizeof(names[0]));
+         f = dir.openNextFile()) {
+        strncpy(names[n], f.name(), sizeof(names[n]) - 1);
+        names[n][sizeof(names[n]) - 1] = '\0';
+        n++;
+    }
+    dir.close();
+    for (int i = 0; i < n; i++) cb(arg, names[i]);
+}
+
+static const ArtStoreFs s_fs = {
+    nullptr, fs_size, fs_read, fs_write, fs_remove, fs_rename, fs_list,
+};
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+const ArtStoreFs *art_flash_fs() {
+    if (!LittleFS.begin(true)) {   // format on first boot
+        DEBUG_PRINTLN("[ArtFlash] LittleFS mount failed");
+        return nullptr;
+    }
+    if (!LittleFS.exists(ART_DIR) && !LittleFS.mkdir(ART_DIR)) {
+        DEBUG_PRINTLN("[ArtFlash] Cannot create " ART_DIR);
+        return nullptr;
+    }
+    DEBUG_PRINTF("[ArtFlash] LittleFS %u / %u KB used\n",
+                 (unsigned)(LittleFS.usedBytes() / 1024),
+                 (unsigned)(LittleFS.totalBytes() / 1024));
+    return &s_fs;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "../state/art_store.h"
+
+// Mount LittleFS on the "spiffs" data partition (formatting it on first use)
+// and return an ArtStoreFs rooted at /art, or nullptr if the mount failed.
+// Call once from setup(); the returned object lives for the whole program.
+const ArtStoreFs *art_flash_fs();
@@ -1,17 +1,27 @@
 #include "mic_pdm.h"
+#include "config.h"
+#include "../audio/beat_tracker.h"
 #include "driver/i2s_pdm.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <Arduino.h>
 #include <math.h>
-
-volatile uint8_t g_mic_level  = 0;
-volatile uint8_t g_band_bass  = 0;
-volatile uint8_t g_band_mid   = 0;
-volatile uint8_t g_band_hmid  = 0;
-volatile uint8_t g_band_high  = 0;
+#include <string.h>
 
 static i2s_chan_handle_t s_rx_chan = NULL;
 
+// Latest analysis, published whole through a sequence lock (audio/mic_snapshot).
+// Written by the mic task only; readers on either core never block it.
+static MicSlot s_slot;
+
+static Spectrum    s_spectrum;   // ~9 KB of tables and work buffers, mic task only
+static BeatTracker s_beat;       // ~1.5 KB, mic task only
+
+bool mic_pdm_snapshot(MicSnapshot *out) {
+    return mic_slot_read(&s_slot, out);
+}
+
 // ---------------------------------------------------------------------------
 // Log-scale helper: rms → 0–255 with a given noise floor.
 // ---------------------------------------------------------------------------
@@ -24,9 +34,8 @@ static uint8_t log_level(float rms, float floor_val) {
 }
 
 // Asymmetric smoothing: fast attack (α=0.75), slow decay (α=0.25).
-static void smooth(volatile uint8_t &out, uint8_t nw) {
-    uint8_t prev = out;
-    out = (nw >= prev)
+static uint8_t smooth(uint8_t prev, uint8_t nw) {
+    return (nw >= prev)
         ? (uint8_t)((nw * 3 + prev + 1) / 4)
         : (uint8_t)((nw + prev * 3 + 1) / 4);
 }
@@ -35,20 +44,24 @@ static void smooth(volatile uint8_t &out, uint8_t nw) {
 // Mic sampling task — Core 0, ~30 Hz (512 samples / 16 kHz = 32 ms/block)
 //
 // Per block:
-//  1. DC blocking IIR removes the constant offset (hardware hp_en is a no-op
-//     on ESP32-S3 — SOC_I2S_SUPPORTS_PDM_RX_HP_FILTER is not defined).
-//  2. Three cascaded 1-pole IIR LPFs split the AC signal into four bands:
-//       bass  (<250 Hz)  mid  (250–1kHz)  hmid (1–4kHz)  high (>4kHz)
-//  3. RMS of each band is log-scaled and smoothed into the five globals.
+//  1. audio/spectrum removes the block mean (hardware hp_en is a no-op on
+//     ESP32-S3 — SOC_I2S_SUPPORTS_PDM_RX_HP_FILTER is not defined), applies
+//     a Hann window and takes a 512-point real FFT.
+//  2. Bin power is summed into MIC_BANDS log-spaced bands between
+//     MIC_BAND_LO_HZ and MIC_BAND_HI_HZ; spectral flux comes from the same
+//     spectrum and drives audio/beat_tracker (onsets, tempo, beats).
+//  3. RMS and band levels are log-scaled, smoothed and published as one
+//     MicSnapshot, numbered and stamped with the time the block arrived.
+// The analysis time per block is logged every LOOP_STATS_INTERVAL_MS.
 // ---------------------------------------------------------------------------
 static void mic_task(void *) {
-    static int16_t buf[512];
+    static int16_t buf[SPECTRUM_N];
+    MicSnapshot snap = {};
+    snap.version = MIC_SNAPSHOT_VERSION;
+    snap.n_bands = (uint8_t)s_spectrum.n_bands;
 
-    // IIR filter states (persist across blocks)
-    static float dc      = 0.0f;   // DC blocker mean tracker
-    static float lp_bass = 0.0f;   // 1-pole LPF cutoff ~250 Hz  (α=0.906)
-    static float lp_mid  = 0.0f;   // 1-pole LPF cutoff ~1 kHz   (α=0.672)
-    static float lp_hi   = 0.0f;   // 1-pole LPF cutoff ~4 kHz   (α=0.208)
+    int64_t  stats_start = esp_timer_get_time();
+    uint32_t worst_us = 0, total_us = 0, blocks = 0;
 
     for (;;) {
         size_t bytes_read = 0;
@@ -61,37 +74,38 @@ static void mic_task(void *) {
 
         int n = (int)(bytes_read / sizeof(int16_t));
 
-        float sq_total = 0, sq_bass = 0, sq_mid = 0, sq_hmid = 0, sq_high = 0;
-        for (int i = 0; i < n; i++) {
-            // DC block: slow IIR tracks mean, subtract to get AC signal
-            dc = dc * 0.995f + buf[i] * 0.005f;
-            float ac = buf[i] - dc;
-
-            // Cascaded IIR LPFs — coefficients for 16 kHz sample rate:
-            //   α = exp(-2π·fc/fs):  250Hz→0.906  1kHz→0.672  4kHz→0.208
-            lp_bass = lp_bass * 0.906f + ac * 0.094f;
-            lp_mid  = lp_mid  * 0.672f + ac * 0.328f;
-            lp_hi   = lp_hi   * 0.208f + ac * 0.792f;
-
-            // Bandpass signals via difference of LPF outputs
-            float b_bass = lp_bass;
-            float b_mid  = lp_mid  - lp_bass;
-            float b_hmid = lp_hi   - lp_mid;
-            float b_high = ac      - lp_hi;
-
-            sq_total += ac     * ac;
-            sq_bass  += b_bass * b_bass;
-            sq_mid   += b_mid  * b_mid;
-            sq_hmid  += b_hmid * b_hmid;
-            sq_high  += b_high * b_high;
+        int64_t t0 = esp_timer_get_time();
+        SpectrumFrame frame;
+        spectrum_run(&s_spectrum, buf, n, &frame);
+
+        snap.seq++;
+        snap.capture_us = (uint32_t)t0;
+        snap.block_us   = (uint32_t)((int64_t)n * 1000000 / MIC_SAMPLE_RATE);
+        snap.rms        = frame.rms;
+        snap.peak       = frame.peak;
+        snap.flux       = frame.flux;
+        if (beat_update(&s_beat, frame.flux)) snap.beat_us = snap.capture_us;
+        snap.onsets     = s_beat.onsets;
+        snap.beats      = s_beat.beats;
+        snap.bpm        = beat_bpm(&s_beat);
+        snap.level      = smooth(snap.level, log_level(frame.rms, 7.0f));
+        for (int b = 0; b < s_spectrum.n_bands; b++) {
+            snap.bands[b] = smooth(snap.bands[b], log_level(frame.band_rms[b], 5.0f));
+        }
+        mic_slot_publish(&s_slot, &snap);
+
+        int64_t t1 = esp_timer_get_time();
+        uint32_t us = (uint32_t)(t1 - t0);
+        if (us > worst_us) worst_us = us;
+        total_us += us;
+        blocks++;
+        if (t1 - stats_start >= (int64_t)LOOP_STATS_INTERVAL_MS * 1000) {
+            DEBUG_PRINTF("[Mic] analysis worst %u us, avg %u us over %u blocks\n",
+                         (unsigned)worst_us, (unsigned)(total_us / blocks),
+                         (unsigned)blocks);
+            stats_start = t1;
+            worst_us = total_us = blocks = 0;
         }
-
-        float inv_n = 1.0f / n;
-        smooth(g_mic_level, log_level(sqrtf(sq_total * inv_n), 7.0f));
-        smooth(g_band_bass, log_level(sqrtf(sq_bass  * inv_n), 4.0f));
-        smooth(g_band_mid,  log_level(sqrtf(sq_mid   * inv_n), 5.0f));
-        smooth(g_band_hmid, log_level(sqrtf(sq_hmid  * inv_n), 6.0f));
-        smooth(g_band_high, log_level(sqrtf(sq_high  * inv_n), 8.0f));
     }
 }
 
@@ -107,7 +121,7 @@ bool mic_pdm_init(int clk_pin, int data_pin) {
     // on ESP32-S3 (SOC_I2S_SUPPORTS_PDM2PCM=1), so the hardware PDM→PCM filter
     // is active and readBytes() returns standard 16-bit PCM samples.
     i2s_pdm_rx_config_t pdm_cfg = {
-        .clk_cfg  = I2S_PDM_RX_CLK_DEFAULT_CONFIG(16000),
+        .clk_cfg  = I2S_PDM_RX_CLK_DEFAULT_CONFIG(MIC_SAMPLE_RATE),
         .slot_cfg = I2S_PDM_RX_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT,
                                                     I2S_SLOT_MODE_MONO),
     };
@@ -127,6 +141,9 @@ bool mic_pdm_init(int clk_pin, int data_pin) {
         return false;
     }
 
+    spectrum_init(&s_spectrum, MIC_BANDS, MIC_BAND_LO_HZ, MIC_BAND_HI_HZ, MIC_SAMPLE_RATE);
+    beat_init(&s_beat, SPECTRUM_N * 1000.0f / MIC_SAMPLE_RATE);
+
     xTaskCreatePinnedToCore(mic_task, "mic", 3072, NULL, 4, NULL, 0);
     return true;
 }
@@ -8,8 +8,16 @@
  * - Rotary Encoder
  *
  * Architecture:
- * - Core 0: networkTask — polls KEF, sends commands, fetches album art JPEG
- * - Core 1: loop() — runs lv_timer_handler, decodes art, updates screen
+ * - Core 0: controlTask — sends user commands (KEF setData, MQTT); highest priority
+ * - Core 0: stateTask — applies KEF events, falls back to polling KEF when the
+ *           event subscription is down, keeps WiFi + MQTT connected
+ * - Core 0: spotifyTask — Spotify now-playing poll + playback commands (USB)
+ * - Core 0: artTask — streams + decodes album art on cover change (decoded frames
+ *           LRU-cached, JPEGs kept on flash so recent covers show at boot before WiFi)
+ * - Core 0: kefEventTask — long-polls the KEF event queue
+ * - Core 0: waveTask — draws the waveform into the hidden canvas buffer
+ * - Core 1: loop() — runs lv_timer_handler, swaps in decoded art and waveform
+ *           frames, updates screen
  */
 
 #include <Arduino.h>
@@ -18,15 +26,28 @@
 #include <ESPmDNS.h>
 #include <Update.h>
 #include <lvgl.h>
+#include <atomic>
 #include "config.h"
 #include "drivers/display_sh8601.h"
 #include "drivers/touch_cst816.h"
 #include "drivers/encoder.h"
 #include "drivers/drv2605.h"
 #include "drivers/mic_pdm.h"
+#include "drivers/art_flash.h"
 #include "network/kef_api.h"
 #include "network/spotify_api.h"
 #include "network/mqtt_client.h"
+#include "state/command_queue.h"
+#include "state/volume_scheduler.h"
+#include "state/optimistic_state.h"
+#include "state/art_cache.h"
+#include "state/art_store.h"
+#include "state/art_plan.h"
+#include "state/spotify_sync.h"
+#include "state/playback_clock.h"
+#include "state/auto_level.h"
+#include "state/kef_event_link.h"
+#include "ui/art_decode.h"
 #include "ui/main_screen.h"
 #include "ui/light_screen.h"
 
@@ -57,30 +78,32 @@ static SemaphoreHandle_t g_state_mutex = NULL;
 static int  g_volume    = 50;
 static char g_title[128]  = "--";
 static char g_artist[128] = "--";
-static bool g_is_playing  = false;
 static bool g_state_dirty = false;
 
 // ============================================================================
 // Volatile commands — written by Core 1 input callbacks, consumed by Core 0
+//
+// Button taps travel through the command queue (state/command_queue.h).
+// The encoder volume target stays a single latest-wins slot: the knob
+// callbacks run in the esp_timer task, and a second producer would break the
+// queue's single-producer contract.  Both wake controlTask with a task
+// notification instead of waiting for its next tick.
 // ============================================================================
 
 static volatile int      g_volume_target = -1;
 static volatile bool     g_volume_dirty  = false;
-static volatile char     g_track_cmd[12] = "";
 
 // ============================================================================
-// USB source + mute + power state — written by Core 0, read by Core 1
+// USB source + power state — written by Core 0, read by Core 1
+//
+// These hold what the speaker last reported and drive Core 0's routing.  The
+// screen shows mute, play/pause, source and power through the optimistic
+// store instead (state/optimistic_state.h), so a tap shows on the next frame.
 // ============================================================================
 
 static volatile bool g_source_is_usb  = false;
-static volatile bool g_is_muted       = false;
 static volatile bool g_power_on       = true;
 static volatile bool g_spotify_active = false;  // Spotify session detected on USB
-static volatile int  g_progress_pct   = 0;      // Track progress 0-100
-
-// Control panel commands — written by Core 1 (button callbacks via main_screen),
-// consumed by Core 0 networkTask
-static volatile char g_control_cmd[16] = "";
 
 // Haptic event — written by Core 1 encoder callbacks and loop(), serviced in loop()
 static volatile uint8_t g_haptic_event = HAPTIC_NONE;
@@ -96,27 +119,127 @@ static volatile int  g_active_screen           = SCREEN_KEF;
 static volatile int  g_light_brightness_target = -1;  // -1 = none pending
 static volatile int  g_light_colortemp_target  = -1;
 
-// Light button/colorwheel commands — written by Core 1 (loop), consumed by Core 0
-static volatile char g_light_cmd[192] = "";
-
 // ============================================================================
-// Album art pipeline — Core 0 fetches JPEG, Core 1 decodes + blits
+// Album art pipeline — artTask fills the back buffer, Core 1 swaps
+//
+// The workers that learn now-playing data (stateTask, spotifyTask) only
+// publish the cover URL into g_art_url; artTask downloads it, so a slow CDN
+// never holds up a state update or a command.
+//
+// The canvas has two PSRAM buffers (main_screen_art_back()).  artTask
+// produces every frame in the back one — decoding the HTTP body as it
+// arrives, decoding a JPEG from flash, or copying a cached frame — and
+// Core 1 only exchanges the buffer pointers, so lv_timer_handler is never
+// held up by a decode or a 253 KB copy and never renders a half-written
+// frame.
 //
 // Protocol (lock-free single-producer / single-consumer):
-//   Core 0: only touches g_art_jpeg_buf when it is nullptr (i.e. Core 1 is
-//           done with the previous buffer).  It writes buf + size, then sets
-//           g_art_dirty.
-//   Core 1: when g_art_dirty, snapshots the pointer, clears g_art_jpeg_buf to
-//           nullptr (giving Core 0 permission to queue next art), decodes,
-//           then frees the buffer.
+//   artTask: only writes the back buffer or posts while g_art_dirty is
+//           clear (i.e. Core 1 has swapped the previous frame in).  It
+//           writes g_art_key, then sets g_art_dirty with a release store.
+//   Core 1: when g_art_dirty (acquire), swaps the back buffer onto the
+//           canvas (or hides it for key 0) — cross-fading over a few
+//           loop() passes if a cover was already showing — then clears
+//           g_art_dirty with a release store.
+// artTask loads g_art_dirty with acquire before touching the back buffer.
+// The release/acquire pairs order the PSRAM pixel writes and g_art_key
+// before Core 1 reads them, and Core 1's pointer exchange before artTask's
+// next main_screen_art_back(); volatile alone would order neither.
+//
+// Decoded frames are kept in s_art_cache (PSRAM LRU).  artTask owns it
+// once the tasks start: on a cover change it probes the cache first and on
+// a hit copies the frame into the back buffer — no fetch, no decode — and
+// it inserts every frame it decodes.
+//
+// Fetched JPEGs are also written to s_art_store (LittleFS, artTask owns it
+// once tasks start).  After a RAM miss artTask reads the JPEG from flash
+// instead of the network, and setup() shows the most recent stored cover
+// before WiFi is up.  The store keeps JPEGs rather than decoded frames: a
+// third of the flash writes (each erase stalls both cores' caches) and
+// three times the covers in the same space, for one decode at boot.
+//
+// On USB, spotifyTask also publishes the next queued track's cover into
+// g_art_next_url.  Once the current cover is on screen and Core 1 is idle,
+// artTask decodes the next one into the back buffer and only caches it, so
+// "next" or a track rollover is a RAM hit.  A prefetch gives way to user
+// commands: it is not started while one is queued and its download is
+// abandoned when one arrives.
+// ============================================================================
+
+static uint64_t          g_art_key   = 0;         // art_cache_key() of the cover, 0 = none
+static std::atomic<bool> g_art_dirty{false};     // Core 0 → Core 1 signal; publishes g_art_key
+
+static ArtCache          s_art_cache;
+
+static void *art_cache_alloc(size_t size) {
+    return heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+}
+
+static ArtStore          s_art_store;
+static bool              s_art_store_ok  = false;    // LittleFS mounted
+static ArtPlan           s_art_plan;                 // 640 vs 300 px variant, artTask owns it
+
+static SemaphoreHandle_t g_art_url_mutex = NULL;
+static char              g_art_url[256]  = "";       // latest cover URL, "" = none
+static char              g_art_next_url[256] = "";   // next queued track's cover, "" = none
+static volatile bool     g_art_fetching  = false;    // artTask download in flight
+
+// ============================================================================
+// KEF event queue — kefEventTask long-polls, stateTask applies
+//
+// kefEventTask merges each batch into g_kef_events under g_kef_events_mutex
+// and notifies stateTask, which takes the merged batch so it stays the only
+// writer of the KEF-derived shared state.  While g_kef_events_live is true
+// stateTask skips its KEF polls; when the subscription drops it falls back
+// to polling every KEF_STATE_POLL_INTERVAL.  kefEventTask sets the flag
+// from state/kef_event_link after each call; stateTask also clears it when
+// WiFi drops.
+// ============================================================================
+
+static SemaphoreHandle_t g_kef_events_mutex = NULL;
+static KefState          g_kef_events       = {};
+static volatile bool     g_kef_events_live  = false;
+
+// Set by controlTask after a power / source command: stateTask re-polls at
+// once so the optimistic value is confirmed (or rolled back) quickly.
+static volatile bool     g_kef_repoll       = false;
+
+// ============================================================================
+// Spotify playback commands — controlTask routes, spotifyTask sends
+//
+// Spotify is HTTPS (TLS handshake + a CDN round trip), so controlTask only
+// queues the command and moves on to the next KEF send.
+// ============================================================================
+
+typedef enum : uint8_t {
+    SP_OP_PLAY_PAUSE,
+    SP_OP_NEXT,
+    SP_OP_PREVIOUS,
+} SpotifyOp;
+
+static QueueHandle_t g_spotify_ops = NULL;
+
+// ============================================================================
+// Playback clock — track position for the progress bar
+//
+// stateTask (KEF sources) and spotifyTask (USB) feed it; loop() reads the
+// position every frame, so the bar moves smoothly between polls.  Every
+// access is a few integer operations inside s_play_clock_mux.
+// s_play_clock_usb records that Spotify drove it last, so the KEF estimate
+// restarts when the source switches back.
 // ============================================================================
 
-static volatile uint8_t *g_art_jpeg_buf  = nullptr;  // PSRAM, owned by pipeline
-static volatile size_t   g_art_jpeg_size = 0;
-static volatile bool     g_art_dirty     = false;    // Core 0 → Core 1 signal
+static PlaybackClock s_play_clock;
+static bool          s_play_clock_usb = false;
+static portMUX_TYPE  s_play_clock_mux = portMUX_INITIALIZER_UNLOCKED;
 
 // Task handles
-static TaskHandle_t networkTaskHandle = NULL;
+static TaskHandle_t controlTaskHandle  = NULL;
+static TaskHandle_t stateTaskHandle    = NULL;
+static TaskHandle_t spotifyTaskHandle  = NULL;
+static TaskHandle_t artTaskHandle      = NULL;
+static TaskHandle_t kefEventTaskHandle = NULL;
+static TaskHandle_t waveTaskHandle     = NULL;
 
 // ============================================================================
 // Forward declarations
@@ -133,6 +256,7 @@ void initMic();
 void initWiFi();
 void initOTA();
 void initLVGL();
+void initArtStore();
 void createTasks();
 
 bool lvgl_flush_ready_callback(esp_lcd_panel_io_handle_t panel_io,
@@ -143,7 +267,12 @@ void lvgl_display_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *
 void lvgl_touch_read(lv_indev_drv_t *indev_driver, lv_indev_data_t *data);
 void lvgl_encoder_read(lv_indev_drv_t *indev_driver, lv_indev_data_t *data);
 
-void networkTask(void *pvParameters);
+void controlTask(void *pvParameters);
+void stateTask(void *pvParameters);
+void spotifyTask(void *pvParameters);
+void artTask(void *pvParameters);
+void kefEventTask(void *pvParameters);
+void waveTask(void *pvParameters);
 
 // ============================================================================
 // setup()
@@ -168,7 +297,14 @@ void setup() {
     }
     DEBUG_PRINTLN();
 
-    g_state_mutex = xSemaphoreCreateMutex();
+    g_state_mutex      = xSemaphoreCreateMutex();
+    g_kef_events_mutex = xSemaphoreCreateMutex();
+    art_cache_init(&s_art_cache, ART_CACHE_BUDGET, art_cache_alloc, free);
+    art_plan_init(&s_art_plan, ART_SMALL_MAX_COST_PCT);
+    g_art_url_mutex    = xSemaphoreCreateMutex();
+    g_spotify_ops      = xQueueCreate(8, sizeof(uint8_t));
+    opt_reset();
+    pb_clock_init(&s_play_clock);
 
     DEBUG_PRINTLN("[INIT] Initializing display...");
     initDisplay();
@@ -197,6 +333,10 @@ void setup() {
     DEBUG_PRINTF("[INIT] Free PSRAM: %d bytes\n", ESP.getFreePsram());
     DEBUG_PRINTLN("[INIT] LVGL initialized");
 
+    DEBUG_PRINTLN("[INIT] Loading stored album art...");
+    initArtStore();
+    DEBUG_PRINTLN("[INIT] Album art store initialized");
+
     DEBUG_PRINTLN("[INIT] Connecting to WiFi...");
     initWiFi();
     DEBUG_PRINTLN("[INIT] WiFi initialized");
@@ -220,35 +360,157 @@ void setup() {
 
 static WebServer s_ota_server(80);
 
+// Wake controlTask so it handles new input now rather than on its next tick.
+static void wake_control_task() {
+    if (controlTaskHandle) xTaskNotifyGive(controlTaskHandle);
+}
+
+// Show a tap's effect on the next frame; Core 0 confirms or rolls it back.
+static void show_intent(CmdType type) {
+    uint32_t now = (uint32_t)millis();
+    switch (type) {
+        case CMD_MUTE:         opt_request(OPT_MUTE, true,  now); break;
+        case CMD_UNMUTE:       opt_request(OPT_MUTE, false, now); break;
+        case CMD_PLAY_PAUSE:   opt_request(OPT_PLAYING, !opt_value(OPT_PLAYING), now); break;
+        case CMD_POWER_TOGGLE: opt_request(OPT_POWER,   !opt_value(OPT_POWER),   now); break;
+        case CMD_SOURCE_WIFI:
+        case CMD_SOURCE_USB:
+            opt_request(OPT_SOURCE_USB, type == CMD_SOURCE_USB, now);
+            break;
+        case CMD_WAKE_WIFI:
+        case CMD_WAKE_USB:
+            opt_request(OPT_POWER, true, now);
+            opt_request(OPT_SOURCE_USB, type == CMD_WAKE_USB, now);
+            break;
+        default:
+            return;
+    }
+    g_state_dirty = true;
+}
+
+static void queue_cmd(CmdType type, const char *payload = nullptr) {
+    if (type == CMD_NONE) return;
+    if (!cmd_queue_push(type, (uint32_t)millis(), payload)) {
+        DEBUG_PRINTF("[CMD] Queue full — dropped %d (%u total)\n",
+                     (int)type, (unsigned)cmd_queue_dropped());
+        return;
+    }
+    show_intent(type);
+    wake_control_task();
+}
+
+// Keep a decoded frame in the RAM cache (setup(), then artTask only).
+static void cache_art(uint64_t key, const uint16_t *frame) {
+    const size_t frame_bytes = ALBUM_ART_SIZE * ALBUM_ART_SIZE * sizeof(uint16_t);
+    if (frame && !art_cache_put(&s_art_cache, key, frame, frame_bytes)) {
+        DEBUG_PRINTLN("[Art] Cache insert failed (PSRAM)");
+    }
+}
+
+// Worst loop() iteration — how long the UI could not respond — plus a coarse
+// histogram, so a change in the tail shows up and not just in the average.
+static void record_loop_time(uint32_t us) {
+    static const uint32_t bucket_ms[] = {1, 2, 5, 10, 20, 50};  // upper bounds
+    constexpr int N_BUCKETS = sizeof(bucket_ms) / sizeof(bucket_ms[0]) + 1;
+
+    static uint32_t window_start = 0;
+    static uint32_t worst_us     = 0;
+    static uint32_t total_us     = 0;
+    static uint32_t iterations   = 0;
+    static uint32_t hist[N_BUCKETS] = {};
+
+    if (us > worst_us) worst_us = us;
+    total_us += us;
+    iterations++;
+
+    int b = 0;
+    while (b < N_BUCKETS - 1 && us >= bucket_ms[b] * 1000) b++;
+    hist[b]++;
+
+    uint32_t now = (uint32_t)millis();
+    if (now - window_start >= LOOP_STATS_INTERVAL_MS) {
+        DEBUG_PRINTF("[Loop] worst %u us, avg %u us over %u iterations\n",
+                     (unsigned)worst_us, (unsigned)(total_us / iterations),
+                     (unsigned)iterations);
+        DEBUG_PRINTF("[Loop] <1ms %u  <2ms %u  <5ms %u  <10ms %u  <20ms %u  <50ms %u  >=50ms %u\n",
+                     (unsigned)hist[0], (unsigned)hist[1], (unsigned)hist[2],
+                     (unsigned)hist[3], (unsigned)hist[4], (unsigned)hist[5],
+                     (unsigned)hist[6]);
+        window_start = now;
+        worst_us     = 0;
+        total_us     = 0;
+        iterations   = 0;
+        memset(hist, 0, sizeof(hist));
+    }
+}
+
+// Mount the flash art store and put the last cover on screen, so the knob
+// shows something familiar while WiFi is still connecting.
+void initArtStore() {
+    const ArtStoreFs *fs = art_flash_fs();
+    if (!fs) return;
+    s_art_store_ok = true;
+
+    if (!art_store_open(&s_art_store, fs, ART_STORE_BUDGET)) {
+        DEBUG_PRINTLN("[Art] Flash index unreadable — starting empty");
+    }
+    DEBUG_PRINTF("[Art] Flash store: %d covers, %u KB\n",
+                 s_art_store.count, (unsigned)(s_art_store.used / 1024));
+
+    uint64_t key  = art_store_latest(&s_art_store);
+    size_t   size = art_store_size(&s_art_store, key);
+    if (key == 0 || size == 0) return;
+
+    uint8_t *jpeg = (uint8_t *)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    if (!jpeg) return;
+    bool ok = art_store_load(&s_art_store, key, jpeg, size) &&
+              main_screen_update_art(jpeg, size);
+    free(jpeg);
+    if (!ok) return;
+
+    cache_art(key, main_screen_art_frame());
+    lv_timer_handler();   // draw it now; initWiFi() blocks for a while
+}
+
 void loop() {
+    uint32_t loop_start_us = (uint32_t)micros();
+
     s_ota_server.handleClient();
     lv_timer_handler();
 
-    // --- Album art decode (Core 1 only — LVGL canvas write) ---
-    if (g_art_dirty) {
-        g_art_dirty = false;
-        uint8_t *jpeg = (uint8_t *)g_art_jpeg_buf;
-        size_t   size = g_art_jpeg_size;
-        g_art_jpeg_buf = nullptr;   // release pipeline slot for Core 0
-
-        main_screen_update_art(jpeg, size);
-        free(jpeg);
+    // --- Album art (Core 1 only — LVGL canvas): swap, fading if art is up ---
+    {
+        static bool swapping = false;
+        if (!swapping && g_art_dirty.load(std::memory_order_acquire)) {
+            if (g_art_key != 0) {
+                main_screen_swap_art();
+            } else {
+                main_screen_update_art(nullptr, 0);
+            }
+            swapping = true;
+        }
+        bool fading = main_screen_art_tick(ART_FADE_BUDGET_US);
+        if (swapping && !fading) {
+            swapping = false;
+            // Release the back buffer (and the exchanged pointers) to artTask
+            g_art_dirty.store(false, std::memory_order_release);
+        }
     }
 
-    // --- Forward control panel button commands to network task ---
+    // --- Forward control panel button commands to controlTask ---
     {
         const char *ctrl = main_screen_take_control_cmd();
         if (ctrl && ctrl[0] != '\0') {
-            strncpy((char *)g_control_cmd, ctrl, sizeof(g_control_cmd) - 1);
+            queue_cmd(cmd_from_string(ctrl));
             g_haptic_event = HAPTIC_STRONG;  // power / source switch
         }
     }
 
-    // --- Forward bottom playback button commands to network task ---
+    // --- Forward bottom playback button commands to controlTask ---
     {
         const char *track = main_screen_take_track_cmd();
         if (track && track[0] != '\0') {
-            strncpy((char *)g_track_cmd, track, sizeof(g_track_cmd) - 1);
+            queue_cmd(cmd_from_string(track));
             if (strcmp(track, "pause") == 0) {
                 g_haptic_event = HAPTIC_STRONG;  // play/pause — distinct feel
             } else {
@@ -257,14 +519,26 @@ void loop() {
         }
     }
 
-    // --- Forward light screen button/colorwheel commands to networkTask ---
+    // --- Forward light screen button/colorwheel commands to controlTask ---
     {
         const char *lcmd = light_screen_take_cmd();
         if (lcmd && lcmd[0] != '\0') {
-            strncpy((char *)g_light_cmd, lcmd, sizeof(g_light_cmd) - 1);
             // Power toggle gets a strong pulse; colour/mode cmds get medium
-            g_haptic_event = (strstr(lcmd, "TOGGLE") != nullptr)
-                             ? HAPTIC_STRONG : HAPTIC_MEDIUM;
+            bool toggle = (strstr(lcmd, "TOGGLE") != nullptr);
+            queue_cmd(toggle ? CMD_LIGHT_TOGGLE : CMD_LIGHT_SET, lcmd);
+            g_haptic_event = toggle ? HAPTIC_STRONG : HAPTIC_MEDIUM;
+        }
+    }
+
+    // --- Optimistic state: expire unconfirmed taps, react to rollbacks ---
+    {
+        static uint32_t seen_rollbacks = 0;
+        if (opt_tick((uint32_t)millis())) g_state_dirty = true;
+        uint32_t rollbacks = opt_rollbacks();
+        if (rollbacks != seen_rollbacks) {
+            seen_rollbacks = rollbacks;
+            g_state_dirty  = true;           // snap the control back...
+            g_haptic_event = HAPTIC_STRONG;  // ...and make it felt
         }
     }
 
@@ -291,6 +565,20 @@ void loop() {
         }
     }
 
+    // --- Beat haptics: a tick per detected music beat (HAPTIC_EFFECT_BEAT) ---
+    // Only on the KEF screen while playing, and never over a user event.
+    if (HAPTIC_EFFECT_BEAT) {
+        static uint32_t last_beats = 0;
+        MicSnapshot mic;
+        if (mic_pdm_snapshot(&mic) && mic.beats != last_beats) {
+            last_beats = mic.beats;
+            if (g_power_on && g_active_screen == SCREEN_KEF && opt_value(OPT_PLAYING) &&
+                g_haptic_event == HAPTIC_NONE) {
+                g_haptic_event = HAPTIC_BEAT;
+            }
+        }
+    }
+
     // --- Service haptic event (Core 1 only — I2C_NUM_0 shared with touch) ---
     if (g_haptic_event != HAPTIC_NONE) {
         uint8_t evt = g_haptic_event;
@@ -299,69 +587,58 @@ void loop() {
         switch (evt) {
             case HAPTIC_STRONG: effect = HAPTIC_EFFECT_STRONG; break;
             case HAPTIC_MEDIUM: effect = HAPTIC_EFFECT_MEDIUM; break;
+            case HAPTIC_BEAT:   effect = HAPTIC_EFFECT_BEAT;   break;
             default:            effect = HAPTIC_EFFECT_CLICK;  break;
         }
-        // Rate-limit encoder clicks to reduce motor current spikes on the shared
-        // supply rail. Button events (STRONG/MEDIUM) always fire immediately.
+        // Rate-limit encoder clicks and beat ticks to reduce motor current spikes
+        // on the shared supply rail. Button events (STRONG/MEDIUM) always fire
+        // immediately.
         static uint32_t last_click_ms = 0;
         uint32_t now_ms = (uint32_t)millis();
-        bool is_click = (evt == HAPTIC_CLICK);
+        bool is_click = (evt == HAPTIC_CLICK || evt == HAPTIC_BEAT);
         if (!is_click || (now_ms - last_click_ms >= HAPTIC_MIN_INTERVAL_MS)) {
             drv2605_play(effect);
             if (is_click) last_click_ms = now_ms;
         }
     }
 
-    // --- Waveform visualiser: push a new bar every MIC_BAR_MS ms ---
-    // Core 1 owns the history ring buffer. g_mic_level is written by the mic
-    // task on Core 0 and read here as a volatile uint8_t (atomic on ESP32).
+    // --- Track progress: read the playback clock every frame ---
     {
-        static uint32_t last_wave_ms      = 0;
-        static uint8_t  wave_hist[MIC_N_BARS] = {};
-        static int      wave_head         = 0;   // index of the oldest sample
-
-        uint32_t now_wave = (uint32_t)millis();
-        if (g_power_on && now_wave - last_wave_ms >= (uint32_t)MIC_BAR_MS) {
-            last_wave_ms = now_wave;
-
-            // Push newest amplitude into the ring buffer.
-            wave_hist[wave_head] = g_mic_level;
-            wave_head = (wave_head + 1) % MIC_N_BARS;
-
-            // Linearise ring buffer: index 0 = oldest, [MIC_N_BARS-1] = newest.
-            uint8_t ordered[MIC_N_BARS];
-            for (int i = 0; i < MIC_N_BARS; i++) {
-                ordered[i] = wave_hist[(wave_head + i) % MIC_N_BARS];
-            }
-            main_screen_update_waveform(ordered, MIC_N_BARS);
-        }
+        taskENTER_CRITICAL(&s_play_clock_mux);
+        int permille = pb_clock_permille(&s_play_clock, (uint32_t)millis());
+        taskEXIT_CRITICAL(&s_play_clock_mux);
+        main_screen_update_progress(permille);
     }
 
+    // --- Waveform visualiser: show the frame waveTask finished, if any ---
+    main_screen_wave_tick();
+
     // --- Text/volume update ---
     if (g_volume_target >= 0) {
-        main_screen_update(g_volume_target, g_title, g_artist, g_is_playing,
-                           g_source_is_usb, g_is_muted, g_spotify_active, g_progress_pct);
+        main_screen_update(g_volume_target, g_title, g_artist, opt_value(OPT_PLAYING),
+                           opt_value(OPT_SOURCE_USB), opt_value(OPT_MUTE),
+                           g_spotify_active);
     } else if (g_state_dirty) {
         g_state_dirty = false;
 
         int  vol;
         char title[128];
         char artist[128];
-        bool playing;
 
         if (xSemaphoreTake(g_state_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
             vol     = g_volume;
-            playing = g_is_playing;
             strncpy(title,  g_title,  sizeof(title));
             strncpy(artist, g_artist, sizeof(artist));
             xSemaphoreGive(g_state_mutex);
 
-            main_screen_update(vol, title, artist, playing,
-                               g_source_is_usb, g_is_muted, g_spotify_active, g_progress_pct);
-            main_screen_update_power_source(g_power_on, g_source_is_usb);
+            bool usb = opt_value(OPT_SOURCE_USB);
+            main_screen_update(vol, title, artist, opt_value(OPT_PLAYING),
+                               usb, opt_value(OPT_MUTE), g_spotify_active);
+            main_screen_update_power_source(opt_value(OPT_POWER), usb);
         }
     }
 
+    record_loop_time((uint32_t)micros() - loop_start_us);
     delay(5);
 }
 
@@ -408,6 +685,7 @@ static void handle_encoder_delta(int delta) {
             if (next > VOLUME_MAX) next = VOLUME_MAX;
             g_volume_target = next;
             g_volume_dirty  = true;
+            wake_control_task();
             DEBUG_PRINTF("[Encoder] Volume target: %d\n", next);
             break;
         }
@@ -418,6 +696,7 @@ static void handle_encoder_delta(int delta) {
             if (nxt < LIGHT_BRIGHTNESS_MIN) nxt = LIGHT_BRIGHTNESS_MIN;
             if (nxt > LIGHT_BRIGHTNESS_MAX) nxt = LIGHT_BRIGHTNESS_MAX;
             g_light_brightness_target = nxt;
+            wake_control_task();
             DEBUG_PRINTF("[Encoder] Brightness target: %d\n", nxt);
             break;
         }
@@ -428,6 +707,7 @@ static void handle_encoder_delta(int delta) {
             if (nxt < LIGHT_COLORTEMP_MIN) nxt = LIGHT_COLORTEMP_MIN;
             if (nxt > LIGHT_COLORTEMP_MAX) nxt = LIGHT_COLORTEMP_MAX;
             g_light_colortemp_target = nxt;
+            wake_control_task();
             DEBUG_PRINTF("[Encoder] ColorTemp target: %d\n", nxt);
             break;
         }
@@ -585,16 +865,74 @@ void initLVGL() {
 }
 
 void createTasks() {
+    // Broker config only — stateTask makes the first connection.
+    mqtt_client_begin(MQTT_BROKER_IP, MQTT_BROKER_PORT);
+
+    xTaskCreatePinnedToCore(
+        controlTask,
+        "Control Task",
+        CONTROL_TASK_STACK_SIZE,
+        NULL,
+        CONTROL_TASK_PRIORITY,
+        &controlTaskHandle,
+        NETWORK_TASK_CORE
+    );
+    DEBUG_PRINTLN("[Tasks] Control task created on Core 0");
+
+    xTaskCreatePinnedToCore(
+        stateTask,
+        "State Task",
+        STATE_TASK_STACK_SIZE,
+        NULL,
+        STATE_TASK_PRIORITY,
+        &stateTaskHandle,
+        NETWORK_TASK_CORE
+    );
+    DEBUG_PRINTLN("[Tasks] State task created on Core 0");
+
+    xTaskCreatePinnedToCore(
+        spotifyTask,
+        "Spotify Task",
+        SPOTIFY_TASK_STACK_SIZE,
+        NULL,
+        SPOTIFY_TASK_PRIORITY,
+        &spotifyTaskHandle,
+        NETWORK_TASK_CORE
+    );
+    DEBUG_PRINTLN("[Tasks] Spotify task created on Core 0");
+
+    xTaskCreatePinnedToCore(
+        artTask,
+        "Art Task",
+        ART_TASK_STACK_SIZE,
+        NULL,
+        ART_TASK_PRIORITY,
+        &artTaskHandle,
+        NETWORK_TASK_CORE
+    );
+    DEBUG_PRINTLN("[Tasks] Art task created on Core 0");
+
+    xTaskCreatePinnedToCore(
+        kefEventTask,
+        "KEF Events",
+        KEF_EVENT_TASK_STACK_SIZE,
+        NULL,
+        STATE_TASK_PRIORITY,
+        &kefEventTaskHandle,
+        NETWORK_TASK_CORE
+    );
+    DEBUG_PRINTLN("[Tasks] KEF event task created on Core 0");
+
     xTaskCreatePinnedToCore(
-        networkTask,
-        "Network Task",
-        NETWORK_TASK_STACK_SIZE,
+        waveTask,
+        "Wave Task",
+        WAVE_TASK_STACK_SIZE,
         NULL,
-        NETWORK_TASK_PRIORITY,
-        &networkTaskHandle,
+        WAVE_TASK_PRIORITY,
+        &waveTaskHandle,
         NETWORK_TASK_CORE
     );
-    DEBUG_PRINTLN("[Tasks] Network task created on Core 0");
+    DEBUG_PRINTLN("[Tasks] Wave task created on Core 0");
 }
 
 // ============================================================================
@@ -732,42 +1070,314 @@ void lvgl_encoder_read(lv_indev_drv_t *indev_driver, lv_indev_data_t *data) {
 }
 
 // ============================================================================
-// Network task (Core 0)
+// KEF event task (Core 0)
 // ============================================================================
 
-void networkTask(void *pvParameters) {
-    DEBUG_PRINTLN("[Network Task] Started on Core 0");
+// Subscribe / long-poll / fall back decisions come from state/kef_event_link;
+// this task only does the HTTP calls and merges event batches.
+void kefEventTask(void *pvParameters) {
+    DEBUG_PRINTLN("[KEF Events] Started on Core 0");
 
-    spotify_init(SPOTIFY_CLIENT_ID, SPOTIFY_CLIENT_SECRET, SPOTIFY_REFRESH_TOKEN);
-    mqtt_client_begin(MQTT_BROKER_IP, MQTT_BROKER_PORT);
+    KefEventLink link;
+    kef_link_init(&link, (uint32_t)millis());
 
-    static uint32_t last_poll_ms   = 0;
-    static bool     sp_is_playing  = false;  // Core 0 local — tracks Spotify play state
-    static bool     vol_known      = false;  // true after first successful kef_get_volume()
+    while (true) {
+        bool wifi_up = (WiFi.status() == WL_CONNECTED);
+        if (!wifi_up) kef_link_on_wifi_down(&link);
 
-    // Client-side position estimation for KEF WiFi source (API has no position field)
-    static uint32_t kef_track_dur_ms    = 0;     // duration from KEF status.duration
-    static uint32_t kef_pos_est_ms      = 0;     // estimated current position
-    static uint32_t kef_pos_ref_esp_ms  = 0;     // millis() at last reference point
-    static bool     kef_pos_was_playing = false; // was playing at last reference point
-    static char     kef_pos_last_url[256] = "";  // track change detection via cover URL
-    static uint32_t volume_sent_ms = 0;
-    static char     last_cover_url[256] = "";  // detects track change for art fetch
+        uint32_t now = (uint32_t)millis();
+        KefLinkAction action = kef_link_next(&link, wifi_up, now);
+        if (action == KEF_LINK_WAIT) {
+            g_kef_events_live = kef_link_live(&link);
+            vTaskDelay(pdMS_TO_TICKS(wifi_up ? kef_link_wait_ms(&link, now) : 1000) + 1);
+            continue;
+        }
+
+        if (action == KEF_LINK_SUBSCRIBE) {
+            // The queue only reports changes — stateTask keeps polling until
+            // the first poll reply confirms the queue is being serviced.
+            kef_link_on_subscribe(&link, kef_event_subscribe(), (uint32_t)millis());
+            continue;
+        }
+
+        KefState ev;
+        bool ok = kef_event_poll(&ev, KEF_POLL_TIMEOUT);
+        kef_link_on_poll(&link, ok, (uint32_t)millis());
+        g_kef_events_live = kef_link_live(&link);
+        if (!ok) {
+            DEBUG_PRINTF("[KEF Events] Subscription lost (#%u) — falling back to polling\n",
+                         (unsigned)link.drops);
+            continue;
+        }
+
+        if (ev.fields &&
+            xSemaphoreTake(g_kef_events_mutex, portMAX_DELAY) == pdTRUE) {
+            KefState &dst = g_kef_events;
+            if (ev.fields & KEF_FIELD_VOLUME) dst.volume   = ev.volume;
+            if (ev.fields & KEF_FIELD_MUTE)   dst.muted    = ev.muted;
+            if (ev.fields & KEF_FIELD_POWER)  dst.power_on = ev.power_on;
+            if (ev.fields & KEF_FIELD_SOURCE) memcpy(dst.source, ev.source, sizeof(dst.source));
+            if (ev.fields & KEF_FIELD_PLAYER) dst.player   = ev.player;
+            dst.fields |= ev.fields;
+            xSemaphoreGive(g_kef_events_mutex);
+            if (stateTaskHandle) xTaskNotifyGive(stateTaskHandle);
+        }
+    }
+}
+
+// ============================================================================
+// Core 0 network workers
+//
+// One task per service, ranked so a user tap never waits behind a slow one:
+//   controlTask  — command queue, volume scheduler, auto-level, KEF setData,
+//                  MQTT lights
+//   stateTask    — KEF events / fallback poll, WiFi + MQTT reconnects
+//   spotifyTask  — Spotify now-playing poll and playback commands (HTTPS)
+//   artTask      — album art download (HTTPS) for the latest cover URL
+// The KEF sockets are split per task (see kef_api.cpp), so a state read in
+// flight never holds up a command on the same socket.
+// ============================================================================
+
+// Volume state shared by controlTask (sends) and stateTask (readbacks).
+// s_vol_sched is only touched inside s_vol_sched_mux; every call is a few
+// integer updates, so a critical section is cheaper than a mutex.
+static volatile bool     s_vol_known      = false;  // true after first volume read from the speaker
+static volatile uint32_t s_volume_sent_ms = 0;
+static VolumeScheduler   s_vol_sched;                // volume send cadence, learned from readbacks
+static portMUX_TYPE      s_vol_sched_mux  = portMUX_INITIALIZER_UNLOCKED;
+
+// stateTask-local: track change detection for the KEF playback clock
+static char     s_kef_pos_last_url[256] = "";  // cover URL of the current KEF track
+static KefPlayerData s_kef_player     = {};    // last KEF player data (poll or event)
+
+// Publish a speaker volume read (poll or event) to the shared state.
+static void apply_kef_volume(int vol, uint32_t now) {
+    taskENTER_CRITICAL(&s_vol_sched_mux);
+    bool external = vol_sched_on_readback(&s_vol_sched, vol, now);
+    taskEXIT_CRITICAL(&s_vol_sched_mux);
+
+    // Skip while settling after a send so stale readbacks don't fight the
+    // encoder — unless the scheduler saw a change made elsewhere, which
+    // replaces our target (controlTask clears g_volume_target once idle).
+    bool volume_settling = (now - s_volume_sent_ms < VOLUME_SETTLE_MS);
+    if (!external && (g_volume_dirty || g_volume_target >= 0 || volume_settling)) return;
+
+    DEBUG_PRINTF("[KEF] Volume: %d\n", vol);
+    if (!s_vol_known) {
+        // First successful read — discard any encoder commands queued
+        // before this point (they used g_volume=50 as a baseline, not
+        // the real KEF volume, so they would set a wrong absolute level).
+        s_vol_known     = true;
+        g_volume_dirty  = false;
+        g_volume_target = -1;
+        DEBUG_PRINTLN("[KEF] Volume baseline established — encoder commands enabled");
+    }
+    if (xSemaphoreTake(g_state_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+        g_volume = vol;
+        xSemaphoreGive(g_state_mutex);
+    }
+}
+
+// Drive the playback clock on the KEF WiFi source.  The API has no position
+// field, so the clock runs from 0 at each track change (or on returning
+// from USB, where Spotify drove it) and stops while paused.
+static void update_kef_position(const char *cover_url, bool playing, uint32_t dur_ms) {
+    uint32_t now_ms = (uint32_t)millis();
+
+    bool track_changed = (strncmp(cover_url, s_kef_pos_last_url,
+                                  sizeof(s_kef_pos_last_url)) != 0);
+    if (track_changed) {
+        strncpy(s_kef_pos_last_url, cover_url, sizeof(s_kef_pos_last_url) - 1);
+    }
+
+    taskENTER_CRITICAL(&s_play_clock_mux);
+    if (track_changed || s_play_clock_usb) {
+        pb_clock_reset(&s_play_clock, 0, dur_ms, playing, now_ms);
+        s_play_clock_usb = false;
+    } else {
+        if (dur_ms > 0) pb_clock_set_duration(&s_play_clock, dur_ms);
+        pb_clock_set_playing(&s_play_clock, playing, now_ms);
+    }
+    taskEXIT_CRITICAL(&s_play_clock_mux);
+}
+
+// Hand the current cover URL to artTask; it fetches only when it changed.
+static void request_art(const char *cover_url) {
+    bool changed = false;
+    if (xSemaphoreTake(g_art_url_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+        changed = (strncmp(cover_url, g_art_url, sizeof(g_art_url)) != 0);
+        if (changed) {
+            strncpy(g_art_url, cover_url, sizeof(g_art_url) - 1);
+            g_art_url[sizeof(g_art_url) - 1] = '\0';
+        }
+        xSemaphoreGive(g_art_url_mutex);
+    }
+    if (changed && artTaskHandle) xTaskNotifyGive(artTaskHandle);
+}
+
+// Hand the next queued track's cover URL to artTask for prefetching.
+static void request_art_prefetch(const char *cover_url) {
+    bool changed = false;
+    if (xSemaphoreTake(g_art_url_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+        changed = (strncmp(cover_url, g_art_next_url, sizeof(g_art_next_url)) != 0);
+        if (changed) {
+            strncpy(g_art_next_url, cover_url, sizeof(g_art_next_url) - 1);
+            g_art_next_url[sizeof(g_art_next_url) - 1] = '\0';
+        }
+        xSemaphoreGive(g_art_url_mutex);
+    }
+    if (changed && artTaskHandle) xTaskNotifyGive(artTaskHandle);
+}
+
+// A user command is queued for controlTask or spotifyTask.
+static bool command_pending() {
+    return cmd_queue_pending() > 0 ||
+           (g_spotify_ops && uxQueueMessagesWaiting(g_spotify_ops) > 0);
+}
+
+// Publish now-playing text to Core 1 and the cover URL to artTask.
+// Called from stateTask (KEF sources) and spotifyTask (USB).
+static void publish_player_state(const char *title, const char *artist,
+                                 bool playing, const char *cover_url) {
+    if (xSemaphoreTake(g_state_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+        strncpy(g_title,  title,  sizeof(g_title) - 1);
+        strncpy(g_artist, artist, sizeof(g_artist) - 1);
+        xSemaphoreGive(g_state_mutex);
+    }
+    opt_confirm(OPT_PLAYING, playing, (uint32_t)millis());
+    request_art(cover_url);
+}
+
+// Apply a KEF state snapshot — a batch of events merged by kefEventTask or a
+// kef_get_state() read while the event queue is down.  Only fields set in
+// st.fields are touched.
+static void apply_kef_state(const KefState &st, uint32_t now) {
+    if (st.fields & KEF_FIELD_POWER) {
+        g_power_on = st.power_on;
+        opt_confirm(OPT_POWER, st.power_on, now);
+    }
+    if (st.fields & KEF_FIELD_SOURCE) {
+        g_source_is_usb = (strcmp(st.source, "usb") == 0);
+        opt_confirm(OPT_SOURCE_USB, g_source_is_usb, now);
+    }
+    if (st.fields & KEF_FIELD_MUTE)   opt_confirm(OPT_MUTE, st.muted, now);
+    if (st.fields & KEF_FIELD_VOLUME) apply_kef_volume(st.volume, now);
+
+    // Player data events keep flowing on USB too; Spotify owns the
+    // now-playing state there, so only publish them on the KEF sources.
+    // Switching back from USB republishes the last KEF track we saw.
+    if (st.fields & KEF_FIELD_PLAYER) s_kef_player = st.player;
+    bool back_to_kef = (st.fields & KEF_FIELD_SOURCE) && !g_source_is_usb;
+    if (((st.fields & KEF_FIELD_PLAYER) || back_to_kef) && !g_source_is_usb) {
+        update_kef_position(s_kef_player.cover_url, s_kef_player.playing,
+                            s_kef_player.duration_ms);
+        publish_player_state(s_kef_player.title, s_kef_player.artist,
+                             s_kef_player.playing, s_kef_player.cover_url);
+    }
+
+    g_state_dirty = true;
+}
+
+// ---- Control task ----
+
+// Tap-to-sent latency (queue push on Core 1 → HTTP reply / MQTT publish /
+// hand-off to spotifyTask), kept separately for passes that started while
+// artTask had a download in flight.  The two rows matching is the evidence
+// that art fetches no longer delay commands.
+typedef struct {
+    uint32_t count;
+    uint32_t total_ms;
+    uint32_t max_ms;
+} LatencyStats;
+
+static LatencyStats s_cmd_latency[2];  // [0] art idle, [1] art downloading
+
+static void record_cmd_latency(uint32_t ms, bool art_busy) {
+    LatencyStats &l = s_cmd_latency[art_busy ? 1 : 0];
+    l.count++;
+    l.total_ms += ms;
+    if (ms > l.max_ms) l.max_ms = ms;
+
+    const LatencyStats &idle = s_cmd_latency[0];
+    const LatencyStats &busy = s_cmd_latency[1];
+    DEBUG_PRINTF("[Latency] Command %u ms%s | art idle: n=%u avg %u max %u"
+                 " | art downloading: n=%u avg %u max %u\n",
+                 (unsigned)ms, art_busy ? " (art downloading)" : "",
+                 (unsigned)idle.count, (unsigned)(idle.count ? idle.total_ms / idle.count : 0),
+                 (unsigned)idle.max_ms,
+                 (unsigned)busy.count, (unsigned)(busy.count ? busy.total_ms / busy.count : 0),
+                 (unsigned)busy.max_ms);
+}
+
+// Queue a playback command for spotifyTask without waiting for it.
+static void send_spotify_op(SpotifyOp op) {
+    uint8_t v = (uint8_t)op;
+    if (xQueueSend(g_spotify_ops, &v, 0) != pdTRUE) {
+        DEBUG_PRINTF("[Spotify] Command queue full — dropped %d\n", (int)op);
+        if (op == SP_OP_PLAY_PAUSE) opt_fail(OPT_PLAYING);
+    }
+}
+
+// Ask stateTask to confirm a power / source change now.
+static void request_kef_repoll() {
+    g_kef_repoll = true;
+    if (stateTaskHandle) xTaskNotifyGive(stateTaskHandle);
+}
+
+// controlTask-local: ambient noise estimate and volume reference
+static AutoLevel s_auto_level;
+
+// Feed the newest mic block to auto-level and queue its nudge, if any.
+// The mic can only measure the room while the speaker is silent, which the
+// optimistic playback / mute state tells us before the speaker does.  The
+// nudge goes through the volume scheduler like a knob turn, and only when
+// no knob turn is in flight.
+static void auto_level_tick(uint32_t now) {
+    static uint32_t last_seq = 0;
+    bool playing = g_power_on && opt_value(OPT_PLAYING) && !opt_value(OPT_MUTE) &&
+                   g_volume > 0;
+
+    MicSnapshot mic;
+    if (mic_pdm_snapshot(&mic) && mic.seq != last_seq) {
+        last_seq = mic.seq;
+        auto_level_on_block(&s_auto_level, mic.rms, !playing, now);
+    }
+
+    if (!s_vol_known || g_volume_dirty || g_volume_target >= 0) return;
+    int vol = auto_level_poll(&s_auto_level, g_volume, playing, now);
+    if (vol < 0) return;
+
+    DEBUG_PRINTF("[AutoLevel] ambient %.1f dB (ref %.1f dB at %d) -> volume %d\n",
+                 s_auto_level.noise_db, s_auto_level.ref_db,
+                 s_auto_level.ref_volume, vol);
+    taskENTER_CRITICAL(&s_vol_sched_mux);
+    vol_sched_set_target(&s_vol_sched, vol);
+    taskEXIT_CRITICAL(&s_vol_sched_mux);
+}
+
+void controlTask(void *pvParameters) {
+    DEBUG_PRINTLN("[Control Task] Started on Core 0");
+
+    vol_sched_init(&s_vol_sched, VOLUME_DEBOUNCE_MS);
+    auto_level_init(&s_auto_level, (uint32_t)millis());
 
     while (true) {
-        // --- WiFi reconnect if needed ---
+        // stateTask reconnects WiFi; input stays queued until it is back.
         if (WiFi.status() != WL_CONNECTED) {
-            DEBUG_PRINTLN("[Network] WiFi disconnected, reconnecting...");
-            WiFi.reconnect();
-            vTaskDelay(pdMS_TO_TICKS(5000));
+            vTaskDelay(pdMS_TO_TICKS(500));
             continue;
         }
 
         uint32_t now = (uint32_t)millis();
 
-        // --- MQTT: maintain connection + process incoming messages ---
+        // --- MQTT: process incoming messages (never blocks on reconnect) ---
         mqtt_client_loop();
 
+        // --- Button commands from Core 1, coalesced per class ---
+        CmdBatch cmds;
+        bool have_cmds = cmd_queue_drain(&cmds);
+        bool art_busy  = g_art_fetching;
+
         // --- Publish brightness (debounced) ---
         if (g_light_brightness_target >= 0) {
             static uint32_t last_bri_ms = 0;
@@ -795,250 +1405,541 @@ void networkTask(void *pvParameters) {
         }
 
         // --- Publish power toggle / colour commands from button/colorwheel ---
-        if (g_light_cmd[0] != '\0') {
-            char cmd[192];
-            strncpy(cmd, (const char *)g_light_cmd, sizeof(cmd) - 1);
-            cmd[sizeof(cmd) - 1] = '\0';
-            g_light_cmd[0] = '\0';
-            mqtt_light_publish(cmd);
-        }
+        if (cmds.light_toggle) mqtt_light_publish("{\"state\":\"TOGGLE\"}");
+        if (cmds.light[0] != '\0') mqtt_light_publish(cmds.light);
+
+        // --- Auto-level: follow the room's ambient noise (opt-in) ---
+        if (AUTO_LEVEL_ENABLED) auto_level_tick(now);
 
         // --- Pending volume command ---
-        // Gate on time-since-last-SEND, not time-since-last-tick. This sends the
-        // current target every 250ms while the encoder is turning (real-time
-        // tracking) and within 250ms of stopping. Avoids the KEF rate-limit
-        // that returns 0 if commands arrive faster than ~250ms apart.
-        if (vol_known && g_volume_dirty && g_volume_target >= 0) {
-            uint32_t since_sent = now - volume_sent_ms;
-            if (since_sent >= (uint32_t)VOLUME_DEBOUNCE_MS) {
-                g_volume_dirty = false;
-                int target = g_volume_target;
-                if (kef_set_volume(target)) {
-                    if (xSemaphoreTake(g_state_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-                        g_volume = target;
-                        xSemaphoreGive(g_state_mutex);
-                    }
-                    volume_sent_ms = (uint32_t)millis();
+        // The KEF ignores volume writes that arrive too close together.  The
+        // scheduler sends the first change after a pause immediately, then
+        // coalesces to the latest target at the spacing it has learned the
+        // speaker accepts (see state/volume_scheduler.h).
+        taskENTER_CRITICAL(&s_vol_sched_mux);
+        if (s_vol_known && g_volume_dirty && g_volume_target >= 0) {
+            g_volume_dirty = false;
+            vol_sched_set_target(&s_vol_sched, g_volume_target);
+        }
+        int send_vol = vol_sched_poll(&s_vol_sched, now);
+        taskEXIT_CRITICAL(&s_vol_sched_mux);
+        if (send_vol >= 0) {
+            bool ok = kef_set_volume(send_vol);
+            uint32_t done_ms = (uint32_t)millis();
+            taskENTER_CRITICAL(&s_vol_sched_mux);
+            vol_sched_on_sent(&s_vol_sched, send_vol, ok, done_ms);
+            VolumeScheduler vs = s_vol_sched;
+            taskEXIT_CRITICAL(&s_vol_sched_mux);
+            if (ok) {
+                if (xSemaphoreTake(g_state_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+                    g_volume = send_vol;
+                    xSemaphoreGive(g_state_mutex);
                 }
-                g_volume_target = -1;
+                s_volume_sent_ms = done_ms;
             }
+            DEBUG_PRINTF("[Vol] gap %u ms (sent %u, confirmed %u, rejected %u, dropped %u, "
+                         "external %u, coalesced %u)\n",
+                         (unsigned)vs.gap_ms, (unsigned)vs.sends, (unsigned)vs.confirmed,
+                         (unsigned)vs.rejected, (unsigned)vs.dropped,
+                         (unsigned)vs.external, (unsigned)vs.coalesced);
+        }
+        taskENTER_CRITICAL(&s_vol_sched_mux);
+        bool vol_idle = (s_vol_sched.pending < 0);
+        taskEXIT_CRITICAL(&s_vol_sched_mux);
+        if (vol_idle && !g_volume_dirty) g_volume_target = -1;
+
+        // --- Pending track / mute commands ---
+        // The screen already shows mute / play-pause / power / source taps
+        // (show_intent on Core 1).  A failed send rolls the control back
+        // here; a success waits for the speaker to report the new value.
+        if (cmds.mute >= 0 && !kef_set_mute(cmds.mute == 1)) {
+            opt_fail(OPT_MUTE);
         }
 
-        // --- Pending track / mute command ---
-        if (g_track_cmd[0] != '\0') {
-            char cmd[12];
-            strncpy(cmd, (const char *)g_track_cmd, sizeof(cmd) - 1);
-            cmd[sizeof(cmd) - 1] = '\0';
-            g_track_cmd[0] = '\0';
-
-            if (strcmp(cmd, "mute") == 0) {
-                if (kef_set_mute(true))  g_is_muted = true;
-            } else if (strcmp(cmd, "unmute") == 0) {
-                if (kef_set_mute(false)) g_is_muted = false;
-            } else if (g_source_is_usb && g_spotify_active) {
-                // Route playback commands to Spotify API on USB source
-                if (strcmp(cmd, "pause") == 0) {
-                    if (sp_is_playing) spotify_pause();
-                    else               spotify_play();
-                } else if (strcmp(cmd, "next") == 0) {
-                    spotify_next();
-                } else if (strcmp(cmd, "previous") == 0) {
-                    spotify_previous();
-                }
+        if (cmds.play_pause || cmds.skip != 0) {
+            // Route playback commands to Spotify API on USB source.  Those go
+            // out on spotifyTask; next/previous taps are counted and only the
+            // net skip is sent.
+            if (g_source_is_usb && g_spotify_active) {
+                if (cmds.play_pause) send_spotify_op(SP_OP_PLAY_PAUSE);
+                for (int n = cmds.skip; n > 0; n--) send_spotify_op(SP_OP_NEXT);
+                for (int n = cmds.skip; n < 0; n++) send_spotify_op(SP_OP_PREVIOUS);
             } else {
-                kef_track_control(cmd);
+                if (cmds.play_pause && !kef_track_control("pause")) opt_fail(OPT_PLAYING);
+                for (int n = cmds.skip; n > 0; n--) kef_track_control("next");
+                for (int n = cmds.skip; n < 0; n++) kef_track_control("previous");
             }
         }
 
         // --- Pending control panel command (power / source) ---
-        if (g_control_cmd[0] != '\0') {
-            char cmd[16];
-            strncpy(cmd, (const char *)g_control_cmd, sizeof(cmd) - 1);
-            cmd[sizeof(cmd) - 1] = '\0';
-            g_control_cmd[0] = '\0';
-
-            if (strcmp(cmd, "power") == 0) {
-                kef_set_power(!g_power_on);
-                last_poll_ms = 0;  // re-poll immediately; screen flips when state confirms
-            } else if (strcmp(cmd, "src_wifi") == 0) {
-                kef_set_source("wifi");
-                last_poll_ms = 0;
-            } else if (strcmp(cmd, "src_usb") == 0) {
-                kef_set_source("usb");
-                last_poll_ms = 0;
-            } else if (strcmp(cmd, "pwr_wifi") == 0 || strcmp(cmd, "pwr_usb") == 0) {
-                bool want_usb = (strcmp(cmd, "pwr_usb") == 0);
-                const char *src = want_usb ? "usb" : "wifi";
-                DEBUG_PRINTF("[CMD] Wake → %s\n", src);
-                bool ok = kef_set_source(src);
-                DEBUG_PRINTF("[Wake] set_source(%s): %s\n", src, ok ? "ok" : "HTTP err");
-                last_poll_ms = 0;  // re-poll immediately; screen flips when state confirms
+        // With the event queue live the speaker pushes the confirmed state;
+        // otherwise stateTask re-polls immediately so the optimistic value is
+        // confirmed (or rolled back) within a second.  A power toggle and a
+        // source/wake tap in the same batch both go out, toggle first.
+        if (cmds.power_toggle) {
+            if (!kef_set_power(opt_value(OPT_POWER))) opt_fail(OPT_POWER);
+            request_kef_repoll();
+        }
+        if (cmds.source == CMD_SOURCE_WIFI || cmds.source == CMD_SOURCE_USB) {
+            if (!kef_set_source(cmds.source == CMD_SOURCE_USB ? "usb" : "wifi"))
+                opt_fail(OPT_SOURCE_USB);
+            request_kef_repoll();
+        } else if (cmds.source == CMD_WAKE_WIFI || cmds.source == CMD_WAKE_USB) {
+            const char *src = (cmds.source == CMD_WAKE_USB) ? "usb" : "wifi";
+            DEBUG_PRINTF("[CMD] Wake → %s\n", src);
+            bool ok = kef_set_source(src);
+            DEBUG_PRINTF("[Wake] set_source(%s): %s\n", src, ok ? "ok" : "HTTP err");
+            if (!ok) {
+                opt_fail(OPT_POWER);
+                opt_fail(OPT_SOURCE_USB);
             }
+            request_kef_repoll();
         }
 
-        // --- Slow state poll: player data + volume every 1s ---
+        if (have_cmds) {
+            record_cmd_latency((uint32_t)millis() - cmds.queued_ms,
+                               art_busy || g_art_fetching);
+        }
+
+        // Sleep until Core 1 queues input, the next volume send is due, or
+        // the 50 ms housekeeping tick — whichever is first.
+        TickType_t wait = pdMS_TO_TICKS(50);
+        taskENTER_CRITICAL(&s_vol_sched_mux);
+        uint32_t vol_wait_ms = vol_sched_wait_ms(&s_vol_sched, (uint32_t)millis());
+        taskEXIT_CRITICAL(&s_vol_sched_mux);
+        if (vol_wait_ms < 50) wait = pdMS_TO_TICKS(vol_wait_ms) + 1;
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+}
+
+// ---- State task ----
+
+void stateTask(void *pvParameters) {
+    DEBUG_PRINTLN("[State Task] Started on Core 0");
+
+    uint32_t last_poll_ms      = 0;
+    int      status_fail_count = 0;
+
+    while (true) {
+        // --- WiFi reconnect if needed (the other workers wait for it) ---
+        if (WiFi.status() != WL_CONNECTED) {
+            DEBUG_PRINTLN("[Network] WiFi disconnected, reconnecting...");
+            // kefEventTask may sit in a long-poll on the dead socket until
+            // its read timeout; poll KEF once WiFi is back rather than wait.
+            g_kef_events_live = false;
+            WiFi.reconnect();
+            vTaskDelay(pdMS_TO_TICKS(5000));
+            continue;
+        }
+
+        // --- MQTT: (re)connect here, off the control path ---
+        mqtt_client_maintain();
+
+        uint32_t now = (uint32_t)millis();
+
+        // --- KEF events pushed by kefEventTask ---
+        if (g_kef_events.fields &&
+            xSemaphoreTake(g_kef_events_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+            KefState ev = g_kef_events;
+            g_kef_events.fields = 0;
+            xSemaphoreGive(g_kef_events_mutex);
+            apply_kef_state(ev, now);
+        }
+
+        if (g_kef_repoll) {
+            g_kef_repoll = false;
+            last_poll_ms = 0;
+        }
+
+        // --- Slow state poll every 1s ---
+        // The KEF endpoints are only polled while the event queue is down —
+        // otherwise they arrive as events.
         if (now - last_poll_ms >= (uint32_t)KEF_STATE_POLL_INTERVAL) {
             last_poll_ms = now;
 
-            char title[128]     = "--";
-            char artist[128]    = "--";
-            char cover_url[256] = "";
-            bool playing        = false;
-
-            // Speaker power state — use speakerStatus endpoint, not player state.
-            // Player "state" field reports "stopped" for both off AND on-but-idle,
+            // While the event queue is down, read the KEF state with one
+            // kef_get_state() call (still one getData round trip per field).
+            // Speaker power uses the speakerStatus endpoint, not player state:
+            // player "state" reports "stopped" for both off AND on-but-idle,
             // so it cannot reliably detect standby.
             // When the speaker enters deep standby its network stack may go down,
             // causing HTTP requests to time out.  After 3 consecutive failures we
             // assume the speaker is off so the standby overlay is shown.
-            {
-                static int status_fail_count = 0;
-                bool speaker_on = true;
-                if (kef_get_speaker_status(&speaker_on)) {
-                    g_power_on = speaker_on;
+            if (!g_kef_events_live) {
+                // Skip volume poll while settling after a send
+                bool volume_settling = (now - s_volume_sent_ms < VOLUME_SETTLE_MS);
+                uint8_t want = KEF_FIELD_POWER | KEF_FIELD_SOURCE | KEF_FIELD_MUTE;
+                if (!g_source_is_usb) want |= KEF_FIELD_PLAYER;
+                if (!g_volume_dirty && g_volume_target < 0 && !volume_settling)
+                    want |= KEF_FIELD_VOLUME;
+
+                KefState st;
+                kef_get_state(&st, want);
+                if (st.fields & KEF_FIELD_POWER) {
                     status_fail_count = 0;
                 } else if (++status_fail_count >= 3) {
                     g_power_on = false;
+                    opt_confirm(OPT_POWER, false, now);
                     DEBUG_PRINTLN("[KEF] speakerStatus API failing — assuming standby");
                 }
+                apply_kef_state(st, now);
+            } else if (!g_source_is_usb) {
+                // Event-driven: no news between events, just keep the
+                // position estimate moving.
+                update_kef_position(s_kef_player.cover_url, s_kef_player.playing,
+                                    s_kef_player.duration_ms);
+                if (s_kef_player.title[0]) {
+                    publish_player_state(s_kef_player.title, s_kef_player.artist,
+                                         s_kef_player.playing, s_kef_player.cover_url);
+                }
             }
 
-            // --- Player data: Spotify on USB, KEF on WiFi ---
-            bool player_data_ok = false;
-            bool is_standby     = false;
-
-            if (g_source_is_usb) {
-                // USB source — poll Spotify for now-playing metadata.
-                // The same shared state and art pipeline are reused as-is.
-                bool sp_playing = false;
-                bool sp_nothing = false;
-                uint32_t sp_progress_ms = 0, sp_duration_ms = 0;
-                if (spotify_get_now_playing(title,     sizeof(title),
-                                            artist,    sizeof(artist),
-                                            cover_url, sizeof(cover_url),
-                                            &sp_playing, &sp_nothing,
-                                            &sp_progress_ms, &sp_duration_ms)) {
-                    playing          = sp_playing;
-                    sp_is_playing    = sp_playing;
-                    player_data_ok   = true;
-                    g_spotify_active = true;
-                    g_progress_pct   = (sp_duration_ms > 0)
-                        ? (int)((uint64_t)sp_progress_ms * 100 / sp_duration_ms) : 0;
-                } else if (sp_nothing) {
-                    // Spotify explicitly says nothing is playing — clear screen
-                    strncpy(title,  "--", sizeof(title));
-                    strncpy(artist, "--", sizeof(artist));
-                    cover_url[0]     = '\0';
-                    playing          = false;
-                    sp_is_playing    = false;
-                    player_data_ok   = true;
-                    g_spotify_active = false;
-                    g_progress_pct   = 0;
-                }
-                // On network error: keep previous state and g_spotify_active as-is.
-            } else {
-                uint32_t kef_pos_ms = 0, kef_dur_ms = 0;
-                player_data_ok = kef_get_player_data(title,     sizeof(title),
-                                                     artist,    sizeof(artist),
-                                                     &playing,
-                                                     &is_standby,
-                                                     cover_url, sizeof(cover_url),
-                                                     &kef_pos_ms, &kef_dur_ms);
-                if (player_data_ok) {
-                    // KEF API has no position field — estimate client-side.
-                    // Advance kef_pos_est_ms by time elapsed since last poll while playing;
-                    // freeze while paused; reset to 0 when the track changes.
-                    uint32_t now_ms = (uint32_t)millis();
-
-                    bool track_changed = (strncmp(cover_url, kef_pos_last_url,
-                                                  sizeof(kef_pos_last_url)) != 0);
-                    if (track_changed) {
-                        strncpy(kef_pos_last_url, cover_url, sizeof(kef_pos_last_url) - 1);
-                        kef_pos_est_ms     = 0;
-                        kef_pos_ref_esp_ms = now_ms;
-                        kef_pos_was_playing = playing;
-                    }
-
-                    if (kef_dur_ms > 0) kef_track_dur_ms = kef_dur_ms;
-
-                    // Add elapsed time only if we were playing since last reference
-                    if (kef_pos_was_playing) {
-                        uint32_t elapsed = now_ms - kef_pos_ref_esp_ms;
-                        kef_pos_est_ms += elapsed;
-                        if (kef_track_dur_ms > 0 && kef_pos_est_ms > kef_track_dur_ms)
-                            kef_pos_est_ms = kef_track_dur_ms;
-                    }
-                    kef_pos_ref_esp_ms  = now_ms;
-                    kef_pos_was_playing = playing;
-
-                    g_progress_pct = (kef_track_dur_ms > 0)
-                        ? (int)((uint64_t)kef_pos_est_ms * 100 / kef_track_dur_ms) : 0;
+            g_state_dirty = true;
+        }
+
+        // Sleep until an event batch or a repoll request arrives, or the next
+        // poll is due.
+        uint32_t since = (uint32_t)millis() - last_poll_ms;
+        uint32_t wait_ms = (since < (uint32_t)KEF_STATE_POLL_INTERVAL)
+                           ? (uint32_t)KEF_STATE_POLL_INTERVAL - since : 0;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait_ms) + 1);
+    }
+}
+
+// ---- Spotify task ----
+
+void spotifyTask(void *pvParameters) {
+    DEBUG_PRINTLN("[Spotify Task] Started on Core 0");
+
+    spotify_init(SPOTIFY_CLIENT_ID, SPOTIFY_CLIENT_SECRET, SPOTIFY_REFRESH_TOKEN);
+
+    bool     was_usb       = false;
+    uint32_t last_queue_ms = 0;
+    char     queue_for[256] = "";    // current cover when the queue was last read
+
+    // Polls only when the scheduler says the answer may have changed; the
+    // playback clock carries the progress bar in between (see
+    // state/spotify_sync.h).
+    SpotifySync sync;
+    sp_sync_init(&sync, (uint32_t)millis());
+
+    while (true) {
+        // Wait for a playback command from controlTask until the next poll;
+        // off USB, just look at the source again every poll interval.
+        uint32_t wait_ms = was_usb ? sp_sync_wait_ms(&sync, (uint32_t)millis())
+                                   : (uint32_t)KEF_STATE_POLL_INTERVAL;
+        uint8_t op;
+        if (xQueueReceive(g_spotify_ops, &op, pdMS_TO_TICKS(wait_ms)) == pdTRUE) {
+            switch (op) {
+                case SP_OP_PLAY_PAUSE: {
+                    // The tap already flipped the optimistic value to the
+                    // wanted state; the last poll may predate a play/pause
+                    // made elsewhere.
+                    bool ok = opt_value(OPT_PLAYING) ? spotify_play() : spotify_pause();
+                    if (!ok) opt_fail(OPT_PLAYING);
+                    break;
                 }
+                case SP_OP_NEXT:     spotify_next();     break;
+                case SP_OP_PREVIOUS: spotify_previous(); break;
             }
+            sp_sync_on_command(&sync, (uint32_t)millis());
+            continue;
+        }
 
-            if (player_data_ok) {
-                if (xSemaphoreTake(g_state_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-                    strncpy(g_title,  title,  sizeof(g_title) - 1);
-                    strncpy(g_artist, artist, sizeof(g_artist) - 1);
-                    g_is_playing = playing;
-                    xSemaphoreGive(g_state_mutex);
-                }
+        // Token upkeep happens here, between requests, so neither a poll
+        // nor a button press waits for the token endpoint.
+        if (WiFi.status() == WL_CONNECTED && uxQueueMessagesWaiting(g_spotify_ops) == 0) {
+            spotify_maintain_token();
+        }
 
-                // --- Album art: fetch JPEG when track changes ---
-                bool url_changed = (strncmp(cover_url, last_cover_url,
-                                            sizeof(last_cover_url)) != 0);
-                if (url_changed && cover_url[0] != '\0' && g_art_jpeg_buf == nullptr) {
-                    DEBUG_PRINTF("[Art] New cover URL: %s\n", cover_url);
-                    size_t   jpeg_size = 0;
-                    uint8_t *jpeg = kef_fetch_jpeg(cover_url, &jpeg_size);
-                    if (jpeg) {
-                        g_art_jpeg_buf  = jpeg;
-                        g_art_jpeg_size = jpeg_size;
-                        g_art_dirty     = true;
-                        strncpy(last_cover_url, cover_url, sizeof(last_cover_url) - 1);
-                        DEBUG_PRINTF("[Art] Queued %u bytes for decode\n",
-                                     (unsigned)jpeg_size);
-                    }
-                } else if (url_changed && cover_url[0] == '\0') {
-                    last_cover_url[0] = '\0';
-                    if (g_art_jpeg_buf == nullptr) {
-                        g_art_jpeg_size = 0;
-                        g_art_dirty     = true;
-                    }
+        // --- USB source: poll Spotify for now-playing metadata ---
+        // The same shared state and art pipeline are reused as-is.
+        if (WiFi.status() != WL_CONNECTED || !g_source_is_usb) {
+            was_usb = false;
+            continue;
+        }
+        uint32_t now = (uint32_t)millis();
+        if (!was_usb) {
+            was_usb = true;
+            sp_sync_on_command(&sync, now);   // just switched to USB: look now
+        }
+
+        if (sp_sync_wait_ms(&sync, now) > 0) continue;
+
+        char title[128]     = "--";
+        char artist[128]    = "--";
+        char cover_url[256] = "";
+        bool sp_playing = false;
+        bool sp_nothing = false;
+        uint32_t sp_progress_ms = 0, sp_duration_ms = 0;
+        if (spotify_get_now_playing(title,     sizeof(title),
+                                    artist,    sizeof(artist),
+                                    cover_url, sizeof(cover_url),
+                                    &sp_playing, &sp_nothing,
+                                    &sp_progress_ms, &sp_duration_ms)) {
+            now = (uint32_t)millis();
+            sp_sync_on_track(&sync, sp_playing, sp_progress_ms, sp_duration_ms, now);
+            g_spotify_active = true;
+            taskENTER_CRITICAL(&s_play_clock_mux);
+            if (s_play_clock_usb) {
+                pb_clock_sync(&s_play_clock, sp_progress_ms, sp_duration_ms, sp_playing, now);
+            } else {
+                pb_clock_reset(&s_play_clock, sp_progress_ms, sp_duration_ms, sp_playing, now);
+                s_play_clock_usb = true;
+            }
+            taskEXIT_CRITICAL(&s_play_clock_mux);
+            publish_player_state(title, artist, sp_playing, cover_url);
+
+            // Read the queue when the track changes (and now and then in
+            // case it was edited) so artTask can decode the next cover early.
+            // Skipped while a command waits: it is a large response.
+            bool track_changed = strcmp(cover_url, queue_for) != 0;
+            if ((track_changed || now - last_queue_ms >= (uint32_t)SPOTIFY_QUEUE_POLL_MS) &&
+                uxQueueMessagesWaiting(g_spotify_ops) == 0) {
+                char next_url[256];
+                if (spotify_get_next_cover(next_url, sizeof(next_url))) {
+                    request_art_prefetch(next_url);
                 }
+                strncpy(queue_for, cover_url, sizeof(queue_for) - 1);
+                last_queue_ms = now;
             }
+        } else if (sp_nothing) {
+            // Spotify explicitly says nothing is playing — clear screen
+            g_spotify_active = false;
+            now = (uint32_t)millis();
+            taskENTER_CRITICAL(&s_play_clock_mux);
+            pb_clock_reset(&s_play_clock, 0, 0, false, now);
+            s_play_clock_usb = true;
+            taskEXIT_CRITICAL(&s_play_clock_mux);
+            publish_player_state("--", "--", false, "");
+            sp_sync_on_nothing(&sync, now);
+        } else {
+            // Network error: keep previous state and g_spotify_active as-is.
+            sp_sync_on_error(&sync, (uint32_t)millis());
+        }
 
-            // --- Source: polled unconditionally ---
-            char source[16] = "";
-            if (kef_get_source(source, sizeof(source))) {
-                g_source_is_usb = (strcmp(source, "usb") == 0);
-            }
+        g_state_dirty = true;
+    }
+}
 
-            // Skip volume poll for 3s after sending
-            bool volume_settling = (now - volume_sent_ms < 3000);
-            if (!g_volume_dirty && g_volume_target < 0 && !volume_settling) {
-                int vol = 0;
-                if (kef_get_volume(&vol)) {
-                    DEBUG_PRINTF("[KEF] Volume: %d\n", vol);
-                    if (!vol_known) {
-                        // First successful read — discard any encoder commands queued
-                        // before this point (they used g_volume=50 as a baseline, not
-                        // the real KEF volume, so they would set a wrong absolute level).
-                        vol_known      = true;
-                        g_volume_dirty = false;
-                        g_volume_target = -1;
-                        DEBUG_PRINTLN("[KEF] Volume baseline established — encoder commands enabled");
-                    }
-                    if (xSemaphoreTake(g_state_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-                        g_volume = vol;
-                        xSemaphoreGive(g_state_mutex);
-                    }
-                }
+// ---- Art task ----
+
+// Feeds the decoder from the HTTP body, keeping a copy of the JPEG for the
+// flash store when one could be allocated.
+typedef struct {
+    KefBodyRead read;
+    void       *body;
+    size_t      length;
+    uint8_t    *copy;          // PSRAM, nullptr = not storing this cover
+    size_t      copied;
+    uint32_t    t0;
+    uint32_t    first_row_ms;  // 0 until the first canvas row landed
+    uint32_t    wait_us;       // time spent waiting on the network
+    volatile int rows;         // back-buffer rows decoded so far
+    bool        prefetch;      // give way to user commands
+    bool        cancelled;     // ...and one did
+} ArtStream;
+
+static size_t art_stream_read(void *ctx, uint8_t *buf, size_t len) {
+    ArtStream *s = (ArtStream *)ctx;
+    if (s->prefetch && command_pending()) {
+        s->cancelled = true;
+        return 0;               // decoder sees end of input and fails
+    }
+    if (!s->first_row_ms && s->rows > 0) {
+        s->first_row_ms = (uint32_t)millis() - s->t0;
+    }
+    uint32_t t = (uint32_t)micros();
+    size_t   n;
+    if (!s->copy) {
+        n = s->read(s->body, buf, len);
+    } else {
+        // Read into the copy first so skipped bytes are kept too.
+        uint8_t *dst = s->copy + s->copied;
+        n = s->read(s->body, dst, len);
+        if (buf) memcpy(buf, dst, n);
+        s->copied += n;
+    }
+    s->wait_us += (uint32_t)micros() - t;
+    return n;
+}
+
+static bool art_stream_sink(KefBodyRead read, void *body, size_t length, void *ctx) {
+    ArtStream *s = (ArtStream *)ctx;
+    s->read   = read;
+    s->body   = body;
+    s->length = length;
+    if (s_art_store_ok) s->copy = (uint8_t *)heap_caps_malloc(length, MALLOC_CAP_SPIRAM);
+
+    if (!art_decode(art_stream_read, s, main_screen_art_back(), &s->rows)) return false;
+
+    // The decoder stops at the last MCU; the store wants the whole file.
+    if (s->copy && s->copied < length) {
+        s->copied += read(body, s->copy + s->copied, length - s->copied);
+    }
+    return true;
+}
+
+static char s_art_shown[256] = "";  // URL of the art last handed to Core 1
+
+// Hand the back buffer to Core 1 (artTask only, with g_art_dirty clear).
+static void post_art(const char *url, uint64_t key) {
+    g_art_key = key;
+    g_art_dirty.store(true, std::memory_order_release);   // after the pixels and key
+    strncpy(s_art_shown, url, sizeof(s_art_shown) - 1);
+}
+
+// Decode the cover into the back buffer — from flash if stored, else from
+// the network — cache the frame and, unless this is a prefetch, post it.
+// Returns false if the frame could not be produced.
+static bool load_art(const char *url, uint64_t key, uint16_t *back, bool prefetch) {
+
+    size_t stored = s_art_store_ok ? art_store_size(&s_art_store, key) : 0;
+    if (stored > 0) {
+        uint8_t *jpeg = (uint8_t *)heap_caps_malloc(stored, MALLOC_CAP_SPIRAM);
+        bool ok = jpeg && art_store_load(&s_art_store, key, jpeg, stored) &&
+                  art_decode_jpeg(jpeg, stored, back, nullptr);
+        free(jpeg);
+        if (ok) {
+            cache_art(key, back);
+            if (!prefetch) post_art(url, key);
+            DEBUG_PRINTF("[Art] %s — %u bytes (%u hits / %u misses)\n",
+                         prefetch ? "Prefetched from flash" : "Flash hit", (unsigned)stored, (unsigned)s_art_store.hits,
+                         (unsigned)s_art_store.misses);
+            return true;
+        }
+    }
+    if (WiFi.status() != WL_CONNECTED) return false;
+    if (prefetch && command_pending()) return false;
+
+    // Spotify covers come in several sizes; let the planner pick.
+    char fetch_url[256];
+    ArtVariant variant = art_plan_choose(&s_art_plan);
+    bool planned = art_plan_variant_url(url, variant, fetch_url, sizeof(fetch_url));
+    if (!planned) {
+        strncpy(fetch_url, url, sizeof(fetch_url));
+        variant = ART_VARIANT_LARGE;
+    }
+
+    DEBUG_PRINTF("[Art] %s cover URL: %s\n", prefetch ? "Prefetching" : "New", fetch_url);
+    ArtStream stream = {};
+    stream.t0       = (uint32_t)millis();
+    stream.prefetch = prefetch;
+    g_art_fetching = true;
+    bool ok = kef_stream_jpeg(fetch_url, art_stream_sink, &stream);
+    g_art_fetching = false;
+    if (ok) {
+        uint32_t total_ms = (uint32_t)millis() - stream.t0;
+        if (planned) art_plan_record(&s_art_plan, variant, total_ms);
+
+        cache_art(key, back);
+        if (!prefetch) post_art(url, key);
+        DEBUG_PRINTF("[Art] %s %u bytes — first row %u ms, complete %u ms, "
+                     "decode %u ms (avg 640 %u / 300 %u ms)\n",
+                     variant == ART_VARIANT_SMALL ? "300px" : "640px",
+                     (unsigned)stream.length, (unsigned)stream.first_row_ms,
+                     (unsigned)total_ms,
+                     (unsigned)(total_ms - min(total_ms, stream.wait_us / 1000)),
+                     (unsigned)s_art_plan.avg_ms[ART_VARIANT_LARGE],
+                     (unsigned)s_art_plan.avg_ms[ART_VARIANT_SMALL]);
+    } else if (stream.cancelled) {
+        DEBUG_PRINTLN("[Art] Prefetch abandoned — command pending");
+    }
+
+    // Written after the cover is on screen: flash erases stall both cores.
+    if (stream.copy) {
+        if (ok && stream.copied == stream.length &&
+            !art_store_save(&s_art_store, key, stream.copy, stream.copied)) {
+            DEBUG_PRINTLN("[Art] Flash store write failed");
+        }
+        free(stream.copy);
+    }
+    return ok;
+}
+
+void artTask(void *pvParameters) {
+    DEBUG_PRINTLN("[Art Task] Started on Core 0");
+
+    static char prefetched[256] = "";  // next-track URL last prefetched (or tried)
+    const size_t frame_bytes = ALBUM_ART_SIZE * ALBUM_ART_SIZE * sizeof(uint16_t);
+    uint32_t last_flush_ms = (uint32_t)millis();
+
+    while (true) {
+        // A new URL wakes the task at once; the timeout retries a fetch that
+        // failed or found Core 1 still showing the previous cover.
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(KEF_STATE_POLL_INTERVAL));
+
+        // Flash hits only touch recency in RAM; write it out now and then.
+        uint32_t now_ms = (uint32_t)millis();
+        if (s_art_store_ok && now_ms - last_flush_ms >= ART_STORE_FLUSH_MS) {
+            art_store_flush(&s_art_store);
+            last_flush_ms = now_ms;
+        }
+
+        char url[256], next[256];
+        if (xSemaphoreTake(g_art_url_mutex, portMAX_DELAY) != pdTRUE) continue;
+        memcpy(url,  g_art_url,      sizeof(url));
+        memcpy(next, g_art_next_url, sizeof(next));
+        xSemaphoreGive(g_art_url_mutex);
+
+        // Core 1 has not swapped the last frame in yet
+        if (g_art_dirty.load(std::memory_order_acquire)) continue;
+
+        if (strcmp(url, s_art_shown) == 0) {
+            // Idle: decode the next track's cover while nobody is waiting.
+            if (!next[0] || strcmp(next, url) == 0 || strcmp(next, prefetched) == 0) continue;
+            if (command_pending()) continue;
+
+            uint64_t key = art_cache_key(next);
+            size_t n = 0;
+            uint16_t *back = main_screen_art_back();
+            if (art_cache_get(&s_art_cache, key, &n) == nullptr && back &&
+                !load_art(next, key, back, true) && command_pending()) {
+                continue;  // abandoned for a command — retry when idle again
             }
+            strncpy(prefetched, next, sizeof(prefetched) - 1);
+            continue;
+        }
 
-            g_state_dirty = true;
+        if (url[0] == '\0') {
+            post_art(url, 0);
+            continue;
+        }
+
+        uint16_t *back = main_screen_art_back();
+        if (!back) continue;
+
+        uint64_t key = art_cache_key(url);
+        if (art_cache_probe(&s_art_cache, key)) {
+            size_t n = 0;
+            const void *frame = art_cache_get(&s_art_cache, key, &n);
+            if (frame && n == frame_bytes) {
+                memcpy(back, frame, frame_bytes);
+                post_art(url, key);
+                DEBUG_PRINTF("[Art] Cache hit — %u hits / %u misses, %d frames, %u KB\n",
+                             (unsigned)s_art_cache.hits, (unsigned)s_art_cache.misses,
+                             art_cache_count(&s_art_cache),
+                             (unsigned)(s_art_cache.used / 1024));
+                continue;
+            }
         }
 
-        vTaskDelay(pdMS_TO_TICKS(50));
+        load_art(url, key, back, false);
+    }
+}
+
+// ============================================================================
+// Wave task (Core 0) — renders the waveform off the LVGL thread
+// ============================================================================
+
+void waveTask(void *pvParameters) {
+    DEBUG_PRINTLN("[Wave Task] Started on Core 0");
+
+    TickType_t last_wake = xTaskGetTickCount();
+    while (true) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(MIC_BAR_MS));
+        // A frame Core 1 has not taken yet is simply skipped; the phases hold
+        // still for one period rather than the UI blocking on the renderer.
+        if (g_power_on) main_screen_render_waveform();
     }
 }
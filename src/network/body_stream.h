@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ctype.h>
+
+/**
+ * HTTP response body as a Stream: stops at Content-Length and undoes chunked
+ * transfer encoding, so deserializeJson() can read it directly.  drain()
+ * consumes whatever the parser left behind so the next request on a
+ * kept-alive socket starts at a response boundary.
+ *
+ * Shared by the persistent connections in kef_api and spotify_api.  The
+ * caller collects the Transfer-Encoding header (HTTPClient::collectHeaders)
+ * to know whether the body is chunked.
+ */
+class BodyStream : public Stream {
+public:
+    BodyStream(Stream &in, int content_length, bool chunked)
+        : in_(in), chunked_(chunked), remaining_(chunked ? 0 : content_length) {
+        setTimeout(0);   // the socket's own timeout applies to every byte read
+    }
+
+    int available() override {
+        if (remaining_ == 0) return 0;
+        int n = in_.available();
+        return (remaining_ > 0 && n > remaining_) ? remaining_ : n;
+    }
+
+    int read() override {
+        if (remaining_ == 0 && !next_chunk()) return -1;
+        int c = next_byte();
+        if (c < 0) {
+            done_ = true;
+            remaining_ = 0;
+        } else if (remaining_ > 0) {
+            remaining_--;
+        }
+        return c;
+    }
+
+    int peek() override {
+        if (remaining_ == 0 && !next_chunk()) return -1;
+        return in_.peek();
+    }
+
+    size_t write(uint8_t) override { return 0; }
+
+    void drain() {
+        // Unknown length without chunking means the server closes the
+        // socket to end the body — nothing to resynchronise.
+        if (remaining_ < 0) return;
+        while (read() >= 0) {}
+    }
+
+private:
+    int next_byte() {
+        uint8_t c;
+        return in_.readBytes(&c, 1) == 1 ? c : -1;
+    }
+
+    // Read the next chunk-size line. Returns false at the end of the body.
+    bool next_chunk() {
+        if (!chunked_ || done_) return false;
+        if (started_) { next_byte(); next_byte(); }   // CRLF after the previous chunk
+        started_ = true;
+
+        int32_t size = 0;
+        bool ext = false;
+        for (;;) {
+            int c = next_byte();
+            if (c < 0) { done_ = true; return false; }
+            if (c == '\n') break;
+            if (c == ';') ext = true;
+            if (ext || c == '\r') continue;
+            size = size * 16 + (isdigit(c) ? c - '0' : (tolower(c) - 'a' + 10));
+        }
+        if (size > 0) {
+            remaining_ = size;
+            return true;
+        }
+
+        // Last chunk: skip optional trailers up to the terminating blank line
+        for (int len = 0;;) {
+            int c = next_byte();
+            if (c < 0 || (c == '\n' && len == 0)) break;
+            len = (c == '\n') ? 0 : (c == '\r' ? len : len + 1);
+        }
+        done_ = true;
+        return false;
+    }
+
+    Stream &in_;
+    bool    chunked_;
+    bool    started_   = false;
+    bool    done_      = false;
+    int32_t remaining_;   // bytes left in the body or current chunk; -1 = until close
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ArduinoJson.h>
+
+/**
+ * ArduinoJson allocator that hands out memory from a fixed N-byte arena.
+ *
+ * Blocks are carved off the top of the arena.  deserializeJson() clears the
+ * document first, which frees every block, so the arena rewinds to empty
+ * for each reply and steady-state parsing makes no heap allocation.  The
+ * newest block can also be freed or resized in place (ArduinoJson grows and
+ * shrinks its last pool and string that way).  A request that does not fit
+ * spills to the heap and is counted in spills().
+ *
+ * Used by kef_api, one arena per connection.  Depends on ArduinoJson only —
+ * no Arduino or FreeRTOS — so it builds in the native test env.  Not
+ * thread-safe; each connection's lock covers its arena.
+ */
+template <size_t N>
+class JsonArena : public ArduinoJson::Allocator {
+public:
+    void *allocate(size_t size) override {
+        size_t need = sizeof(Block) + align(size);
+        if (top_ + need > sizeof(buf_)) {
+            spills_++;
+            return malloc(size);
+        }
+        Block *b = (Block *)(buf_ + top_);
+        b->size = align(size);
+        last_   = top_;
+        top_   += need;
+        live_++;
+        return b + 1;
+    }
+
+    void deallocate(void *p) override {
+        if (!owns(p)) { free(p); return; }
+        if (--live_ == 0) {
+            top_ = 0;                              // document cleared — rewind
+        } else if (offset(p) == last_) {
+            top_  = last_;                         // freed the newest block
+            last_ = kNone;
+        }
+    }
+
+    void *reallocate(void *p, size_t new_size) override {
+        if (!owns(p)) {
+            spills_++;
+            return realloc(p, new_size);
+        }
+        Block *b = (Block *)p - 1;
+        if (offset(p) == last_ && last_ + sizeof(Block) + align(new_size) <= sizeof(buf_)) {
+            b->size = align(new_size);              // grow/shrink the newest block in place
+            top_    = last_ + sizeof(Block) + b->size;
+            return p;
+        }
+        if (align(new_size) <= b->size) return p;   // shrink elsewhere: keep the slack
+        void *q = allocate(new_size);
+        if (q) memcpy(q, p, b->size);
+        deallocate(p);
+        return q;
+    }
+
+    /** Heap allocations made because a request did not fit. */
+    uint32_t spills() const { return spills_; }
+
+    /** Arena bytes in use, block headers included. */
+    size_t used() const { return top_; }
+
+private:
+    struct Block { size_t size; };
+    static constexpr size_t kNone = (size_t)-1;
+
+    static size_t align(size_t n) { return (n + sizeof(void *) - 1) & ~(sizeof(void *) - 1); }
+    bool   owns(void *p) const    { return p >= buf_ && p < buf_ + sizeof(buf_); }
+    size_t offset(void *p) const  { return (uint8_t *)((Block *)p - 1) - buf_; }
+
+    alignas(void *) uint8_t buf_[N];
+    size_t top_  = 0;
+    size_t last_ = kNone;   // offset of the newest block, if it is still live
+    size_t live_ = 0;
+    volatile uint32_t spills_ = 0;
+};
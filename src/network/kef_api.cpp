@@ -7,80 +7,175 @@
 #include <NetworkClient.h>
 #include <ArduinoJson.h>
 
+#include "body_stream.h"
+#include "json_arena.h"
+#include "kef_parse.h"
+
 // ---------------------------------------------------------------------------
-// Helpers
+// Response parsing
+//
+// Replies are parsed straight off the socket through an ArduinoJson Filter —
+// no String copy of the body — into a JsonDocument whose allocator hands out
+// memory from a fixed arena owned by the connection (network/json_arena.h),
+// so parsing a steady-state reply makes no heap allocation.  A reply too
+// large for the arena spills to the heap and is counted; see
+// kef_heap_alloc_count().  The request itself still allocates: HTTPClient's
+// begin(url) and header() build Strings on every call.
+// The filters and the turning of documents into KefState live in
+// network/kef_parse.
 // ---------------------------------------------------------------------------
 
-static bool http_get(const char *url, String &response_out) {
-    HTTPClient http;
-    http.setTimeout(HTTP_TIMEOUT);
-    http.begin(url);
+// ---------------------------------------------------------------------------
+// Persistent connections
+//
+// Each KefConn owns one HTTPClient that lives for the whole program, so with
+// reuse enabled the TCP socket to the speaker stays open between requests
+// instead of paying a connect + teardown per call.  Each kind of traffic has
+// its own connection, so a slow state read never queues a user command
+// behind it on the socket:
+//   s_cmd_conn  — setData (volume, mute, track, power/source) from controlTask
+//   s_sync_conn — getData state reads from stateTask
+//   s_evt_conn  — event queue subscribe / long-poll from kefEventTask
+// Every public call holds its connection's lock (ConnLock) across the request
+// and the parse of conn.doc, so a call from an unexpected task waits for the
+// socket rather than corrupting it.
+//
+// The speaker drops idle keep-alive sockets on its own schedule.  HTTPClient
+// only finds out when a write or read on the stale socket fails, so a request
+// that fails with a dead-socket error on a warm connection is retried once on
+// a fresh one.  Read timeouts are not retried — the speaker may have acted on
+// the request (e.g. "next") and a resend would repeat it.
+// ---------------------------------------------------------------------------
 
-    int code = http.GET();
-    if (code != 200) {
-        DEBUG_PRINTF("[KEF] HTTP error %d for %s\n", code, url);
-        http.end();
-        return false;
-    }
+struct KefConn {
+    HTTPClient   http;
+    bool         warm       = false;  // socket has completed a request and is held open
+    bool         headers    = false;  // collectHeaders() done
+    uint32_t     reconnects = 0;      // stale-socket retries, for the debug log
+    JsonArena<KEF_JSON_ARENA_SIZE> arena;
+    JsonDocument doc{&arena};         // last reply, valid until the next request
+    SemaphoreHandle_t lock = xSemaphoreCreateMutex();
+};
+
+static KefConn s_cmd_conn;
+static KefConn s_sync_conn;
+static KefConn s_evt_conn;
+
+// Owns conn for the lifetime of the guard.
+class ConnLock {
+public:
+    explicit ConnLock(KefConn &conn) : conn_(conn) { xSemaphoreTake(conn_.lock, portMAX_DELAY); }
+    ~ConnLock() { xSemaphoreGive(conn_.lock); }
+    ConnLock(const ConnLock &) = delete;
+    ConnLock &operator=(const ConnLock &) = delete;
+private:
+    KefConn &conn_;
+};
+
+// GET (post_body == nullptr) or POST JSON to url on conn's persistent socket.
+// On HTTP 200 the reply is parsed into conn.doc through filter (left null on
+// a parse error), or discarded when filter is nullptr.  Returns the HTTP
+// status, negative HTTPC_ERROR_* when the speaker did not answer.  The caller
+// holds a ConnLock on conn.
+static int http_request(KefConn &conn, const char *url, const char *post_body,
+                        const JsonDocument *filter, uint16_t timeout_ms = HTTP_TIMEOUT) {
+    conn.doc.clear();
+    for (int attempt = 0; attempt < 2; attempt++) {
+        HTTPClient &http = conn.http;
+        if (!conn.headers) {
+            static const char *kKeys[] = { "Transfer-Encoding" };
+            http.collectHeaders(kKeys, 1);
+            conn.headers = true;
+        }
+        http.setReuse(true);
+        http.setTimeout(timeout_ms);
+        if (!http.begin(url)) {
+            DEBUG_PRINTF("[KEF] http.begin failed for %s\n", url);
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+        }
 
-    response_out = http.getString();
-    http.end();
-    return true;
-}
+        int code;
+        if (post_body) {
+            http.addHeader("Content-Type", "application/json");
+            code = http.POST((uint8_t *)post_body, strlen(post_body));
+        } else {
+            code = http.GET();
+        }
 
-// POST JSON body to /api/setData. body must be a complete JSON object string.
-static bool http_post_setdata(const char *json_body, String &response_out) {
-    char url[64];
-    snprintf(url, sizeof(url), "http://" KEF_SPEAKER_IP "/api/setData");
+        bool dead_socket = (code == HTTPC_ERROR_SEND_HEADER_FAILED  ||
+                            code == HTTPC_ERROR_SEND_PAYLOAD_FAILED ||
+                            code == HTTPC_ERROR_NOT_CONNECTED       ||
+                            code == HTTPC_ERROR_CONNECTION_LOST);
+        if (dead_socket && conn.warm && attempt == 0) {
+            // HTTPClient has already closed the dead socket; go again fresh.
+            conn.warm = false;
+            conn.reconnects++;
+            http.end();
+            DEBUG_PRINTF("[KEF] Stale connection (%d), reconnecting (#%u)\n",
+                         code, (unsigned)conn.reconnects);
+            continue;
+        }
 
-    HTTPClient http;
-    http.setTimeout(HTTP_TIMEOUT);
-    http.begin(url);
-    http.addHeader("Content-Type", "application/json");
+        if (code != 200) {
+            DEBUG_PRINTF("[KEF] HTTP error %d for %s\n", code, url);
+            conn.warm = false;
+            http.end();
+            return code;
+        }
 
-    int code = http.POST((uint8_t *)json_body, strlen(json_body));
-    if (code != 200) {
-        DEBUG_PRINTF("[KEF] setData POST error %d\n", code);
-        http.end();
-        return false;
+        bool chunked = http.getSize() < 0 &&
+                       http.header("Transfer-Encoding").equalsIgnoreCase("chunked");
+        BodyStream body(*http.getStreamPtr(), http.getSize(), chunked);
+        if (filter) {
+            DeserializationError err = deserializeJson(conn.doc, body,
+                                                       DeserializationOption::Filter(*filter));
+            if (err) {
+                DEBUG_PRINTF("[KEF] JSON parse error: %s for %s\n", err.c_str(), url);
+                conn.doc.clear();
+            }
+        }
+        body.drain();
+        http.end();            // keeps the socket open for the next request
+        conn.warm = true;
+        return code;
     }
+    return HTTPC_ERROR_CONNECTION_LOST;
+}
 
-    response_out = http.getString();
-    http.end();
-    return true;
+// POST a JSON body to url, discarding the reply. json_body must be a complete
+// JSON document string.
+static bool http_post_json(const char *url, const char *json_body) {
+    ConnLock hold(s_cmd_conn);
+    return http_request(s_cmd_conn, url, json_body, nullptr) == 200;
+}
+
+uint32_t kef_heap_alloc_count() {
+    return s_cmd_conn.arena.spills() + s_sync_conn.arena.spills() + s_evt_conn.arena.spills();
 }
 
 // ---------------------------------------------------------------------------
-// Volume
+// Helpers
 // ---------------------------------------------------------------------------
 
-bool kef_get_volume(int *out_volume) {
-    char url[256];
-    snprintf(url, sizeof(url),
-             "http://" KEF_SPEAKER_IP "/api/getData?path=player%%3Avolume&roles=value");
-
-    String body;
-    if (!http_get(url, body)) return false;
-
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, body);
-    if (err) {
-        DEBUG_PRINTF("[KEF] JSON parse error (volume): %s\n", err.c_str());
-        return false;
-    }
+// POST JSON body to /api/setData. body must be a complete JSON object string.
+static bool http_post_setdata(const char *json_body) {
+    return http_post_json("http://" KEF_SPEAKER_IP "/api/setData", json_body);
+}
 
-    if (!doc.is<JsonArray>() || doc.size() == 0) {
-        DEBUG_PRINTLN("[KEF] Unexpected volume response");
-        return false;
-    }
+// Copy a string into a fixed buffer, always null-terminating.
+static void copy_str(char *dst, size_t dst_len, const char *src) {
+    strncpy(dst, src, dst_len - 1);
+    dst[dst_len - 1] = '\0';
+}
 
-    JsonObject obj = doc[0];
-    if (!obj["i32_"].is<int>()) {
-        DEBUG_PRINTLN("[KEF] Volume key missing");
-        return false;
-    }
+// ---------------------------------------------------------------------------
+// Volume
+// ---------------------------------------------------------------------------
 
-    *out_volume = obj["i32_"].as<int>();
+bool kef_get_volume(int *out_volume) {
+    KefState st;
+    if (!kef_get_state(&st, KEF_FIELD_VOLUME)) return false;
+    *out_volume = st.volume;
     return true;
 }
 
@@ -93,9 +188,10 @@ bool kef_set_volume(int volume) {
              "{\"path\":\"player:volume\",\"roles\":\"value\","
              "\"value\":{\"type\":\"i32_\",\"i32_\":%d}}", volume);
 
-    String body;
-    bool ok = http_post_setdata(json, body);
-    if (ok) DEBUG_PRINTF("[KEF] Volume set to %d\n", volume);
+    uint32_t t0 = (uint32_t)millis();
+    bool ok = http_post_setdata(json);
+    if (ok) DEBUG_PRINTF("[KEF] Volume set to %d (%u ms)\n",
+                         volume, (unsigned)((uint32_t)millis() - t0));
     return ok;
 }
 
@@ -110,51 +206,17 @@ bool kef_get_player_data(char *title, size_t title_len,
                          char *cover_url, size_t cover_url_len,
                          uint32_t *out_position_ms,
                          uint32_t *out_duration_ms) {
-    char url[256];
-    snprintf(url, sizeof(url),
-             "http://" KEF_SPEAKER_IP
-             "/api/getData?path=player%%3Aplayer%%2Fdata&roles=value");
-
-    String body;
-    if (!http_get(url, body)) return false;
-
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, body);
-    if (err) {
-        DEBUG_PRINTF("[KEF] JSON parse error (player data): %s\n", err.c_str());
-        return false;
-    }
-
-    if (!doc.is<JsonArray>() || doc.size() == 0) {
-        DEBUG_PRINTLN("[KEF] Unexpected player data response");
-        return false;
-    }
-
-    JsonObject root = doc[0];
-
-    const char *state = root["state"] | "unknown";
-    *out_playing    = (strcmp(state, "playing") == 0);
-    // "stopped" = idle/standby, "standby" = deep standby — both mean off
-    *out_is_standby = (strcmp(state, "playing") != 0 && strcmp(state, "pause") != 0);
-
-    const char *t = root["trackRoles"]["title"] | "--";
-    strncpy(title, t, title_len - 1);
-    title[title_len - 1] = '\0';
-
-    const char *a = root["trackRoles"]["mediaData"]["metaData"]["artist"] | "--";
-    strncpy(artist, a, artist_len - 1);
-    artist[artist_len - 1] = '\0';
-
-    // Album art URL: trackRoles.icon (direct HTTPS CDN URL from Spotify)
-    const char *icon = root["trackRoles"]["icon"] | "";
-    strncpy(cover_url, icon, cover_url_len - 1);
-    cover_url[cover_url_len - 1] = '\0';
-
-    // Duration is at root["status"]["duration"] (ms). Position is not in the API.
+    KefState st;
+    if (!kef_get_state(&st, KEF_FIELD_PLAYER)) return false;
+
+    const KefPlayerData &pd = st.player;
+    *out_playing    = pd.playing;
+    *out_is_standby = pd.is_standby;
+    copy_str(title,     title_len,     pd.title);
+    copy_str(artist,    artist_len,    pd.artist);
+    copy_str(cover_url, cover_url_len, pd.cover_url);
     *out_position_ms = 0;
-    *out_duration_ms = root["status"]["duration"] | 0;
-
-    DEBUG_PRINTF("[KEF] State: %s | Now playing: %s - %s\n", state, title, artist);
+    *out_duration_ms = pd.duration_ms;
     return true;
 }
 
@@ -168,8 +230,7 @@ bool kef_track_control(const char *cmd) {
              "{\"path\":\"player:player/control\",\"roles\":\"activate\","
              "\"value\":{\"control\":\"%s\"}}", cmd);
 
-    String body;
-    bool ok = http_post_setdata(json, body);
+    bool ok = http_post_setdata(json);
     if (ok) DEBUG_PRINTF("[KEF] Track control: %s\n", cmd);
     return ok;
 }
@@ -179,21 +240,9 @@ bool kef_track_control(const char *cmd) {
 // ---------------------------------------------------------------------------
 
 bool kef_get_source(char *source, size_t source_len) {
-    char url[256];
-    snprintf(url, sizeof(url),
-             "http://" KEF_SPEAKER_IP
-             "/api/getData?path=settings%%3A%%2Fkef%%2Fplay%%2FphysicalSource&roles=value");
-
-    String body;
-    if (!http_get(url, body)) return false;
-
-    JsonDocument doc;
-    if (deserializeJson(doc, body) || !doc.is<JsonArray>() || doc.size() == 0)
-        return false;
-
-    const char *src = doc[0]["kefPhysicalSource"] | "";
-    strncpy(source, src, source_len - 1);
-    source[source_len - 1] = '\0';
+    KefState st;
+    if (!kef_get_state(&st, KEF_FIELD_SOURCE)) return false;
+    copy_str(source, source_len, st.source);
     return true;
 }
 
@@ -207,8 +256,7 @@ bool kef_set_mute(bool muted) {
              "{\"path\":\"settings:/mediaPlayer/mute\",\"roles\":\"value\","
              "\"value\":{\"type\":\"bool_\",\"bool_\":%s}}", muted ? "true" : "false");
 
-    String body;
-    bool ok = http_post_setdata(json, body);
+    bool ok = http_post_setdata(json);
     if (ok) DEBUG_PRINTF("[KEF] Mute set to %s\n", muted ? "true" : "false");
     return ok;
 }
@@ -223,12 +271,11 @@ bool kef_get_power(bool *out_is_on) {
              "http://" KEF_SPEAKER_IP
              "/api/getData?path=player%%3Apower&roles=value");
 
-    String body;
-    if (!http_get(url, body)) return false;
+    ConnLock hold(s_sync_conn);
+    if (http_request(s_sync_conn, url, nullptr, &kef_getdata_filter()) != 200) return false;
 
-    JsonDocument doc;
-    if (deserializeJson(doc, body) || !doc.is<JsonArray>() || doc.size() == 0)
-        return false;
+    JsonDocument &doc = s_sync_conn.doc;
+    if (!doc.is<JsonArray>() || doc.size() == 0) return false;
 
     const char *ps = doc[0]["kefPowerState"] | "standby";
     *out_is_on = (strcmp(ps, "on") == 0);
@@ -241,21 +288,9 @@ bool kef_get_speaker_status(bool *out_is_on) {
     // This is the reliable way to detect power state; player "state" field reports
     // "stopped" for both powered-off AND powered-on-but-idle, making it unusable
     // for standby detection.
-    char url[256];
-    snprintf(url, sizeof(url),
-             "http://" KEF_SPEAKER_IP
-             "/api/getData?path=settings%%3A%%2Fkef%%2Fhost%%2FspeakerStatus&roles=value");
-
-    String body;
-    if (!http_get(url, body)) return false;
-
-    JsonDocument doc;
-    if (deserializeJson(doc, body) || !doc.is<JsonArray>() || doc.size() == 0)
-        return false;
-
-    const char *status = doc[0]["kefSpeakerStatus"] | "";
-    *out_is_on = (strcmp(status, "powerOn") == 0);
-    DEBUG_PRINTF("[KEF] Speaker status: %s\n", status);
+    KefState st;
+    if (!kef_get_state(&st, KEF_FIELD_POWER)) return false;
+    *out_is_on = st.power_on;
     return true;
 }
 
@@ -267,11 +302,9 @@ bool kef_set_power(bool on) {
 }
 
 bool kef_power_on() {
-    String body;
     bool ok = http_post_setdata(
         "{\"path\":\"settings:/kef/play/physicalSource\",\"roles\":\"value\","
-        "\"value\":{\"type\":\"kefPhysicalSource\",\"kefPhysicalSource\":\"powerOn\"}}",
-        body);
+        "\"value\":{\"type\":\"kefPhysicalSource\",\"kefPhysicalSource\":\"powerOn\"}}");
     if (ok) DEBUG_PRINTLN("[KEF] Wake (powerOn) sent");
     else    DEBUG_PRINTLN("[KEF] Wake (powerOn) failed");
     return ok;
@@ -287,18 +320,73 @@ bool kef_set_source(const char *source) {
              "{\"path\":\"settings:/kef/play/physicalSource\",\"roles\":\"value\","
              "\"value\":{\"type\":\"kefPhysicalSource\",\"kefPhysicalSource\":\"%s\"}}", source);
 
-    String body;
-    bool ok = http_post_setdata(json, body);
+    bool ok = http_post_setdata(json);
     if (ok) DEBUG_PRINTF("[KEF] Source set to %s\n", source);
     else    DEBUG_PRINTF("[KEF] Source set FAILED for %s\n", source);
     return ok;
 }
 
 // ---------------------------------------------------------------------------
-// JPEG fetch (HTTPS) — allocates into PSRAM, caller must free()
+// Batched state read
+// ---------------------------------------------------------------------------
+
+bool kef_get_state(KefState *out, uint8_t want) {
+    out->fields = 0;
+
+    ConnLock hold(s_sync_conn);
+    JsonDocument &doc = s_sync_conn.doc;
+    for (const auto &p : kKefPaths) {
+        if (!(want & p.field)) continue;
+
+        char url[160];
+        snprintf(url, sizeof(url),
+                 "http://" KEF_SPEAKER_IP "/api/getData?path=%s&roles=value", p.query);
+
+        int code = http_request(s_sync_conn, url, nullptr, &kef_getdata_filter());
+        if (code < 0) break;          // speaker not answering — skip the rest
+        if (code != 200) continue;
+
+        if (!doc.is<JsonArray>() || doc.size() == 0) {
+            DEBUG_PRINTF("[KEF] Unexpected getData reply for %s\n", p.path);
+            continue;
+        }
+        if (kef_parse_value(p.field, doc[0], out)) out->fields |= p.field;
+    }
+    return (out->fields & want) == want;
+}
+
+// ---------------------------------------------------------------------------
+// JPEG fetch (HTTPS) — streamed to the caller's sink, no body buffer
 // ---------------------------------------------------------------------------
 
-uint8_t *kef_fetch_jpeg(const char *url, size_t *out_size) {
+typedef struct {
+    Stream  *stream;
+    size_t   remaining;   // body bytes not yet handed out
+    uint32_t deadline;    // millis() by which the whole body must arrive
+} BodyReader;
+
+static size_t body_read(void *ctx, uint8_t *buf, size_t len) {
+    BodyReader *r = (BodyReader *)ctx;
+    if (len > r->remaining) len = r->remaining;
+
+    uint8_t scratch[64];   // sink for skipped bytes
+    size_t  done = 0;
+    while (done < len && (int32_t)(millis() - r->deadline) < 0) {
+        int avail = r->stream->available();
+        if (avail <= 0) {
+            vTaskDelay(1);   // let the TCP stack fill the socket
+            continue;
+        }
+        size_t want = min((size_t)avail, len - done);
+        uint8_t *dst = buf ? buf + done : scratch;
+        if (!buf && want > sizeof(scratch)) want = sizeof(scratch);
+        done += r->stream->readBytes(dst, want);
+    }
+    r->remaining -= done;
+    return done;
+}
+
+bool kef_stream_jpeg(const char *url, KefBodySink sink, void *ctx) {
     bool is_https = strncmp(url, "https://", 8) == 0;
 
     NetworkClientSecure secure_client;
@@ -313,52 +401,100 @@ uint8_t *kef_fetch_jpeg(const char *url, size_t *out_size) {
 
     if (!begun) {
         DEBUG_PRINTF("[Art] http.begin failed for %s\n", url);
-        return nullptr;
+        return false;
     }
 
     int code = http.GET();
     if (code != 200) {
         DEBUG_PRINTF("[Art] HTTP %d fetching JPEG\n", code);
         http.end();
-        return nullptr;
+        return false;
     }
 
     int content_len = http.getSize();
     if (content_len <= 0 || content_len > (int)ALBUM_ART_MAX_JPEG) {
         DEBUG_PRINTF("[Art] Bad size %d (max %d)\n", content_len, ALBUM_ART_MAX_JPEG);
         http.end();
-        return nullptr;
+        return false;
     }
 
-    uint8_t *buf = (uint8_t *)heap_caps_malloc(content_len, MALLOC_CAP_SPIRAM);
-    if (!buf) {
-        DEBUG_PRINTLN("[Art] PSRAM alloc failed for JPEG");
-        http.end();
-        return nullptr;
+    BodyReader reader = { http.getStreamPtr(), (size_t)content_len,
+                          (uint32_t)millis() + HTTP_TIMEOUT };
+    bool ok = sink(body_read, &reader, (size_t)content_len, ctx);
+
+    http.end();
+
+    if (!ok) {
+        DEBUG_PRINTF("[Art] Stream failed: %u of %d bytes left\n",
+                     (unsigned)reader.remaining, content_len);
+        return false;
     }
+    DEBUG_PRINTF("[Art] Streamed %d bytes JPEG\n", content_len);
+    return true;
+}
 
-    Stream *stream = http.getStreamPtr();
-    int total = 0;
-    uint32_t deadline = millis() + HTTP_TIMEOUT;
-    while (total < content_len && millis() < deadline) {
-        int avail = stream->available();
-        if (avail > 0) {
-            int chunk = stream->readBytes(buf + total, min(avail, content_len - total));
-            total += chunk;
-        } else {
-            delay(1);
-        }
+// ---------------------------------------------------------------------------
+// Event queue (POST /api/event/modifyQueue, GET /api/event/pollQueue)
+// ---------------------------------------------------------------------------
+
+static char s_queue_id[64] = "";   // queue id without the surrounding braces
+
+bool kef_event_subscribe() {
+    static const char *kSubscribe =
+        "{\"subscribe\":["
+        "{\"path\":\"player:volume\",\"type\":\"itemWithValue\"},"
+        "{\"path\":\"settings:/mediaPlayer/mute\",\"type\":\"itemWithValue\"},"
+        "{\"path\":\"settings:/kef/host/speakerStatus\",\"type\":\"itemWithValue\"},"
+        "{\"path\":\"settings:/kef/play/physicalSource\",\"type\":\"itemWithValue\"},"
+        "{\"path\":\"player:player/data\",\"type\":\"itemWithValue\"}"
+        "],\"unsubscribe\":[]}";
+
+    s_queue_id[0] = '\0';
+
+    ConnLock hold(s_evt_conn);
+    if (http_request(s_evt_conn, "http://" KEF_SPEAKER_IP "/api/event/modifyQueue",
+                     kSubscribe, &kef_accept_all()) != 200) {
+        return false;
     }
 
-    http.end();
+    if (!kef_parse_queue_id(s_evt_conn.doc, s_queue_id, sizeof(s_queue_id))) {
+        DEBUG_PRINTLN("[KEF] Unexpected modifyQueue response");
+        return false;
+    }
+    DEBUG_PRINTF("[KEF] Event queue subscribed: %s\n", s_queue_id);
+    return true;
+}
+
+bool kef_event_is_subscribed() {
+    return s_queue_id[0] != '\0';
+}
+
+bool kef_event_poll(KefState *out, uint32_t timeout_ms) {
+    out->fields = 0;
+    if (!kef_event_is_subscribed()) return false;
+
+    // The speaker holds the request open for `timeout` seconds; give the HTTP
+    // read a few seconds of slack on top so a quiet queue is not an error.
+    char url[160];
+    snprintf(url, sizeof(url),
+             "http://" KEF_SPEAKER_IP "/api/event/pollQueue?queueId=%%7B%s%%7D&timeout=%u",
+             s_queue_id, (unsigned)(timeout_ms / 1000));
+
+    // Each event is {"path":..., "itemType":"update", "itemValue":{...}};
+    // kef_event_filter() keeps only the value fields of the paths we subscribed to.
+    ConnLock hold(s_evt_conn);
+    if (http_request(s_evt_conn, url, nullptr, &kef_event_filter(),
+                     (uint16_t)(timeout_ms + 5000)) != 200) {
+        s_queue_id[0] = '\0';
+        return false;
+    }
 
-    if (total != content_len) {
-        DEBUG_PRINTF("[Art] Short read: got %d of %d bytes\n", total, content_len);
-        free(buf);
-        return nullptr;
+    if (!kef_parse_events(s_evt_conn.doc, out)) {
+        DEBUG_PRINTLN("[KEF] Unexpected pollQueue response");
+        s_queue_id[0] = '\0';
+        return false;
     }
 
-    *out_size = (size_t)content_len;
-    DEBUG_PRINTF("[Art] Fetched %d bytes JPEG\n", content_len);
-    return buf;
+    if (out->fields) DEBUG_PRINTF("[KEF] Events: 0x%02x\n", out->fields);
+    return true;
 }
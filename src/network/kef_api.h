@@ -8,9 +8,13 @@
  * KEF HTTP API wrapper for LSX II speakers.
  *
  * All functions are synchronous and block until the HTTP request completes
- * or times out (HTTP_TIMEOUT from config.h).
+ * or times out (HTTP_TIMEOUT from config.h).  Requests reuse persistent
+ * keep-alive connections to the speaker — one each for commands (setData),
+ * state reads (getData) and the event queue — and reconnect transparently
+ * when the speaker has closed one.
  *
- * Call only from the network task (Core 0).
+ * Safe to call from any Core 0 task: each connection is locked for the
+ * duration of a call, and commands never wait behind a state read.
  */
 
 /**
@@ -89,11 +93,114 @@ bool kef_power_on();
 bool kef_set_source(const char *source);
 
 /**
- * Fetch a JPEG from an HTTPS URL into a PSRAM buffer.
- * Caller must free() the returned pointer.
+ * Reads up to len bytes of a response body into buf (or skips them if buf
+ * is nullptr), waiting for the network as needed.  Returns fewer than len
+ * only at the end of the body or on timeout.
+ */
+typedef size_t (*KefBodyRead)(void *body, uint8_t *buf, size_t len);
+
+/**
+ * Called once with a reader for the response body and its Content-Length.
+ * Returns whether the body was consumed successfully.
+ */
+typedef bool (*KefBodySink)(KefBodyRead read, void *body, size_t length, void *ctx);
+
+/**
+ * Fetch an image over HTTP(S) and hand its body to sink() as it arrives,
+ * so the caller can decode while the download is still running.  Nothing
+ * is buffered here beyond the socket.
+ *
+ * Returns false on failure (network error, too large, sink failed).
+ * @param url   Full HTTP(S) URL of the image.
+ */
+bool kef_stream_jpeg(const char *url, KefBodySink sink, void *ctx);
+
+// ---------------------------------------------------------------------------
+// State snapshot
+//
+// One typed view of the speaker state, filled either by polling getData
+// (kef_get_state) or by a batch of pushed events (kef_event_poll).
+// ---------------------------------------------------------------------------
+
+/** Player fields from player:player/data. */
+typedef struct {
+    char     title[128];
+    char     artist[128];
+    char     cover_url[256];
+    bool     playing;
+    bool     is_standby;
+    uint32_t duration_ms;
+} KefPlayerData;
+
+// KefState.fields bits — set for each field that holds a fresh value
+#define KEF_FIELD_VOLUME  (1 << 0)
+#define KEF_FIELD_MUTE    (1 << 1)
+#define KEF_FIELD_POWER   (1 << 2)
+#define KEF_FIELD_SOURCE  (1 << 3)
+#define KEF_FIELD_PLAYER  (1 << 4)
+
+/** Speaker state. Only members whose KEF_FIELD_* bit is set are valid. */
+typedef struct {
+    uint8_t       fields;
+    int           volume;
+    bool          muted;
+    bool          power_on;      // speakerStatus == "powerOn"
+    char          source[16];    // physicalSource ("wifi", "usb", ...)
+    KefPlayerData player;
+} KefState;
+
+/**
+ * Read the requested set of KEF_FIELD_* bits in one call.  The speaker's
+ * getData takes a single path and HTTPClient cannot pipeline, so this is
+ * still one blocking GET — one round trip — per requested path, the same
+ * as the separate getters; they only share the persistent connection and
+ * the parse.  The reads stop at the first transport failure — an
+ * unreachable speaker (deep standby) costs one timeout per poll instead of
+ * one per path.
  *
- * Returns nullptr on failure (network error, too large, wrong content type).
- * @param url       Full HTTPS URL of the image.
- * @param out_size  Receives the number of bytes in the returned buffer.
+ * out->fields reports what was actually read.  Returns true when every
+ * requested field was read.
+ */
+bool kef_get_state(KefState *out, uint8_t want);
+
+// ---------------------------------------------------------------------------
+// Event queue (long-poll push notifications)
+//
+// The speaker keeps a per-client event queue: POST /api/event/modifyQueue
+// subscribes to a set of paths and returns a queue id, then
+// GET /api/event/pollQueue blocks for up to `timeout` seconds until one of
+// the subscribed values changes.  This replaces periodic polling while the
+// subscription is healthy.
+//
+// The long-poll holds its own HTTP connection, so call these from a task
+// dedicated to event polling — never from a task that services user commands.
+// ---------------------------------------------------------------------------
+
+/**
+ * Create (or replace) the event queue subscription for volume, mute,
+ * speakerStatus, physicalSource and player data.
+ * Returns false if the speaker is unreachable or rejects the request.
+ */
+bool kef_event_subscribe();
+
+/** True while a queue id is held (cleared when a poll fails). */
+bool kef_event_is_subscribed();
+
+/**
+ * Long-poll the event queue for up to timeout_ms (KEF_POLL_TIMEOUT).
+ * Returns true on a valid reply — out->fields is 0 if the poll simply
+ * timed out with no news.  Returns false on any HTTP/parse error and drops
+ * the subscription; call kef_event_subscribe() again before the next poll.
+ */
+bool kef_event_poll(KefState *out, uint32_t timeout_ms);
+
+// ---------------------------------------------------------------------------
+// Diagnostics
+// ---------------------------------------------------------------------------
+
+/**
+ * Heap allocations made while parsing KEF replies since boot.  Replies are
+ * parsed into fixed per-connection arenas (KEF_JSON_ARENA_SIZE), so this only
+ * moves when a reply overflows its arena — it should stay flat while polling.
  */
-uint8_t *kef_fetch_jpeg(const char *url, size_t *out_size);
+uint32_t kef_heap_alloc_count();
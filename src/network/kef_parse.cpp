@@ -0,0 +1,159 @@
+#include "kef_parse.h"
+#include "config.h"
+
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// State paths — shared by getData reads and event queue updates
+// ---------------------------------------------------------------------------
+
+const KefPath kKefPaths[KEF_PATH_COUNT] = {
+    { KEF_FIELD_POWER,  "settings:/kef/host/speakerStatus",   "settings%3A%2Fkef%2Fhost%2FspeakerStatus" },
+    { KEF_FIELD_PLAYER, "player:player/data",                 "player%3Aplayer%2Fdata" },
+    { KEF_FIELD_SOURCE, "settings:/kef/play/physicalSource",  "settings%3A%2Fkef%2Fplay%2FphysicalSource" },
+    { KEF_FIELD_VOLUME, "player:volume",                      "player%3Avolume" },
+    { KEF_FIELD_MUTE,   "settings:/mediaPlayer/mute",         "settings%3A%2FmediaPlayer%2Fmute" },
+};
+
+// ---------------------------------------------------------------------------
+// Filters
+// ---------------------------------------------------------------------------
+
+// Value fields kept from getData replies and event itemValues — everything
+// kef_parse_value() and kef_get_power() read, nothing else.
+static void add_value_fields(JsonObject v) {
+    v["i32_"]                                     = true;
+    v["bool_"]                                    = true;
+    v["kefSpeakerStatus"]                         = true;
+    v["kefPhysicalSource"]                        = true;
+    v["kefPowerState"]                            = true;
+    v["state"]                                    = true;
+    v["trackRoles"]["title"]                      = true;
+    v["trackRoles"]["icon"]                       = true;
+    v["trackRoles"]["mediaData"]["metaData"]["artist"] = true;
+    v["status"]["duration"]                       = true;
+}
+
+const JsonDocument &kef_getdata_filter() {
+    static const JsonDocument f = [] {
+        JsonDocument d;
+        add_value_fields(d.add<JsonObject>());
+        return d;
+    }();
+    return f;
+}
+
+const JsonDocument &kef_event_filter() {
+    static const JsonDocument f = [] {
+        JsonDocument d;
+        JsonObject ev = d.add<JsonObject>();
+        ev["path"] = true;
+        add_value_fields(ev["itemValue"].to<JsonObject>());
+        return d;
+    }();
+    return f;
+}
+
+const JsonDocument &kef_accept_all() {
+    static const JsonDocument f = [] {
+        JsonDocument d;
+        d.set(true);
+        return d;
+    }();
+    return f;
+}
+
+// ---------------------------------------------------------------------------
+// Values
+// ---------------------------------------------------------------------------
+
+// Copy a string into a fixed buffer, always null-terminating.
+static void copy_str(char *dst, size_t dst_len, const char *src) {
+    strncpy(dst, src, dst_len - 1);
+    dst[dst_len - 1] = '\0';
+}
+
+// Extract the fields we display from a player:player/data value object.
+// Shared by the getData poll and the event queue (same object layout).
+static void parse_player_data(JsonObjectConst root, KefPlayerData *out) {
+    const char *state = root["state"] | "unknown";
+    out->playing    = (strcmp(state, "playing") == 0);
+    // "stopped" = idle/standby, "standby" = deep standby — both mean off
+    out->is_standby = (strcmp(state, "playing") != 0 && strcmp(state, "pause") != 0);
+
+    copy_str(out->title,  sizeof(out->title),  root["trackRoles"]["title"] | "--");
+    copy_str(out->artist, sizeof(out->artist),
+             root["trackRoles"]["mediaData"]["metaData"]["artist"] | "--");
+
+    // Album art URL: trackRoles.icon (direct HTTPS CDN URL from Spotify)
+    copy_str(out->cover_url, sizeof(out->cover_url), root["trackRoles"]["icon"] | "");
+
+    // Duration is at root["status"]["duration"] (ms). Position is not in the API.
+    out->duration_ms = root["status"]["duration"] | 0;
+
+    DEBUG_PRINTF("[KEF] State: %s | Now playing: %s - %s\n", state, out->title, out->artist);
+}
+
+bool kef_parse_value(uint8_t field, JsonObjectConst v, KefState *out) {
+    switch (field) {
+        case KEF_FIELD_POWER: {
+            // kefSpeakerStatus="powerOn" when the speaker is physically on,
+            // regardless of playback state.
+            const char *status = v["kefSpeakerStatus"] | "";
+            out->power_on = (strcmp(status, "powerOn") == 0);
+            DEBUG_PRINTF("[KEF] Speaker status: %s\n", status);
+            return true;
+        }
+        case KEF_FIELD_PLAYER:
+            parse_player_data(v, &out->player);
+            return true;
+        case KEF_FIELD_SOURCE:
+            copy_str(out->source, sizeof(out->source), v["kefPhysicalSource"] | "");
+            return true;
+        case KEF_FIELD_VOLUME:
+            if (!v["i32_"].is<int>()) {
+                DEBUG_PRINTLN("[KEF] Volume key missing");
+                return false;
+            }
+            out->volume = v["i32_"].as<int>();
+            return true;
+        case KEF_FIELD_MUTE:
+            out->muted = v["bool_"] | false;
+            return true;
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// Event queue
+// ---------------------------------------------------------------------------
+
+bool kef_parse_queue_id(JsonVariantConst reply, char *id, size_t id_len) {
+    id[0] = '\0';
+    if (!reply.is<const char *>()) return false;
+
+    const char *s = reply.as<const char *>();
+    if (s[0] == '{') s++;
+    size_t n = strlen(s);
+    if (n > 0 && s[n - 1] == '}') n--;
+    if (n == 0 || n >= id_len) return false;
+
+    memcpy(id, s, n);
+    id[n] = '\0';
+    return true;
+}
+
+bool kef_parse_events(JsonVariantConst reply, KefState *out) {
+    if (!reply.is<JsonArrayConst>()) return false;
+
+    for (JsonObjectConst ev : reply.as<JsonArrayConst>()) {
+        const char *path = ev["path"] | "";
+        for (const auto &p : kKefPaths) {
+            if (strcmp(path, p.path) == 0) {
+                if (kef_parse_value(p.field, ev["itemValue"], out)) out->fields |= p.field;
+                break;
+            }
+        }
+    }
+    return true;
+}
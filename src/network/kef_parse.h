@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ArduinoJson.h>
+
+#include "kef_api.h"
+
+/**
+ * KEF reply parsing, split from the HTTP transport in kef_api.cpp.
+ *
+ * The filters below are what kef_api passes to deserializeJson() for each
+ * kind of reply, and the parse functions turn the filtered documents into
+ * KefState fields and event queue ids.  Depends on ArduinoJson only — no
+ * Arduino or FreeRTOS — so canned speaker replies run through the same
+ * code in the native test env.
+ */
+
+/** One state path, as read by getData and reported by the event queue. */
+typedef struct {
+    uint8_t     field;   // KEF_FIELD_*
+    const char *path;    // as reported in event queue updates
+    const char *query;   // URL-encoded for getData?path=
+} KefPath;
+
+#define KEF_PATH_COUNT 5
+
+/**
+ * Every state path, in kef_get_state()'s read order: power first so
+ * standby is detected even if the speaker stops answering part-way
+ * through the burst.
+ */
+extern const KefPath kKefPaths[KEF_PATH_COUNT];
+
+/** getData reply: [ {value} ] — the value fields kef_parse_value() reads. */
+const JsonDocument &kef_getdata_filter();
+
+/** pollQueue reply: [ {"path", "itemValue": {value}}, ... ]. */
+const JsonDocument &kef_event_filter();
+
+/** Small replies kept whole (modifyQueue's queue id string). */
+const JsonDocument &kef_accept_all();
+
+/**
+ * Store one path's value object into out.  Does not touch out->fields.
+ * Returns false if the value is malformed.
+ */
+bool kef_parse_value(uint8_t field, JsonObjectConst v, KefState *out);
+
+/**
+ * Queue id from a modifyQueue reply — a bare JSON string "{xxxxxxxx-...}" —
+ * without the braces.  Returns false (id = "") if the reply is not a
+ * non-empty string or the id does not fit.
+ */
+bool kef_parse_queue_id(JsonVariantConst reply, char *id, size_t id_len);
+
+/**
+ * Apply a pollQueue reply to out: each update for a known path sets its
+ * field and KEF_FIELD_* bit, unknown paths are skipped.  An empty array is
+ * a poll that timed out with no news.  Returns false if the reply is not
+ * an array — the speaker no longer knows the queue.
+ */
+bool kef_parse_events(JsonVariantConst reply, KefState *out);
@@ -29,8 +29,17 @@ static char     s_broker_ip[32]     = "";
 static int      s_broker_port       = 1883;
 static uint32_t s_last_reconnect_ms = 0;
 
+// PubSubClient is not thread-safe.  The control task runs loop() and publish,
+// the state task runs the (slow, blocking) reconnect; s_lock serialises them
+// and the control side only ever try-takes it, so a broker that is down
+// costs the control task nothing.  s_connected is the last connection state
+// seen under the lock: the state task only takes the lock when it is false,
+// so a connected client never has a publish turned away by maintenance.
+static SemaphoreHandle_t s_lock      = NULL;
+static volatile bool     s_connected = false;
+
 // ---------------------------------------------------------------------------
-// MQTT receive callback — fires on Core 0 inside mqtt_client_loop()
+// MQTT receive callback — fires in the control task inside mqtt_client_loop()
 // ---------------------------------------------------------------------------
 
 static void on_message(const char *topic, uint8_t *payload, unsigned int len) {
@@ -95,32 +104,47 @@ void mqtt_client_begin(const char *broker_ip, int port) {
     s_mqtt.setServer(s_broker_ip, (uint16_t)s_broker_port);
     s_mqtt.setCallback(on_message);
     s_mqtt.setBufferSize(1024);  // Z2M state payloads include OTA URLs, easily >512 bytes
+    s_lock    = xSemaphoreCreateMutex();
     s_enabled = true;
 
+    // The first connect happens in mqtt_client_maintain().
     DEBUG_PRINTF("[MQTT] Broker: %s:%d\n", s_broker_ip, s_broker_port);
-    do_connect();
 }
 
-void mqtt_client_loop() {
+void mqtt_client_maintain() {
     if (!s_enabled) return;
 
+    uint32_t now = (uint32_t)millis();
+    if (s_connected) return;
+    if (s_last_reconnect_ms != 0 && now - s_last_reconnect_ms < 5000) return;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
     if (!s_mqtt.connected()) {
-        uint32_t now = (uint32_t)millis();
-        if (now - s_last_reconnect_ms >= 5000) {
-            s_last_reconnect_ms = now;
-            if (do_connect()) {
-                s_last_reconnect_ms = 0;
-            }
+        s_last_reconnect_ms = now;
+        if (do_connect()) {
+            s_last_reconnect_ms = 0;
         }
-        return;  // skip loop() while disconnected
     }
+    s_connected = s_mqtt.connected();
+    xSemaphoreGive(s_lock);
+}
 
-    s_mqtt.loop();
+void mqtt_client_loop() {
+    if (!s_enabled) return;
+    if (xSemaphoreTake(s_lock, 0) != pdTRUE) return;  // reconnect in progress
+
+    if (s_mqtt.connected()) s_mqtt.loop();  // skip loop() while disconnected
+    s_connected = s_mqtt.connected();
+    xSemaphoreGive(s_lock);
 }
 
 bool mqtt_light_publish(const char *json_payload) {
-    if (!s_enabled || !s_mqtt.connected()) return false;
-    bool ok = s_mqtt.publish(MQTT_LIGHT_SET_TOPIC, json_payload);
+    if (!s_enabled) return false;
+    if (xSemaphoreTake(s_lock, 0) != pdTRUE) return false;  // reconnect in progress
+
+    bool ok = s_mqtt.connected() && s_mqtt.publish(MQTT_LIGHT_SET_TOPIC, json_payload);
+    s_connected = s_mqtt.connected();
+    xSemaphoreGive(s_lock);
     if (ok) {
         DEBUG_PRINTF("[MQTT] Published: %s\n", json_payload);
     }
@@ -16,17 +16,24 @@ extern volatile float g_light_color_sat;    // 0–100
 extern volatile bool  g_light_state_dirty;  // Core 0 → Core 1 paint signal
 
 // ---------------------------------------------------------------------------
-// API — all functions must be called from Core 0 (networkTask)
+// API — Core 0 only.  loop/publish belong to the control task and never
+// block; the state task calls mqtt_client_maintain() to (re)connect.
 // ---------------------------------------------------------------------------
 
-// Connect to broker and subscribe to the light state topic.
+// Configure the broker.  Call once before the Core 0 tasks start.
 // No-op if broker_ip is null or empty (MQTT_BROKER_IP not set in config_local.h).
 void mqtt_client_begin(const char *broker_ip, int port);
 
-// Process incoming messages and maintain the connection.
-// Call every networkTask loop iteration.
+// Connect (at most every 5s) and subscribe to the light state topic while
+// the broker is unreachable.  May block for the TCP connect timeout.
+// Call every state task loop iteration.
+void mqtt_client_maintain();
+
+// Process incoming messages.  Returns immediately while disconnected or
+// while mqtt_client_maintain() is reconnecting.
+// Call every control task loop iteration.
 void mqtt_client_loop();
 
 // Publish a JSON payload to the light /set topic.
-// Returns true on success.  False if disconnected or MQTT disabled.
+// Returns true on success.  False if disconnected, reconnecting or MQTT disabled.
 bool mqtt_light_publish(const char *json_payload);
@@ -7,6 +7,8 @@
 #include <ArduinoJson.h>
 #include <mbedtls/base64.h>
 
+#include "body_stream.h"
+
 // ---------------------------------------------------------------------------
 // Credentials + token state
 // ---------------------------------------------------------------------------
@@ -15,7 +17,8 @@ static char s_client_id[64]      = "";
 static char s_client_secret[64]  = "";
 static char s_refresh_token[256] = "";
 static char s_access_token[256]  = "";
-static uint32_t s_token_exp_ms   = 0;   // millis() at which to proactively refresh
+static uint32_t s_token_exp_ms     = 0;   // millis() past which the token must not be used
+static uint32_t s_token_refresh_ms = 0;   // millis() at which spotify_maintain_token() refreshes
 
 void spotify_init(const char *client_id,
                   const char *client_secret,
@@ -27,13 +30,26 @@ void spotify_init(const char *client_id,
 
 // ---------------------------------------------------------------------------
 // Token refresh (POST accounts.spotify.com/api/token)
+//
+// spotifyTask calls spotify_maintain_token() between requests, which
+// refreshes SPOTIFY_TOKEN_REFRESH_AHEAD_S before expiry, so a poll or a
+// playback command normally finds a valid token and never waits on
+// accounts.spotify.com.  ensure_token() only refreshes inline when there is
+// no usable token at all (boot, or background refreshes kept failing), and
+// api_call() refreshes and resends once if Spotify rejects the token early.
 // ---------------------------------------------------------------------------
 
+static bool have_credentials() {
+    return s_client_id[0] && s_client_secret[0] && s_refresh_token[0];
+}
+
 static bool do_token_refresh() {
-    if (!s_client_id[0] || !s_client_secret[0] || !s_refresh_token[0]) {
+    if (!have_credentials()) {
         DEBUG_PRINTLN("[Spotify] Credentials not configured — skipping");
         return false;
     }
+    // Overwritten on success; a failed refresh is retried in the background.
+    s_token_refresh_ms = (uint32_t)millis() + SPOTIFY_TOKEN_RETRY_MS;
 
     // Base64-encode "client_id:client_secret" for Basic auth
     char creds[128];
@@ -85,74 +101,211 @@ static bool do_token_refresh() {
 
     strncpy(s_access_token, tok, sizeof(s_access_token) - 1);
     int expires_in = doc["expires_in"] | 3600;
-    // Refresh 5 minutes before actual expiry
-    s_token_exp_ms = (uint32_t)millis() + (uint32_t)(expires_in - 300) * 1000;
-    DEBUG_PRINTLN("[Spotify] Token refreshed");
+    // Use it until 30 s before expiry; refresh in the background well before
+    // that (halfway through, should Spotify ever issue short-lived tokens).
+    uint32_t valid_ms = (uint32_t)expires_in * 1000;
+    uint32_t ahead_ms = (uint32_t)SPOTIFY_TOKEN_REFRESH_AHEAD_S * 1000;
+    if (ahead_ms > valid_ms / 2) ahead_ms = valid_ms / 2;
+    uint32_t now = (uint32_t)millis();
+    s_token_exp_ms     = now + valid_ms - min(valid_ms / 4, (uint32_t)30000);
+    s_token_refresh_ms = now + valid_ms - ahead_ms;
+    DEBUG_PRINTF("[Spotify] Token refreshed (valid %d s)\n", expires_in);
     return true;
 }
 
 static bool ensure_token() {
-    if (!s_access_token[0] || (uint32_t)millis() >= s_token_exp_ms) {
+    if (!s_access_token[0] || (int32_t)((uint32_t)millis() - s_token_exp_ms) >= 0) {
         return do_token_refresh();
     }
     return true;
 }
 
+bool spotify_maintain_token() {
+    if (!have_credentials()) return false;
+    if ((int32_t)((uint32_t)millis() - s_token_refresh_ms) < 0) return false;
+    do_token_refresh();
+    return true;
+}
+
 // ---------------------------------------------------------------------------
-// Now-playing (GET api.spotify.com/v1/me/player/currently-playing)
+// Persistent API connection
+//
+// Every api.spotify.com call — the now-playing poll, the queue read and the
+// playback commands, all from spotifyTask — goes over one TLS socket kept
+// open between requests, so play/pause/next leave on a warm connection
+// instead of paying a full handshake (hundreds of ms of CPU and tens of KB
+// of heap) each time.  api_connect() does the handshake itself so its cost
+// is counted apart from the request; both show up in the latency log.
+//
+// NetworkClientSecure keeps no TLS session between connections, so a
+// reconnect is always a full handshake — holding the socket open is what
+// saves it.  Spotify drops idle sockets on its own schedule; as in kef_api,
+// a request that fails with a dead-socket error on a warm connection is
+// retried once on a fresh one, and read timeouts are not retried ("next"
+// may already have been acted on).
+//
+// The token endpoint is another host and is called about once an hour, so
+// do_token_refresh() keeps its one-shot client.
 // ---------------------------------------------------------------------------
 
-bool spotify_get_now_playing(char *title,        size_t title_len,
-                              char *artist,       size_t artist_len,
-                              char *cover_url,    size_t cover_url_len,
-                              bool     *out_playing,
-                              bool     *out_nothing,
-                              uint32_t *out_progress_ms,
-                              uint32_t *out_duration_ms) {
-    *out_playing     = false;
-    *out_nothing     = false;
-    *out_progress_ms = 0;
-    *out_duration_ms = 0;
+typedef struct {
+    uint32_t count;
+    uint32_t total_ms;
+    uint32_t max_ms;
+} SpotifyLatency;
+
+static NetworkClientSecure s_api_client;
+static HTTPClient          s_api_http;
+static bool                s_api_warm       = false;  // socket has completed a request
+static uint32_t            s_api_reconnects = 0;      // stale-socket retries
+static SpotifyLatency      s_handshake_lat  = {};     // TLS connect
+static SpotifyLatency      s_request_lat    = {};     // request sent → status line
+
+static void record_latency(SpotifyLatency &l, uint32_t ms) {
+    l.count++;
+    l.total_ms += ms;
+    if (ms > l.max_ms) l.max_ms = ms;
+}
 
-    if (!ensure_token()) return false;
+static void log_latency() {
+    const SpotifyLatency &h = s_handshake_lat;
+    const SpotifyLatency &r = s_request_lat;
+    DEBUG_PRINTF("[Spotify] Handshake n=%u avg %u max %u ms | request n=%u avg %u max %u ms"
+                 " | %u stale reconnects\n",
+                 (unsigned)h.count, (unsigned)(h.count ? h.total_ms / h.count : 0),
+                 (unsigned)h.max_ms,
+                 (unsigned)r.count, (unsigned)(r.count ? r.total_ms / r.count : 0),
+                 (unsigned)r.max_ms, (unsigned)s_api_reconnects);
+}
 
-    NetworkClientSecure client;
-    client.setInsecure();
-    HTTPClient http;
-    http.setTimeout(HTTP_TIMEOUT);
+// Open the TLS socket if it is not already open.
+static bool api_connect() {
+    if (s_api_client.connected()) return true;
 
-    if (!http.begin(client,
-                    "https://api.spotify.com/v1/me/player/currently-playing")) {
-        DEBUG_PRINTLN("[Spotify] now-playing: http.begin failed");
+    s_api_client.setInsecure();
+    uint32_t t0 = (uint32_t)millis();
+    if (!s_api_client.connect("api.spotify.com", 443)) {
+        DEBUG_PRINTLN("[Spotify] TLS connect failed");
         return false;
     }
-    http.addHeader("Authorization",
-                   String("Bearer ") + s_access_token);
+    record_latency(s_handshake_lat, (uint32_t)millis() - t0);
+    log_latency();
+    return true;
+}
 
-    int code = http.GET();
+// Send method + path to api.spotify.com on the shared socket.  On HTTP 200
+// with a filter the reply is parsed into *doc (parse errors are logged and
+// leave doc null); any other body is discarded.  The socket is left at a
+// response boundary for the next request.  Returns the HTTP status, or a
+// negative HTTPC_ERROR_* when Spotify did not answer.
+static int api_request(const char *method, const char *path,
+                       const JsonDocument *filter = nullptr, JsonDocument *doc = nullptr) {
+    char url[96];
+    snprintf(url, sizeof(url), "https://api.spotify.com%s", path);
+
+    static bool headers = false;
+    if (!headers) {
+        static const char *kKeys[] = { "Transfer-Encoding" };
+        s_api_http.collectHeaders(kKeys, 1);
+        headers = true;
+    }
 
-    if (code == 204) {
-        // No active playback session
-        DEBUG_PRINTLN("[Spotify] 204 — nothing playing");
-        http.end();
-        *out_nothing = true;
-        return false;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool warm = s_api_warm && s_api_client.connected();
+        if (!api_connect()) return HTTPC_ERROR_CONNECTION_REFUSED;
+
+        HTTPClient &http = s_api_http;
+        http.setReuse(true);
+        http.setTimeout(HTTP_TIMEOUT);
+        if (!http.begin(s_api_client, url)) {
+            DEBUG_PRINTF("[Spotify] %s %s: http.begin failed\n", method, path);
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+        }
+        http.addHeader("Authorization", String("Bearer ") + s_access_token);
+
+        uint32_t t0 = (uint32_t)millis();
+        int code;
+        if (strcmp(method, "GET") == 0) {
+            code = http.GET();
+        } else {
+            http.addHeader("Content-Length", "0");
+            code = http.sendRequest(method, (uint8_t *)"", 0);
+        }
+
+        bool dead_socket = (code == HTTPC_ERROR_SEND_HEADER_FAILED  ||
+                            code == HTTPC_ERROR_SEND_PAYLOAD_FAILED ||
+                            code == HTTPC_ERROR_NOT_CONNECTED       ||
+                            code == HTTPC_ERROR_CONNECTION_LOST);
+        if (dead_socket && warm && attempt == 0) {
+            s_api_warm = false;
+            s_api_reconnects++;
+            http.end();
+            s_api_client.stop();
+            DEBUG_PRINTF("[Spotify] Stale connection (%d), reconnecting (#%u)\n",
+                         code, (unsigned)s_api_reconnects);
+            continue;
+        }
+        if (code <= 0) {
+            DEBUG_PRINTF("[Spotify] %s %s failed: %d\n", method, path, code);
+            s_api_warm = false;
+            http.end();
+            s_api_client.stop();
+            return code;
+        }
+        record_latency(s_request_lat, (uint32_t)millis() - t0);
+        if (s_request_lat.count % 60 == 0) log_latency();
+
+        bool chunked = http.getSize() < 0 &&
+                       http.header("Transfer-Encoding").equalsIgnoreCase("chunked");
+        BodyStream body(*http.getStreamPtr(), http.getSize(), chunked);
+        if (code == 200 && filter && doc) {
+            DeserializationError err = deserializeJson(*doc, body,
+                                                       DeserializationOption::Filter(*filter));
+            if (err) {
+                DEBUG_PRINTF("[Spotify] %s JSON parse error: %s\n", path, err.c_str());
+                doc->clear();
+            }
+        }
+        body.drain();
+        http.end();            // keeps the socket open unless Spotify closed it
+        s_api_warm = true;
+        return code;
     }
+    return HTTPC_ERROR_CONNECTION_LOST;
+}
+
+// api_request() with a valid token.  A 401 means Spotify revoked or expired
+// the token early: refresh it and send the request once more, so the caller
+// sees the answer rather than a failure.  Returns 401 if no token could be
+// obtained.
+static int api_call(const char *method, const char *path,
+                    const JsonDocument *filter = nullptr, JsonDocument *doc = nullptr) {
+    if (!ensure_token()) return 401;
 
+    int code = api_request(method, path, filter, doc);
     if (code == 401) {
-        // Token was rejected — refresh now so the next poll succeeds
-        http.end();
-        DEBUG_PRINTLN("[Spotify] 401 — forcing token refresh");
+        DEBUG_PRINTLN("[Spotify] 401 — refreshing token and retrying");
         s_access_token[0] = '\0';
-        do_token_refresh();
-        return false;
+        if (do_token_refresh()) code = api_request(method, path, filter, doc);
     }
+    return code;
+}
 
-    if (code != 200) {
-        DEBUG_PRINTF("[Spotify] now-playing HTTP %d\n", code);
-        http.end();
-        return false;
-    }
+// ---------------------------------------------------------------------------
+// Now-playing (GET api.spotify.com/v1/me/player/currently-playing)
+// ---------------------------------------------------------------------------
+
+bool spotify_get_now_playing(char *title,        size_t title_len,
+                              char *artist,       size_t artist_len,
+                              char *cover_url,    size_t cover_url_len,
+                              bool     *out_playing,
+                              bool     *out_nothing,
+                              uint32_t *out_progress_ms,
+                              uint32_t *out_duration_ms) {
+    *out_playing     = false;
+    *out_nothing     = false;
+    *out_progress_ms = 0;
+    *out_duration_ms = 0;
 
     // Filter: parse only the fields we actually use, avoiding buffering the
     // full large response body (~3-5 KB) into a heap String.
@@ -165,15 +318,20 @@ bool spotify_get_now_playing(char *title,        size_t title_len,
     filter["item"]["album"]["images"][0]["url"] = true;
 
     JsonDocument doc;
-    Stream *stream = http.getStreamPtr();
-    DeserializationError err = deserializeJson(doc, *stream,
-                                               DeserializationOption::Filter(filter));
-    http.end();
+    int code = api_call("GET", "/v1/me/player/currently-playing", &filter, &doc);
+
+    if (code == 204) {
+        // No active playback session
+        DEBUG_PRINTLN("[Spotify] 204 — nothing playing");
+        *out_nothing = true;
+        return false;
+    }
 
-    if (err) {
-        DEBUG_PRINTF("[Spotify] JSON parse error: %s\n", err.c_str());
+    if (code != 200) {
+        DEBUG_PRINTF("[Spotify] now-playing HTTP %d\n", code);
         return false;
     }
+    if (doc.isNull()) return false;   // parse error, already logged
 
     *out_playing     = doc["is_playing"]       | false;
     *out_progress_ms = doc["progress_ms"]      | 0;
@@ -198,33 +356,39 @@ bool spotify_get_now_playing(char *title,        size_t title_len,
 }
 
 // ---------------------------------------------------------------------------
-// Playback control (PUT/POST api.spotify.com/v1/me/player/*)
-// Requires user-modify-playback-state scope + Spotify Premium.
+// Queue (GET api.spotify.com/v1/me/player/queue)
 // ---------------------------------------------------------------------------
 
-static bool do_playback_cmd(const char *method, const char *path) {
-    if (!ensure_token()) return false;
+bool spotify_get_next_cover(char *cover_url, size_t cover_url_len) {
+    cover_url[0] = '\0';
 
-    NetworkClientSecure client;
-    client.setInsecure();
-    HTTPClient http;
-    http.setTimeout(HTTP_TIMEOUT);
+    // The queue lists up to 20 full track objects (tens of KB); keep only
+    // the cover URLs.  A filter on element 0 applies to every element.
+    JsonDocument filter;
+    filter["queue"][0]["album"]["images"][0]["url"] = true;
 
-    String url = String("https://api.spotify.com") + path;
-    if (!http.begin(client, url)) {
-        DEBUG_PRINTF("[Spotify] %s %s: http.begin failed\n", method, path);
+    JsonDocument doc;
+    int code = api_call("GET", "/v1/me/player/queue", &filter, &doc);
+
+    if (code != 200) {
+        DEBUG_PRINTF("[Spotify] queue HTTP %d\n", code);
         return false;
     }
-    http.addHeader("Authorization", String("Bearer ") + s_access_token);
-    http.addHeader("Content-Length", "0");
-
-    int code;
-    if (strcmp(method, "PUT") == 0) {
-        code = http.PUT((uint8_t *)"", 0);
-    } else {
-        code = http.POST((uint8_t *)"", 0);
-    }
-    http.end();
+    if (doc.isNull()) return false;   // parse error, already logged
+
+    const char *img = doc["queue"][0]["album"]["images"][0]["url"] | "";
+    strncpy(cover_url, img, cover_url_len - 1);
+    cover_url[cover_url_len - 1] = '\0';
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Playback control (PUT/POST api.spotify.com/v1/me/player/*)
+// Requires user-modify-playback-state scope + Spotify Premium.
+// ---------------------------------------------------------------------------
+
+static bool do_playback_cmd(const char *method, const char *path) {
+    int code = api_call(method, path);
 
     bool ok = (code == 200 || code == 204);
     if (!ok) DEBUG_PRINTF("[Spotify] %s %s → HTTP %d\n", method, path, code);
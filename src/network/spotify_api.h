@@ -11,7 +11,7 @@
  *   SPOTIFY_CLIENT_ID, SPOTIFY_CLIENT_SECRET, SPOTIFY_REFRESH_TOKEN
  *
  * See CLAUDE.md "Spotify Setup" for how to obtain a refresh token.
- * Call only from the network task (Core 0).
+ * Call only from the Spotify task (Core 0) — the module is not thread-safe.
  */
 
 /**
@@ -21,6 +21,14 @@ void spotify_init(const char *client_id,
                   const char *client_secret,
                   const char *refresh_token);
 
+/**
+ * Refresh the access token if it is due (SPOTIFY_TOKEN_REFRESH_AHEAD_S
+ * before expiry, or a retry after a failed refresh).  Call from the Spotify
+ * task between requests so polls and playback commands never wait on the
+ * token endpoint.  Returns true if a refresh was attempted.
+ */
+bool spotify_maintain_token();
+
 /**
  * Fetch the currently-playing track from Spotify.
  *
@@ -41,10 +49,20 @@ bool spotify_get_now_playing(char *title,        size_t title_len,
                               uint32_t *out_progress_ms,
                               uint32_t *out_duration_ms);
 
+/**
+ * Fetch the cover URL of the next track in the user's playback queue, so
+ * its art can be decoded before the track starts.
+ *
+ * Returns true with cover_url filled on success — "" when the queue is
+ * empty or the next item has no album art (e.g. a podcast episode).
+ * Returns false on a network or auth error.
+ */
+bool spotify_get_next_cover(char *cover_url, size_t cover_url_len);
+
 /**
  * Playback control — require Spotify Premium and the
  * user-modify-playback-state scope in your refresh token.
- * Call only from the network task (Core 0).
+ * Call only from the Spotify task (Core 0).
  */
 bool spotify_play();
 bool spotify_pause();
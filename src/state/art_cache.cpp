@@ -0,0 +1,116 @@
+#include "art_cache.h"
+
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static ArtCacheEntry *find(ArtCache *c, uint64_t key) {
+    for (auto &e : c->entries) {
+        if (e.key == key) return &e;
+    }
+    return nullptr;
+}
+
+static void drop(ArtCache *c, ArtCacheEntry *e) {
+    c->release(e->data);
+    c->used -= e->size;
+    e->key  = 0;
+    e->data = nullptr;
+    e->size = 0;
+}
+
+// Least-recently-used occupied slot, or nullptr if the cache is empty.
+static ArtCacheEntry *oldest(ArtCache *c) {
+    ArtCacheEntry *lru = nullptr;
+    for (auto &e : c->entries) {
+        if (!e.key) continue;
+        // Compare ages, not stamps, so the clock may wrap.
+        if (!lru || c->clock - e.last_used > c->clock - lru->last_used) lru = &e;
+    }
+    return lru;
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+uint64_t art_cache_key(const char *url) {
+    // FNV-1a, 64-bit
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (const unsigned char *p = (const unsigned char *)url; *p; p++) {
+        h ^= *p;
+        h *= 0x100000001b3ull;
+    }
+    return h ? h : 1;
+}
+
+void art_cache_init(ArtCache *c, size_t budget_bytes,
+                    void *(*alloc)(size_t), void (*release)(void *)) {
+    memset(c, 0, sizeof(*c));
+    c->budget  = budget_bytes;
+    c->alloc   = alloc;
+    c->release = release;
+}
+
+bool art_cache_probe(ArtCache *c, uint64_t key) {
+    ArtCacheEntry *e = find(c, key);
+    if (!e) {
+        c->misses++;
+        return false;
+    }
+    e->last_used = ++c->clock;
+    c->hits++;
+    return true;
+}
+
+const void *art_cache_get(const ArtCache *c, uint64_t key, size_t *out_size) {
+    for (const auto &e : c->entries) {
+        if (e.key == key) {
+            if (out_size) *out_size = e.size;
+            return e.data;
+        }
+    }
+    return nullptr;
+}
+
+bool art_cache_put(ArtCache *c, uint64_t key, const void *data, size_t size) {
+    if (key == 0 || size == 0 || size > c->budget) return false;
+
+    ArtCacheEntry *e = find(c, key);
+    if (e) drop(c, e);
+
+    // Make room: bytes first, then a free slot.
+    while (c->used + size > c->budget) {
+        ArtCacheEntry *lru = oldest(c);
+        if (!lru) break;
+        drop(c, lru);
+        c->evictions++;
+    }
+    e = find(c, 0);
+    if (!e) {
+        e = oldest(c);
+        drop(c, e);
+        c->evictions++;
+    }
+
+    void *copy = c->alloc(size);
+    if (!copy) return false;
+    memcpy(copy, data, size);
+
+    e->key       = key;
+    e->data      = copy;
+    e->size      = size;
+    e->last_used = ++c->clock;
+    c->used     += size;
+    return true;
+}
+
+int art_cache_count(const ArtCache *c) {
+    int n = 0;
+    for (const auto &e : c->entries) {
+        if (e.key) n++;
+    }
+    return n;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * LRU cache of album art, keyed by a 64-bit hash of the cover URL.
+ *
+ * Each entry is an owned copy of a blob — main.cpp stores the decoded
+ * ALBUM_ART_SIZE² RGB565 frame, so a hit skips both the HTTPS fetch and the
+ * JPEG decode.  Entries are evicted least-recently-used first whenever an
+ * insert would take the total past the byte budget.  Memory comes from the
+ * alloc/release hooks (PSRAM on the device, malloc on a host).
+ *
+ * No Arduino or FreeRTOS dependencies.  Not thread-safe; artTask owns it
+ * once the tasks start.
+ */
+
+#define ART_CACHE_MAX_ENTRIES 32
+
+typedef struct {
+    uint64_t key;        // 0 = free slot
+    void    *data;
+    size_t   size;
+    uint32_t last_used;  // LRU stamp from ArtCache::clock
+} ArtCacheEntry;
+
+typedef struct {
+    ArtCacheEntry entries[ART_CACHE_MAX_ENTRIES];
+    size_t   budget;     // max bytes held across all entries
+    size_t   used;
+    uint32_t clock;      // bumped on every probe / put
+
+    void *(*alloc)(size_t size);
+    void  (*release)(void *p);
+
+    // Counters
+    uint32_t hits;       // probes that found the key
+    uint32_t misses;     // probes that did not
+    uint32_t evictions;
+} ArtCache;
+
+/** Cache key for a cover URL.  Never 0, so 0 can mean "no art". */
+uint64_t art_cache_key(const char *url);
+
+void art_cache_init(ArtCache *c, size_t budget_bytes,
+                    void *(*alloc)(size_t), void (*release)(void *));
+
+/**
+ * Look up key, counting a hit or a miss and marking a hit most recently
+ * used.  Use this where the answer decides whether to fetch.
+ */
+bool art_cache_probe(ArtCache *c, uint64_t key);
+
+/**
+ * Data stored under key, or nullptr.  Does not touch the counters or the
+ * LRU order.  The pointer stays valid until the next art_cache_put().
+ */
+const void *art_cache_get(const ArtCache *c, uint64_t key, size_t *out_size);
+
+/**
+ * Copy size bytes into the cache under key, replacing any existing entry
+ * and evicting LRU entries to stay within the budget (and within
+ * ART_CACHE_MAX_ENTRIES).  Returns false, caching nothing, if size exceeds
+ * the budget or the allocation fails.
+ */
+bool art_cache_put(ArtCache *c, uint64_t key, const void *data, size_t size);
+
+/** Number of entries currently held. */
+int art_cache_count(const ArtCache *c);
@@ -0,0 +1,73 @@
+#include "art_plan.h"
+
+#include <string.h>
+
+// Spotify image ids start with a 16-hex-digit prefix that encodes the size:
+//   https://i.scdn.co/image/ab67616d0000b273<hash>   640 px
+//   https://i.scdn.co/image/ab67616d00001e02<hash>   300 px
+//   https://i.scdn.co/image/ab67616d00004851<hash>    64 px
+#define SPOTIFY_IMAGE_BASE "https://i.scdn.co/image/ab67616d"
+#define SIZE_CODE_LEN      8
+
+static const char *const kSizeCode[ART_VARIANT_COUNT] = {
+    "0000b273",   // ART_VARIANT_LARGE
+    "00001e02",   // ART_VARIANT_SMALL
+};
+static const char *const kThumbCode = "00004851";
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+void art_plan_init(ArtPlan *p, uint32_t small_max_cost_pct) {
+    memset(p, 0, sizeof(*p));
+    p->small_max_cost_pct = small_max_cost_pct;
+}
+
+ArtVariant art_plan_choose(ArtPlan *p) {
+    p->covers++;
+
+    // Two samples of each before trusting the averages.
+    if (p->samples[ART_VARIANT_LARGE] < 2 || p->samples[ART_VARIANT_SMALL] < 2) {
+        return (p->samples[ART_VARIANT_SMALL] < p->samples[ART_VARIANT_LARGE])
+            ? ART_VARIANT_SMALL : ART_VARIANT_LARGE;
+    }
+
+    ArtVariant best =
+        ((uint64_t)p->avg_ms[ART_VARIANT_SMALL] * 100 <
+         (uint64_t)p->avg_ms[ART_VARIANT_LARGE] * p->small_max_cost_pct)
+        ? ART_VARIANT_SMALL : ART_VARIANT_LARGE;
+
+    if (p->covers % ART_PLAN_EXPLORE == 0) {
+        return (best == ART_VARIANT_SMALL) ? ART_VARIANT_LARGE : ART_VARIANT_SMALL;
+    }
+    return best;
+}
+
+void art_plan_record(ArtPlan *p, ArtVariant v, uint32_t ms) {
+    if (v >= ART_VARIANT_COUNT) return;
+    // First sample seeds the average; after that weight the new one 1/4.
+    p->avg_ms[v] = (p->samples[v] == 0) ? ms : (p->avg_ms[v] * 3 + ms) / 4;
+    p->samples[v]++;
+}
+
+bool art_plan_variant_url(const char *url, ArtVariant v, char *out, size_t out_len) {
+    if (!url || v >= ART_VARIANT_COUNT) return false;
+
+    const size_t base = strlen(SPOTIFY_IMAGE_BASE);
+    if (strncmp(url, SPOTIFY_IMAGE_BASE, base) != 0) return false;
+
+    const char *code = url + base;
+    size_t len = strlen(url);
+    if (len < base + SIZE_CODE_LEN || len + 1 > out_len) return false;
+
+    bool known = strncmp(code, kThumbCode, SIZE_CODE_LEN) == 0;
+    for (int i = 0; i < ART_VARIANT_COUNT; i++) {
+        if (strncmp(code, kSizeCode[i], SIZE_CODE_LEN) == 0) known = true;
+    }
+    if (!known) return false;
+
+    memcpy(out, url, len + 1);
+    memcpy(out + base, kSizeCode[v], SIZE_CODE_LEN);
+    return true;
+}
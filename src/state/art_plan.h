@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Album-art fetch planner.
+ *
+ * Spotify serves every cover at 640, 300 and 64 px under URLs that differ
+ * only in a size code.  The 640 px image is decoded 1:1 and centre-cropped;
+ * the 300 px one is a fraction of the bytes and IDCT work but its crop has
+ * to be upscaled ~2×.  Which is faster end-to-end depends on the link and
+ * the CDN as much as on the CPU, so the planner measures instead of
+ * guessing: it keeps a moving average of fetch + decode time per variant
+ * and picks the large image unless the small one is clearly cheaper
+ * (ART_SMALL_MAX_COST_PCT of the large one).  Every ART_PLAN_EXPLORE-th
+ * cover re-samples the other variant so the averages follow the network.
+ *
+ * No Arduino or FreeRTOS dependencies.  Not thread-safe; artTask owns it.
+ */
+
+typedef enum {
+    ART_VARIANT_LARGE = 0,   // 640 px — decoded 1:1
+    ART_VARIANT_SMALL,       // 300 px — crop upscaled to the canvas
+    ART_VARIANT_COUNT
+} ArtVariant;
+
+#define ART_PLAN_EXPLORE 16
+
+typedef struct {
+    uint32_t avg_ms[ART_VARIANT_COUNT];   // moving average cost per cover
+    uint32_t samples[ART_VARIANT_COUNT];
+    uint32_t covers;                      // art_plan_choose() calls
+    uint32_t small_max_cost_pct;          // small wins below this % of large
+} ArtPlan;
+
+void art_plan_init(ArtPlan *p, uint32_t small_max_cost_pct);
+
+/** Variant to fetch for the next cover. */
+ArtVariant art_plan_choose(ArtPlan *p);
+
+/** Report the fetch + decode time of a cover fetched as variant v. */
+void art_plan_record(ArtPlan *p, ArtVariant v, uint32_t ms);
+
+/**
+ * Rewrite a Spotify cover URL (any size) to variant v.  Returns false, and
+ * leaves out untouched, if url is not a recognised Spotify image URL.
+ */
+bool art_plan_variant_url(const char *url, ArtVariant v, char *out, size_t out_len);
@@ -0,0 +1,235 @@
+#include "art_store.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// Index format (little-endian, as laid out in memory on ESP32 and x86)
+// ---------------------------------------------------------------------------
+
+#define INDEX_NAME  "index.bin"
+#define INDEX_TMP   "index.tmp"
+#define INDEX_MAGIC 0x43545241u   // "ARTC"
+#define INDEX_VER   1u
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t seq;
+    uint32_t checksum;   // FNV-1a over the entries that follow
+} IndexHeader;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static uint32_t checksum(const void *data, size_t len) {
+    uint32_t h = 0x811c9dc5u;
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
+static void file_name(uint64_t key, char out[24]) {
+    snprintf(out, 24, "%016llx.jpg", (unsigned long long)key);
+}
+
+static int find(const ArtStore *s, uint64_t key) {
+    for (int i = 0; i < s->count; i++) {
+        if (s->entries[i].key == key) return i;
+    }
+    return -1;
+}
+
+// Remove entry i from the table (not from the filesystem).
+static void forget(ArtStore *s, int i) {
+    s->used -= s->entries[i].size;
+    s->entries[i] = s->entries[--s->count];
+}
+
+static void remove_file(ArtStore *s, uint64_t key) {
+    char name[24];
+    file_name(key, name);
+    s->fs->remove(s->fs->ctx, name);
+}
+
+static bool write_index(ArtStore *s) {
+    unsigned char buf[sizeof(IndexHeader) + sizeof(s->entries)];
+    IndexHeader h;
+    h.magic    = INDEX_MAGIC;
+    h.version  = INDEX_VER;
+    h.count    = (uint32_t)s->count;
+    h.seq      = s->seq;
+    h.checksum = checksum(s->entries, s->count * sizeof(ArtStoreEntry));
+
+    size_t len = sizeof(h) + s->count * sizeof(ArtStoreEntry);
+    memcpy(buf, &h, sizeof(h));
+    memcpy(buf + sizeof(h), s->entries, s->count * sizeof(ArtStoreEntry));
+
+    if (!s->fs->write(s->fs->ctx, INDEX_TMP, buf, len) ||
+        !s->fs->rename(s->fs->ctx, INDEX_TMP, INDEX_NAME)) return false;
+    s->recency_dirty = false;
+    return true;
+}
+
+static bool read_index(ArtStore *s) {
+    long len = s->fs->size(s->fs->ctx, INDEX_NAME);
+    if (len < 0) return true;   // fresh store
+    if (len < (long)sizeof(IndexHeader) ||
+        len > (long)(sizeof(IndexHeader) + sizeof(s->entries))) return false;
+
+    unsigned char buf[sizeof(IndexHeader) + sizeof(s->entries)];
+    if (!s->fs->read(s->fs->ctx, INDEX_NAME, buf, (size_t)len)) return false;
+
+    IndexHeader h;
+    memcpy(&h, buf, sizeof(h));
+    if (h.magic != INDEX_MAGIC || h.version != INDEX_VER) return false;
+    if (h.count > ART_STORE_MAX_ENTRIES ||
+        (size_t)len != sizeof(h) + h.count * sizeof(ArtStoreEntry)) return false;
+    if (checksum(buf + sizeof(h), h.count * sizeof(ArtStoreEntry)) != h.checksum) return false;
+
+    memcpy(s->entries, buf + sizeof(h), h.count * sizeof(ArtStoreEntry));
+    s->count = (int)h.count;
+    s->seq   = h.seq;
+    return true;
+}
+
+// list() callback: delete cover files the index does not name.
+static void sweep_orphan(void *arg, const char *name) {
+    ArtStore *s = (ArtStore *)arg;
+    size_t n = strlen(name);
+    if (n != 20 || strcmp(name + 16, ".jpg") != 0) return;
+    for (int i = 0; i < s->count; i++) {
+        char own[24];
+        file_name(s->entries[i].key, own);
+        if (strcmp(own, name) == 0) return;
+    }
+    s->fs->remove(s->fs->ctx, name);
+}
+
+// Least-recently-used entry index, or -1 if empty.
+static int oldest(const ArtStore *s) {
+    int lru = -1;
+    for (int i = 0; i < s->count; i++) {
+        if (lru < 0 || s->seq - s->entries[i].seq > s->seq - s->entries[lru].seq) lru = i;
+    }
+    return lru;
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+bool art_store_open(ArtStore *s, const ArtStoreFs *fs, size_t budget_bytes) {
+    memset(s, 0, sizeof(*s));
+    s->fs     = fs;
+    s->budget = budget_bytes;
+
+    bool ok = read_index(s);
+    if (!ok) {
+        s->count = 0;
+        s->seq   = 0;
+    }
+
+    // Keep only entries whose file is intact, then fit the (possibly
+    // reduced) budget.
+    bool dirty = !ok;
+    for (int i = 0; i < s->count; ) {
+        char name[24];
+        file_name(s->entries[i].key, name);
+        if (s->entries[i].key == 0 ||
+            fs->size(fs->ctx, name) != (long)s->entries[i].size) {
+            s->entries[i] = s->entries[--s->count];
+            dirty = true;
+            continue;
+        }
+        s->used += s->entries[i].size;
+        i++;
+    }
+    while (s->used > s->budget) {
+        int lru = oldest(s);
+        remove_file(s, s->entries[lru].key);
+        forget(s, lru);
+        s->evictions++;
+        dirty = true;
+    }
+
+    if (dirty) write_index(s);
+    fs->list(fs->ctx, sweep_orphan, s);
+    return ok;
+}
+
+size_t art_store_size(const ArtStore *s, uint64_t key) {
+    int i = find(s, key);
+    return (i < 0) ? 0 : s->entries[i].size;
+}
+
+bool art_store_load(ArtStore *s, uint64_t key, void *buf, size_t len) {
+    int i = find(s, key);
+    if (i < 0 || s->entries[i].size != len) {
+        s->misses++;
+        return false;
+    }
+
+    char name[24];
+    file_name(key, name);
+    if (!s->fs->read(s->fs->ctx, name, buf, len)) {
+        remove_file(s, key);
+        forget(s, i);
+        write_index(s);
+        s->misses++;
+        return false;
+    }
+
+    s->entries[i].seq = ++s->seq;
+    s->recency_dirty  = true;   // written with the next save or flush
+    s->hits++;
+    return true;
+}
+
+bool art_store_save(ArtStore *s, uint64_t key, const void *jpeg, size_t len) {
+    if (key == 0 || len == 0 || len > s->budget) return false;
+
+    int i = find(s, key);
+    if (i >= 0) forget(s, i);   // same file name — overwritten below
+
+    while (s->count > 0 &&
+           (s->used + len > s->budget || s->count >= ART_STORE_MAX_ENTRIES)) {
+        int lru = oldest(s);
+        remove_file(s, s->entries[lru].key);
+        forget(s, lru);
+        s->evictions++;
+    }
+
+    char name[24];
+    file_name(key, name);
+    if (!s->fs->write(s->fs->ctx, name, jpeg, len)) {
+        s->fs->remove(s->fs->ctx, name);
+        write_index(s);   // evictions above still need recording
+        return false;
+    }
+
+    ArtStoreEntry &e = s->entries[s->count++];
+    e.key   = key;
+    e.size  = (uint32_t)len;
+    e.seq   = ++s->seq;
+    s->used += len;
+    s->writes++;
+    return write_index(s);
+}
+
+bool art_store_flush(ArtStore *s) {
+    return !s->recency_dirty || write_index(s);
+}
+
+uint64_t art_store_latest(const ArtStore *s) {
+    const ArtStoreEntry *best = nullptr;
+    for (int i = 0; i < s->count; i++) {
+        if (!best || s->entries[i].seq - best->seq < 0x80000000u) best = &s->entries[i];
+    }
+    return best ? best->key : 0;
+}
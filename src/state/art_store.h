@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Persistent album-art store — cover JPEGs on flash, surviving reboot/OTA.
+ *
+ * Layout inside the store root:
+ *   index.bin          header + one ArtStoreEntry per cover (see below)
+ *   <key as 16 hex>.jpg the JPEG bytes exactly as fetched
+ *
+ * The index is rewritten through index.tmp + rename, and a cover file is
+ * always complete before the index names it, so a power cut leaves either
+ * the old or the new index.  art_store_open() drops entries whose file is
+ * missing or the wrong size and deletes .jpg files the index does not name.
+ * Covers are evicted least-recently-used first to stay within the byte
+ * budget and ART_STORE_MAX_ENTRIES.
+ *
+ * Loads only bump recency in RAM: the index is written when a save or an
+ * eviction changes it, or by art_store_flush(), so showing a stored cover
+ * costs no flash erase.  A power cut loses at most the recency since the
+ * last write.
+ *
+ * Storage goes through ArtStoreFs, so the same code runs on LittleFS on the
+ * device and on a directory on a host.  No Arduino or FreeRTOS
+ * dependencies.  Not thread-safe; artTask owns the store once it starts.
+ */
+
+#define ART_STORE_MAX_ENTRIES 48
+
+/** Minimal file API the store needs.  Names are relative to the store root. */
+typedef struct {
+    void *ctx;
+    long (*size)(void *ctx, const char *name);   // bytes, or -1 if missing
+    bool (*read)(void *ctx, const char *name, void *buf, size_t len);
+    bool (*write)(void *ctx, const char *name, const void *buf, size_t len);  // create / replace
+    bool (*remove)(void *ctx, const char *name);
+    bool (*rename)(void *ctx, const char *from, const char *to);              // replaces `to`
+    void (*list)(void *ctx, void (*cb)(void *arg, const char *name), void *arg);
+} ArtStoreFs;
+
+typedef struct {
+    uint64_t key;   // art_cache_key() of the cover URL
+    uint32_t size;  // JPEG bytes
+    uint32_t seq;   // recency stamp, larger = more recent
+} ArtStoreEntry;
+
+typedef struct {
+    const ArtStoreFs *fs;
+    size_t   budget;  // max JPEG bytes held
+    size_t   used;
+    uint32_t seq;
+    int      count;
+    bool     recency_dirty;  // loads since the index was last written
+    ArtStoreEntry entries[ART_STORE_MAX_ENTRIES];
+
+    // Counters
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t writes;
+    uint32_t evictions;
+} ArtStore;
+
+/**
+ * Load (or start) the store on fs.  Always leaves *s usable; returns false
+ * if an existing index was unreadable and the store started empty.
+ */
+bool art_store_open(ArtStore *s, const ArtStoreFs *fs, size_t budget_bytes);
+
+/** Size of the stored JPEG for key, or 0 if not stored. */
+size_t art_store_size(const ArtStore *s, uint64_t key);
+
+/**
+ * Read the JPEG for key into buf (len must be art_store_size()) and mark it
+ * most recently used.  Counts a hit or a miss.  A cover whose file cannot
+ * be read is dropped.
+ */
+bool art_store_load(ArtStore *s, uint64_t key, void *buf, size_t len);
+
+/**
+ * Store a JPEG under key, replacing any previous copy and evicting LRU
+ * covers to fit.  Returns false if it is larger than the budget or the
+ * write fails.
+ */
+bool art_store_save(ArtStore *s, uint64_t key, const void *jpeg, size_t len);
+
+/**
+ * Write the index if loads have changed recency since it was last written.
+ * Returns false only if a needed write failed.
+ */
+bool art_store_flush(ArtStore *s);
+
+/** Key of the most recently used cover, or 0 if the store is empty. */
+uint64_t art_store_latest(const ArtStore *s);
@@ -0,0 +1,122 @@
+#include "auto_level.h"
+#include "config.h"
+
+#include <math.h>
+#include <string.h>
+
+#define SECOND_MS 1000
+
+// ---------------------------------------------------------------------------
+// Ambient estimate
+// ---------------------------------------------------------------------------
+
+static void start_second(AutoLevel *a, uint32_t now_ms) {
+    a->sec_start_ms = now_ms;
+    a->sec_min_db   = INFINITY;
+    a->sec_gated    = true;
+}
+
+// Fold the finished second into the estimate.
+static void close_second(AutoLevel *a) {
+    if (isinf(a->sec_min_db)) return;   // no blocks arrived
+
+    if (a->sec_gated) {
+        // Speaker silent throughout: the room on its own
+        if (!a->have_noise) {
+            a->noise_db   = a->sec_min_db;
+            a->have_noise = true;
+        } else {
+            a->noise_db += (a->sec_min_db - a->noise_db) / AUTO_LEVEL_AVG_S;
+        }
+        a->slot_count = 0;
+        a->gated_seconds++;
+        return;
+    }
+
+    // Room plus speaker: the minima can only be louder than the room's own,
+    // so their mean bounds the estimate from above.  (The lowest of them
+    // would not: it sits below the averaged floor even in a steady room.)
+    a->slot_db[a->slot_head] = a->sec_min_db;
+    a->slot_head = (uint8_t)((a->slot_head + 1) % AUTO_LEVEL_SLOTS);
+    if (a->slot_count < AUTO_LEVEL_SLOTS) a->slot_count++;
+    if (!a->have_noise || a->slot_count < AUTO_LEVEL_SLOTS) return;
+
+    float sum = 0.0f;
+    for (int i = 0; i < AUTO_LEVEL_SLOTS; i++) sum += a->slot_db[i];
+    float bound = sum / AUTO_LEVEL_SLOTS;
+    if (bound < a->noise_db) a->noise_db = bound;
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+void auto_level_init(AutoLevel *a, uint32_t now_ms) {
+    memset(a, 0, sizeof(*a));
+    a->ref_volume      = -1;
+    a->expected_volume = -1;
+    a->quiet_since_ms  = now_ms;
+    start_second(a, now_ms);
+}
+
+void auto_level_on_block(AutoLevel *a, float rms, bool speaker_quiet, uint32_t now_ms) {
+    if (speaker_quiet && !a->quiet) a->quiet_since_ms = now_ms;
+    a->quiet = speaker_quiet;
+    bool gated = speaker_quiet && now_ms - a->quiet_since_ms >= AUTO_LEVEL_SETTLE_MS;
+
+    if (now_ms - a->sec_start_ms >= SECOND_MS) {
+        close_second(a);
+        start_second(a, now_ms);
+    }
+
+    float db = 20.0f * log10f(rms + 1.0f);
+    if (db < a->sec_min_db) a->sec_min_db = db;
+    if (!gated) a->sec_gated = false;
+    a->blocks++;
+}
+
+int auto_level_target(const AutoLevel *a) {
+    if (!a->have_ref) return -1;
+
+    float diff   = a->noise_db - a->ref_db;
+    int   offset = 0;
+    if (fabsf(diff) > AUTO_LEVEL_DEADBAND_DB) offset = (int)lroundf(diff * AUTO_LEVEL_STEPS_PER_DB);
+    if (offset >  AUTO_LEVEL_RANGE) offset =  AUTO_LEVEL_RANGE;
+    if (offset < -AUTO_LEVEL_RANGE) offset = -AUTO_LEVEL_RANGE;
+
+    // The bounds limit auto-level's moves, not the user's own setting
+    int lo = a->ref_volume < AUTO_LEVEL_VOL_MIN ? a->ref_volume : AUTO_LEVEL_VOL_MIN;
+    int hi = a->ref_volume > AUTO_LEVEL_VOL_MAX ? a->ref_volume : AUTO_LEVEL_VOL_MAX;
+    int target = a->ref_volume + offset;
+    if (target < lo) target = lo;
+    if (target > hi) target = hi;
+    return target;
+}
+
+int auto_level_poll(AutoLevel *a, int volume, bool playing, uint32_t now_ms) {
+    if (volume < 0) return -1;
+
+    if (volume != a->expected_volume) {
+        // Someone else moved it: that is the level they want in this room
+        a->ref_volume      = volume;
+        a->expected_volume = volume;
+        a->ref_db          = a->noise_db;
+        a->have_ref        = a->have_noise;
+        a->hold_until_ms   = now_ms + AUTO_LEVEL_HOLD_MS;
+    } else if (!a->have_ref && a->have_noise) {
+        // Volume was set before the room had been heard
+        a->ref_db   = a->noise_db;
+        a->have_ref = true;
+    }
+
+    int target = auto_level_target(a);
+    if (target < 0 || target == volume || !playing) return -1;
+    if ((int32_t)(now_ms - a->hold_until_ms) < 0) return -1;
+    if (a->nudges > 0 && now_ms - a->last_nudge_ms < AUTO_LEVEL_NUDGE_MS) return -1;
+
+    int next = volume + (target > volume ? 1 : -1);
+    a->expected_volume = next;
+    a->last_nudge_ms   = now_ms;
+    a->nudges++;
+    return next;
+}
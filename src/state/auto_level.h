@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Ambient-noise-compensated volume ("auto-level").
+ *
+ * Ambient estimate: the mic hears the room plus the speaker, so the room is
+ * only measured while the speaker is known to be silent (powered off,
+ * paused or muted) and has been for AUTO_LEVEL_SETTLE_MS.  Block levels are
+ * reduced to one minimum per second, which drops speech and door slams,
+ * and those minima are averaged into the estimate.  While music plays, the
+ * mean of the last AUTO_LEVEL_SLOTS one-second minima can still lower the
+ * estimate (music cannot make the room quieter) but never raise it, so a
+ * room that gets louder mid-track is only noticed at the next pause.
+ *
+ * Volume: whenever the volume changes and it was not auto-level's own
+ * doing — the knob, the KEF app, a remote — that volume becomes the
+ * reference for the ambient level at the time.  From then on the target is
+ * the reference plus AUTO_LEVEL_STEPS_PER_DB steps per dB the room has
+ * risen or fallen (after a AUTO_LEVEL_DEADBAND_DB dead band), at most
+ * AUTO_LEVEL_RANGE steps either way and never outside
+ * AUTO_LEVEL_VOL_MIN..AUTO_LEVEL_VOL_MAX.  The volume moves one step per
+ * AUTO_LEVEL_NUDGE_MS towards it, only while music plays, and not within
+ * AUTO_LEVEL_HOLD_MS of a user change.
+ *
+ * No Arduino or FreeRTOS dependencies — time is passed in, so the policy
+ * runs in a host simulation.  Not thread-safe; controlTask owns it.
+ */
+
+#define AUTO_LEVEL_SLOTS 8    // seconds of music the floor can be lowered from
+
+typedef struct {
+    // Ambient estimate, dB re 1 PCM count RMS
+    float    noise_db;
+    bool     have_noise;
+    bool     quiet;                       // speaker silent at the last block
+    uint32_t quiet_since_ms;
+
+    // One-second minima
+    float    sec_min_db;                  // minimum so far in the current second
+    uint32_t sec_start_ms;
+    bool     sec_gated;                   // every block this second was ambient-only
+    float    slot_db[AUTO_LEVEL_SLOTS];   // minima of the last seconds of music, ring
+    uint8_t  slot_head;
+    uint8_t  slot_count;
+
+    // Reference set by the user
+    int      ref_volume;                  // -1 until the speaker volume is known
+    float    ref_db;
+    bool     have_ref;                    // ref_db is valid
+    int      expected_volume;             // what the speaker should be at
+    uint32_t hold_until_ms;
+    uint32_t last_nudge_ms;
+
+    // Counters
+    uint32_t blocks;
+    uint32_t gated_seconds;               // seconds that updated the estimate
+    uint32_t nudges;
+} AutoLevel;
+
+void auto_level_init(AutoLevel *a, uint32_t now_ms);
+
+/**
+ * One mic block.  rms is the block RMS in PCM counts; speaker_quiet says
+ * whether the speaker is known to be producing nothing (off, paused, muted).
+ */
+void auto_level_on_block(AutoLevel *a, float rms, bool speaker_quiet, uint32_t now_ms);
+
+/**
+ * Volume to send now, or -1.  volume is the speaker's current volume
+ * (-1 if unknown); a value auto-level did not send resets the reference.
+ * Nudges only while playing.
+ */
+int auto_level_poll(AutoLevel *a, int volume, bool playing, uint32_t now_ms);
+
+/** Volume auto-level is steering towards, or -1 without a reference. */
+int auto_level_target(const AutoLevel *a);
@@ -0,0 +1,138 @@
+#include "command_queue.h"
+#include "config.h"
+
+#include <atomic>
+#include <string.h>
+
+static_assert((CMD_QUEUE_LEN & (CMD_QUEUE_LEN - 1)) == 0,
+              "CMD_QUEUE_LEN must be a power of two");
+
+// ---------------------------------------------------------------------------
+// Ring storage
+//
+// s_head is written only by the producer, s_tail only by the consumer; both
+// count up forever and are masked on access, so head - tail is the fill
+// level even across wrap-around.  The release store of an index publishes
+// the slot contents written before it.
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    CmdType  type;
+    uint32_t queued_ms;
+    char     payload[CMD_PAYLOAD_LEN];
+} Cmd;
+
+static Cmd                   s_ring[CMD_QUEUE_LEN];
+static std::atomic<uint32_t> s_head{0};     // next slot to write
+static std::atomic<uint32_t> s_tail{0};     // next slot to read
+static std::atomic<uint32_t> s_dropped{0};
+
+// ---------------------------------------------------------------------------
+// Command names
+// ---------------------------------------------------------------------------
+
+static const struct {
+    const char *name;
+    CmdType     type;
+} kCmdNames[] = {
+    { "pause",    CMD_PLAY_PAUSE   },
+    { "next",     CMD_NEXT         },
+    { "previous", CMD_PREVIOUS     },
+    { "mute",     CMD_MUTE         },
+    { "unmute",   CMD_UNMUTE       },
+    { "power",    CMD_POWER_TOGGLE },
+    { "src_wifi", CMD_SOURCE_WIFI  },
+    { "src_usb",  CMD_SOURCE_USB   },
+    { "pwr_wifi", CMD_WAKE_WIFI    },
+    { "pwr_usb",  CMD_WAKE_USB     },
+};
+
+CmdType cmd_from_string(const char *cmd) {
+    for (const auto &n : kCmdNames) {
+        if (strcmp(cmd, n.name) == 0) return n.type;
+    }
+    return CMD_NONE;
+}
+
+// ---------------------------------------------------------------------------
+// Producer
+// ---------------------------------------------------------------------------
+
+bool cmd_queue_push(CmdType type, uint32_t now_ms, const char *payload) {
+    uint32_t head = s_head.load(std::memory_order_relaxed);
+    uint32_t tail = s_tail.load(std::memory_order_acquire);
+    if (head - tail >= CMD_QUEUE_LEN) {
+        s_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Cmd &c = s_ring[head & (CMD_QUEUE_LEN - 1)];
+    c.type      = type;
+    c.queued_ms = now_ms;
+    if (type == CMD_LIGHT_SET && payload) {
+        strncpy(c.payload, payload, sizeof(c.payload) - 1);
+        c.payload[sizeof(c.payload) - 1] = '\0';
+    } else {
+        c.payload[0] = '\0';
+    }
+
+    s_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Consumer
+// ---------------------------------------------------------------------------
+
+// Fold one command into the batch.
+static void coalesce(const Cmd &c, CmdBatch *b) {
+    switch (c.type) {
+        case CMD_PLAY_PAUSE:   b->play_pause   = !b->play_pause;   break;
+        case CMD_NEXT:         b->skip++;                          break;
+        case CMD_PREVIOUS:     b->skip--;                          break;
+        case CMD_MUTE:         b->mute         = 1;                break;
+        case CMD_UNMUTE:       b->mute         = 0;                break;
+        case CMD_POWER_TOGGLE: b->power_toggle = !b->power_toggle; break;
+        case CMD_SOURCE_WIFI:
+        case CMD_SOURCE_USB:
+        case CMD_WAKE_WIFI:
+        case CMD_WAKE_USB:     b->source       = c.type;           break;
+        case CMD_LIGHT_TOGGLE: b->light_toggle = !b->light_toggle; break;
+        case CMD_LIGHT_SET:
+            memcpy(b->light, c.payload, sizeof(b->light));
+            break;
+        case CMD_NONE:
+            break;
+    }
+}
+
+bool cmd_queue_drain(CmdBatch *out) {
+    out->skip         = 0;
+    out->play_pause   = false;
+    out->mute         = -1;
+    out->power_toggle = false;
+    out->source       = CMD_NONE;
+    out->light_toggle = false;
+    out->light[0]     = '\0';
+    out->queued_ms    = 0;
+
+    uint32_t tail = s_tail.load(std::memory_order_relaxed);
+    uint32_t head = s_head.load(std::memory_order_acquire);
+    if (tail == head) return false;
+
+    out->queued_ms = s_ring[tail & (CMD_QUEUE_LEN - 1)].queued_ms;
+    for (; tail != head; tail++) {
+        coalesce(s_ring[tail & (CMD_QUEUE_LEN - 1)], out);
+    }
+    s_tail.store(tail, std::memory_order_release);
+    return true;
+}
+
+uint32_t cmd_queue_pending() {
+    uint32_t tail = s_tail.load(std::memory_order_relaxed);
+    return s_head.load(std::memory_order_relaxed) - tail;
+}
+
+uint32_t cmd_queue_dropped() {
+    return s_dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Core 1 → Core 0 command queue.
+ *
+ * loop() is the only producer: it pushes one typed command per button tap.
+ * controlTask is the only consumer: it drains everything queued since its
+ * last pass into a CmdBatch, coalescing per command class so a burst of taps
+ * costs at most one HTTP request per class.  The ring is lock-free (one
+ * atomic index per side) and never blocks the LVGL loop.
+ *
+ * Waking controlTask is left to the caller (task notification after a
+ * successful push) so this module stays free of FreeRTOS and builds on a
+ * host compiler.
+ */
+
+typedef enum : uint8_t {
+    CMD_NONE = 0,
+    // Playback (main screen bottom row)
+    CMD_PLAY_PAUSE,
+    CMD_NEXT,
+    CMD_PREVIOUS,
+    CMD_MUTE,
+    CMD_UNMUTE,
+    // Control panel
+    CMD_POWER_TOGGLE,
+    CMD_SOURCE_WIFI,
+    CMD_SOURCE_USB,
+    CMD_WAKE_WIFI,     // power on into WiFi
+    CMD_WAKE_USB,      // power on into USB
+    // Light screen (MQTT)
+    CMD_LIGHT_TOGGLE,
+    CMD_LIGHT_SET,     // payload = JSON for the light /set topic
+} CmdType;
+
+#define CMD_PAYLOAD_LEN 192
+
+/** Commands drained in one pass, coalesced per class. */
+typedef struct {
+    int     skip;                     // net next (+) / previous (-) taps
+    bool    play_pause;               // odd number of play/pause taps
+    int8_t  mute;                     // -1 untouched, else latest: 1 mute / 0 unmute
+    bool    power_toggle;             // odd number of power taps
+    CmdType source;                   // latest source / wake command, CMD_NONE if none
+    bool    light_toggle;             // odd number of light power taps
+    char    light[CMD_PAYLOAD_LEN];   // latest CMD_LIGHT_SET payload, "" if none
+    uint32_t queued_ms;               // push time of the oldest command drained
+} CmdBatch;
+
+/**
+ * Map a UI command string ("pause", "next", "src_usb", "pwr_wifi", ...) to
+ * its CmdType.  Returns CMD_NONE for unknown strings.
+ */
+CmdType cmd_from_string(const char *cmd);
+
+/**
+ * Queue a command (producer side, loop() only).  now_ms is the tap time,
+ * carried through to CmdBatch::queued_ms for latency measurement.  payload
+ * is copied for CMD_LIGHT_SET and ignored otherwise.  Returns false if the
+ * ring is full; the command is dropped and counted.
+ */
+bool cmd_queue_push(CmdType type, uint32_t now_ms, const char *payload = nullptr);
+
+/**
+ * Drain every queued command into *out (consumer side, controlTask only).
+ * Returns false, with *out reset to "nothing to do", if the ring was empty.
+ */
+bool cmd_queue_drain(CmdBatch *out);
+
+/**
+ * Commands queued but not yet drained (either side).  Lets background work
+ * give way while the user is waiting on a command.
+ */
+uint32_t cmd_queue_pending();
+
+/** Commands dropped because the ring was full, since boot. */
+uint32_t cmd_queue_dropped();
@@ -0,0 +1,65 @@
+#include "kef_event_link.h"
+#include "config.h"
+
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+// Lost the queue (or never got one): retry the subscribe after a pause.
+static void go_down(KefEventLink *l, uint32_t now_ms) {
+    l->state    = KEF_LINK_DOWN;
+    l->retry_ms = now_ms + KEF_EVENT_RETRY_MS;
+    if (l->failures < UINT8_MAX) l->failures++;
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+void kef_link_init(KefEventLink *l, uint32_t now_ms) {
+    memset(l, 0, sizeof(*l));
+    l->state    = KEF_LINK_DOWN;
+    l->retry_ms = now_ms;
+}
+
+KefLinkAction kef_link_next(const KefEventLink *l, bool wifi_up, uint32_t now_ms) {
+    if (!wifi_up) return KEF_LINK_WAIT;
+    if (l->state != KEF_LINK_DOWN) return KEF_LINK_POLL;
+    return kef_link_wait_ms(l, now_ms) == 0 ? KEF_LINK_SUBSCRIBE : KEF_LINK_WAIT;
+}
+
+uint32_t kef_link_wait_ms(const KefEventLink *l, uint32_t now_ms) {
+    if (l->state != KEF_LINK_DOWN) return 0;
+    int32_t left = (int32_t)(l->retry_ms - now_ms);
+    return left > 0 ? (uint32_t)left : 0;
+}
+
+void kef_link_on_subscribe(KefEventLink *l, bool ok, uint32_t now_ms) {
+    if (!ok) {
+        go_down(l, now_ms);
+        return;
+    }
+    l->subscribes++;
+    l->state = KEF_LINK_SUBSCRIBED;
+}
+
+void kef_link_on_poll(KefEventLink *l, bool ok, uint32_t now_ms) {
+    if (!ok) {
+        if (l->state != KEF_LINK_DOWN) l->drops++;
+        go_down(l, now_ms);
+        return;
+    }
+    l->polls++;
+    l->failures = 0;
+    l->state    = KEF_LINK_LIVE;
+}
+
+void kef_link_on_wifi_down(KefEventLink *l) {
+    if (l->state == KEF_LINK_LIVE) l->state = KEF_LINK_SUBSCRIBED;
+}
+
+bool kef_link_live(const KefEventLink *l) {
+    return l->state == KEF_LINK_LIVE;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * KEF event queue subscription state.
+ *
+ * kefEventTask asks what to do next and reports each outcome back:
+ *   down        — no queue id: subscribe, or wait out KEF_EVENT_RETRY_MS
+ *                 after a failure
+ *   subscribed  — queue id held but no poll reply yet: long-poll
+ *   live        — a poll reply has shown the queue is being serviced:
+ *                 keep long-polling
+ * A failed poll (HTTP error, read timeout, or a reply that is not an event
+ * array — the speaker forgets a queue that is not polled) drops back to
+ * down.  Only live stops stateTask's fallback poll: the queue reports
+ * changes, not state, so polling carries on until the first poll reply
+ * after a (re)subscribe.  Losing WiFi demotes live to subscribed; the next
+ * poll decides whether the queue survived.
+ *
+ * No Arduino or FreeRTOS dependencies — time is passed in, so the
+ * subscribe / expiry / fallback sequence runs under a host test against a
+ * stand-in speaker.  Not thread-safe; kefEventTask owns it.
+ */
+
+typedef enum : uint8_t {
+    KEF_LINK_DOWN = 0,
+    KEF_LINK_SUBSCRIBED,
+    KEF_LINK_LIVE,
+} KefLinkState;
+
+typedef enum : uint8_t {
+    KEF_LINK_WAIT = 0,     // nothing due; sleep kef_link_wait_ms()
+    KEF_LINK_SUBSCRIBE,    // call kef_event_subscribe()
+    KEF_LINK_POLL,         // call kef_event_poll()
+} KefLinkAction;
+
+typedef struct {
+    KefLinkState state;
+    uint32_t retry_ms;     // down: next subscribe not before this
+    uint8_t  failures;     // consecutive failed subscribes / polls
+
+    // Counters
+    uint32_t subscribes;   // successful subscribes
+    uint32_t drops;        // polls that lost the queue
+    uint32_t polls;        // good poll replies
+} KefEventLink;
+
+/** Start down with a subscribe due at once. */
+void kef_link_init(KefEventLink *l, uint32_t now_ms);
+
+/** What to do now.  Nothing is due while WiFi is down. */
+KefLinkAction kef_link_next(const KefEventLink *l, bool wifi_up, uint32_t now_ms);
+
+/** Milliseconds until a subscribe may be tried (0 = now or not down). */
+uint32_t kef_link_wait_ms(const KefEventLink *l, uint32_t now_ms);
+
+/** Outcome of kef_event_subscribe(). */
+void kef_link_on_subscribe(KefEventLink *l, bool ok, uint32_t now_ms);
+
+/** Outcome of kef_event_poll() — ok includes a poll that timed out empty. */
+void kef_link_on_poll(KefEventLink *l, bool ok, uint32_t now_ms);
+
+/** WiFi dropped: events can no longer be trusted to arrive. */
+void kef_link_on_wifi_down(KefEventLink *l);
+
+/** True while events stand in for the state poll. */
+bool kef_link_live(const KefEventLink *l);
@@ -0,0 +1,116 @@
+#include "optimistic_state.h"
+#include "config.h"
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#else
+#include <mutex>
+#endif
+
+// ---------------------------------------------------------------------------
+// Storage
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    bool      confirmed;    // last value reported by the speaker
+    bool      intended;     // user's intent, valid while pending
+    OptStatus status;
+    uint32_t  deadline_ms;  // pending intent rolls back after this
+} OptEntry;
+
+static OptEntry s_fields[OPT_FIELD_COUNT];
+static uint32_t s_rollbacks = 0;
+
+// Held for a handful of loads/stores only.  Three Core 0 tasks of different
+// priorities call in, so on the device this must be a critical section
+// (preemption off) rather than a bare spin: a higher-priority task spinning
+// on a lock held by one it preempted would never let it go.
+#ifdef ARDUINO
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+struct OptLock {
+    OptLock()  { taskENTER_CRITICAL(&s_mux); }
+    ~OptLock() { taskEXIT_CRITICAL(&s_mux); }
+};
+#else
+static std::mutex s_mux;
+
+struct OptLock {
+    OptLock()  { s_mux.lock(); }
+    ~OptLock() { s_mux.unlock(); }
+};
+#endif
+
+static uint32_t timeout_ms(OptField f) {
+    return (f == OPT_POWER) ? OPT_POWER_TIMEOUT_MS : OPT_PENDING_TIMEOUT_MS;
+}
+
+static void roll_back(OptEntry &e) {
+    e.status = OPT_ROLLED_BACK;
+    s_rollbacks++;
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+void opt_reset() {
+    OptLock lock;
+    for (auto &e : s_fields) e = OptEntry{ false, false, OPT_CONFIRMED, 0 };
+    s_fields[OPT_POWER].confirmed = true;   // matches g_power_on's boot value
+    s_rollbacks = 0;
+}
+
+void opt_request(OptField f, bool value, uint32_t now_ms) {
+    OptLock lock;
+    OptEntry &e = s_fields[f];
+    e.intended    = value;
+    e.status      = OPT_PENDING;
+    e.deadline_ms = now_ms + timeout_ms(f);
+}
+
+void opt_confirm(OptField f, bool value, uint32_t now_ms) {
+    (void)now_ms;
+    OptLock lock;
+    OptEntry &e = s_fields[f];
+    e.confirmed = value;
+    if (e.status == OPT_PENDING) {
+        if (value == e.intended) e.status = OPT_CONFIRMED;
+    } else {
+        e.status = OPT_CONFIRMED;
+    }
+}
+
+void opt_fail(OptField f) {
+    OptLock lock;
+    OptEntry &e = s_fields[f];
+    if (e.status == OPT_PENDING) roll_back(e);
+}
+
+bool opt_tick(uint32_t now_ms) {
+    OptLock lock;
+    bool changed = false;
+    for (auto &e : s_fields) {
+        if (e.status == OPT_PENDING && (int32_t)(now_ms - e.deadline_ms) > 0) {
+            roll_back(e);
+            changed |= (e.intended != e.confirmed);
+        }
+    }
+    return changed;
+}
+
+bool opt_value(OptField f) {
+    OptLock lock;
+    const OptEntry &e = s_fields[f];
+    return (e.status == OPT_PENDING) ? e.intended : e.confirmed;
+}
+
+OptStatus opt_status(OptField f) {
+    OptLock lock;
+    return s_fields[f].status;
+}
+
+uint32_t opt_rollbacks() {
+    OptLock lock;
+    return s_rollbacks;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Optimistic UI state for the on/off controls.
+ *
+ * A tap records the intended value (opt_request) and the screen shows it on
+ * the next frame.  Core 0 then reconciles: a speaker readback matching
+ * the intent confirms it (opt_confirm); a failed command (opt_fail) or no
+ * matching readback within the field's timeout rolls the field back to the
+ * last value the speaker reported.  Readbacks that disagree with a pending
+ * intent are taken as stale and only update the fallback value.
+ *
+ * Volume is not here — the encoder target (g_volume_target) is already
+ * optimistic and the volume scheduler reconciles it.
+ *
+ * Safe to call from any task on either core: every call is a short
+ * critical section (portMUX on the device, a std::mutex in host builds).
+ * No Arduino dependencies; time is passed in.
+ */
+
+typedef enum : uint8_t {
+    OPT_MUTE = 0,
+    OPT_PLAYING,
+    OPT_SOURCE_USB,
+    OPT_POWER,
+    OPT_FIELD_COUNT
+} OptField;
+
+typedef enum : uint8_t {
+    OPT_CONFIRMED = 0,   // showing what the speaker reported
+    OPT_PENDING,         // showing the user's intent, awaiting the speaker
+    OPT_ROLLED_BACK,     // intent failed; showing the speaker's value again
+} OptStatus;
+
+/** Forget all state (boot, tests). Fields start confirmed as false, power on. */
+void opt_reset();
+
+/** User intent from a tap (Core 1). */
+void opt_request(OptField f, bool value, uint32_t now_ms);
+
+/** Value reported by the speaker — event, poll or Spotify (Core 0). */
+void opt_confirm(OptField f, bool value, uint32_t now_ms);
+
+/** The command carrying the pending intent failed (Core 0). */
+void opt_fail(OptField f);
+
+/**
+ * Roll back intents that have waited longer than their timeout.
+ * Returns true if any field changed what it displays.
+ */
+bool opt_tick(uint32_t now_ms);
+
+/** Value to display: the intent while pending, else the speaker's value. */
+bool opt_value(OptField f);
+
+OptStatus opt_status(OptField f);
+
+/** Rollbacks since boot — lets the UI react to each one. */
+uint32_t opt_rollbacks();
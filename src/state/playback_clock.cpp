@@ -0,0 +1,87 @@
+#include "playback_clock.h"
+#include "config.h"
+
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+// Re-anchor at pos, running in real time from now on.
+static void anchor(PlaybackClock *c, uint32_t pos_ms, uint32_t now_ms) {
+    c->ref_pos_ms = pos_ms;
+    c->ref_ms     = now_ms;
+    c->rate_q16   = PB_CLOCK_RATE_ONE;
+    c->slew_ms    = 0;
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+void pb_clock_init(PlaybackClock *c) {
+    memset(c, 0, sizeof(*c));
+    c->rate_q16 = PB_CLOCK_RATE_ONE;
+}
+
+void pb_clock_reset(PlaybackClock *c, uint32_t pos_ms, uint32_t duration_ms,
+                    bool playing, uint32_t now_ms) {
+    anchor(c, pos_ms, now_ms);
+    c->duration_ms = duration_ms;
+    c->playing     = playing;
+}
+
+void pb_clock_sync(PlaybackClock *c, uint32_t pos_ms, uint32_t duration_ms,
+                   bool playing, uint32_t now_ms) {
+    uint32_t predicted = pb_clock_position_ms(c, now_ms);
+    int32_t  err       = (int32_t)(pos_ms - predicted);
+    c->syncs++;
+    c->last_error_ms = err;
+
+    bool snap = !playing || !c->playing || duration_ms != c->duration_ms ||
+                err > PLAYBACK_SNAP_MS || err < -PLAYBACK_SNAP_MS;
+    if (snap) {
+        c->snaps++;
+        pb_clock_reset(c, pos_ms, duration_ms, playing, now_ms);
+        return;
+    }
+
+    // Continue from where the bar is now and absorb the error over the
+    // slew window: the snap limit keeps the rate within 1 ± SNAP/SLEW.
+    c->ref_pos_ms = predicted;
+    c->ref_ms     = now_ms;
+    c->slew_ms    = PLAYBACK_SLEW_MS;
+    int64_t delta = (int64_t)err * PB_CLOCK_RATE_ONE;
+    delta += (delta >= 0 ? PLAYBACK_SLEW_MS : -PLAYBACK_SLEW_MS) / 2;   // round to nearest
+    c->rate_q16   = PB_CLOCK_RATE_ONE + (int32_t)(delta / PLAYBACK_SLEW_MS);
+}
+
+void pb_clock_set_playing(PlaybackClock *c, bool playing, uint32_t now_ms) {
+    if (playing == c->playing) return;
+    anchor(c, pb_clock_position_ms(c, now_ms), now_ms);
+    c->playing = playing;
+}
+
+void pb_clock_set_duration(PlaybackClock *c, uint32_t duration_ms) {
+    c->duration_ms = duration_ms;
+}
+
+uint32_t pb_clock_position_ms(const PlaybackClock *c, uint32_t now_ms) {
+    uint64_t pos = c->ref_pos_ms;
+    if (c->playing) {
+        uint32_t dt = now_ms - c->ref_ms;
+        if (dt <= c->slew_ms) {
+            pos += (uint64_t)dt * (uint32_t)c->rate_q16 / PB_CLOCK_RATE_ONE;
+        } else {
+            pos += (uint64_t)c->slew_ms * (uint32_t)c->rate_q16 / PB_CLOCK_RATE_ONE +
+                   (dt - c->slew_ms);
+        }
+    }
+    if (c->duration_ms > 0 && pos > c->duration_ms) pos = c->duration_ms;
+    return (uint32_t)pos;
+}
+
+int pb_clock_permille(const PlaybackClock *c, uint32_t now_ms) {
+    if (c->duration_ms == 0) return 0;
+    return (int)((uint64_t)pb_clock_position_ms(c, now_ms) * 1000 / c->duration_ms);
+}
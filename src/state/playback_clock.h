@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Playback clock — the track position between server reports.
+ *
+ * Holds a reference position, the millis() it was taken at, a rate and a
+ * playing flag; the position at any time is extrapolated from those, so
+ * the UI can read it every frame and the progress bar moves smoothly
+ * without a network request.  Shared by the KEF and Spotify paths: the
+ * KEF API has no position at all (the clock only starts, stops and resets
+ * on track changes), Spotify reports one with every poll.
+ *
+ * When a fresh server position disagrees with the extrapolation by a
+ * little (network latency, clock drift) the clock slews: it runs slightly
+ * fast or slow for PLAYBACK_SLEW_MS so the bar never jumps or runs
+ * backwards.  A larger disagreement (seek, track change) snaps.
+ *
+ * No Arduino or FreeRTOS dependencies — time is passed in, so it runs
+ * under a host test with a fake clock.  Not thread-safe; main.cpp guards
+ * the shared instance with a critical section.
+ */
+
+#define PB_CLOCK_RATE_ONE 65536   // rate_q16 for real time
+
+typedef struct {
+    uint32_t ref_pos_ms;   // position at ref_ms
+    uint32_t ref_ms;       // millis() of the reference point
+    uint32_t duration_ms;  // 0 = unknown
+    int32_t  rate_q16;     // clock speed during the slew (PB_CLOCK_RATE_ONE = real time)
+    uint32_t slew_ms;      // how long after ref_ms rate_q16 applies; real time after
+    bool     playing;
+
+    // Counters
+    uint32_t syncs;        // server positions applied
+    uint32_t snaps;        // ...of which jumped rather than slewed
+    int32_t  last_error_ms;// server minus extrapolated position at the last sync
+} PlaybackClock;
+
+/** Stopped at 0, duration unknown. */
+void pb_clock_init(PlaybackClock *c);
+
+/** Jump to a known position (new track, seek, nothing playing). */
+void pb_clock_reset(PlaybackClock *c, uint32_t pos_ms, uint32_t duration_ms,
+                    bool playing, uint32_t now_ms);
+
+/**
+ * A server-reported position taken at now_ms.  Small errors are slewed out
+ * over PLAYBACK_SLEW_MS; errors over PLAYBACK_SNAP_MS, a play/pause change
+ * or a new duration snap.
+ */
+void pb_clock_sync(PlaybackClock *c, uint32_t pos_ms, uint32_t duration_ms,
+                   bool playing, uint32_t now_ms);
+
+/** Start or stop at the current estimate, with no server position (KEF). */
+void pb_clock_set_playing(PlaybackClock *c, bool playing, uint32_t now_ms);
+
+/** Track length, when it becomes known after the reset. */
+void pb_clock_set_duration(PlaybackClock *c, uint32_t duration_ms);
+
+/** Estimated position, capped at the duration. */
+uint32_t pb_clock_position_ms(const PlaybackClock *c, uint32_t now_ms);
+
+/** Estimated position in thousandths of the track, 0 if the duration is unknown. */
+int pb_clock_permille(const PlaybackClock *c, uint32_t now_ms);
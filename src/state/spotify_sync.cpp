@@ -0,0 +1,82 @@
+#include "spotify_sync.h"
+#include "config.h"
+
+#include <string.h>
+
+#define SP_SYNC_CONFIRM_POLLS 3   // follow-ups after a command
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+// Schedule the next poll for after a response, honouring a pending command
+// confirmation before the state's own interval.
+static void schedule(SpotifySync *s, uint32_t interval_ms, uint32_t now_ms) {
+    if (s->confirm_left > 0) {
+        s->confirm_left--;
+        if (interval_ms > SPOTIFY_POLL_CONFIRM_MS) interval_ms = SPOTIFY_POLL_CONFIRM_MS;
+    }
+    s->next_poll_ms = now_ms + interval_ms;
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+void sp_sync_init(SpotifySync *s, uint32_t now_ms) {
+    memset(s, 0, sizeof(*s));
+    s->state        = SP_SYNC_UNKNOWN;
+    s->next_poll_ms = now_ms;
+}
+
+uint32_t sp_sync_wait_ms(const SpotifySync *s, uint32_t now_ms) {
+    int32_t left = (int32_t)(s->next_poll_ms - now_ms);
+    return left > 0 ? (uint32_t)left : 0;
+}
+
+void sp_sync_on_track(SpotifySync *s, bool playing, uint32_t progress_ms,
+                      uint32_t duration_ms, uint32_t now_ms) {
+    s->polls++;
+    s->failures    = 0;
+    s->state       = playing ? SP_SYNC_PLAYING : SP_SYNC_PAUSED;
+    s->progress_ms = progress_ms;
+    s->duration_ms = duration_ms;
+
+    if (!playing) {
+        schedule(s, SPOTIFY_POLL_PAUSED_MS, now_ms);
+        return;
+    }
+
+    uint32_t interval = SPOTIFY_POLL_PLAYING_MS;
+    if (duration_ms > progress_ms) {
+        uint32_t to_end = duration_ms - progress_ms + SPOTIFY_POLL_END_MARGIN_MS;
+        if (to_end <= interval) {
+            interval = to_end;
+            s->track_end_polls++;
+        }
+    }
+    schedule(s, interval, now_ms);
+}
+
+void sp_sync_on_nothing(SpotifySync *s, uint32_t now_ms) {
+    s->polls++;
+    s->failures    = 0;
+    s->state       = SP_SYNC_NOTHING;
+    s->progress_ms = 0;
+    s->duration_ms = 0;
+    schedule(s, SPOTIFY_POLL_IDLE_MS, now_ms);
+}
+
+void sp_sync_on_error(SpotifySync *s, uint32_t now_ms) {
+    s->polls++;
+    if (s->failures < 31) s->failures++;
+    uint32_t backoff = SPOTIFY_POLL_RETRY_MS;
+    for (uint8_t i = 1; i < s->failures && backoff < SPOTIFY_POLL_IDLE_MS; i++) backoff *= 2;
+    if (backoff > SPOTIFY_POLL_IDLE_MS) backoff = SPOTIFY_POLL_IDLE_MS;
+    schedule(s, backoff, now_ms);
+}
+
+void sp_sync_on_command(SpotifySync *s, uint32_t now_ms) {
+    s->next_poll_ms = now_ms;
+    s->confirm_left = SP_SYNC_CONFIRM_POLLS;
+}
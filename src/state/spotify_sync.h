@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Spotify now-playing poll scheduler.
+ *
+ * Polling currently-playing every second is mostly wasted: while a track
+ * plays its position follows the clock.  The scheduler predicts the end of
+ * the track from the last reported progress and decides when the next
+ * HTTPS poll is worth making (the progress bar itself runs from the
+ * playback clock, state/playback_clock.h):
+ *   playing  — just after the predicted end of the track, and at least
+ *              every SPOTIFY_POLL_PLAYING_MS to catch changes made on
+ *              another device (skip, seek, pause from the phone)
+ *   paused   — every SPOTIFY_POLL_PAUSED_MS
+ *   nothing  — every SPOTIFY_POLL_IDLE_MS (HTTP 204, no active session)
+ *   error    — SPOTIFY_POLL_RETRY_MS, doubling per failure up to the idle
+ *              interval
+ * A user command polls at once, then follows up SPOTIFY_POLL_CONFIRM_MS
+ * apart a few times, since Spotify can report the old state for a moment
+ * after accepting a command.
+ *
+ * No Arduino or FreeRTOS dependencies — time is passed in, so the policy
+ * runs under a host test with a fake clock.  Not thread-safe; spotifyTask
+ * owns it.
+ */
+
+typedef enum : uint8_t {
+    SP_SYNC_UNKNOWN = 0,   // not polled yet
+    SP_SYNC_PLAYING,
+    SP_SYNC_PAUSED,
+    SP_SYNC_NOTHING,       // HTTP 204
+} SpotifySyncState;
+
+typedef struct {
+    SpotifySyncState state;
+    uint32_t next_poll_ms;     // poll due at or after this time
+    uint32_t progress_ms;      // position reported by the last good poll
+    uint32_t duration_ms;      // 0 = unknown
+    uint8_t  failures;         // consecutive failed polls
+    uint8_t  confirm_left;     // follow-up polls still owed to a command
+
+    // Counters
+    uint32_t polls;
+    uint32_t track_end_polls;  // polls scheduled by the predicted track end
+} SpotifySync;
+
+/** Start unknown with a poll due at now_ms. */
+void sp_sync_init(SpotifySync *s, uint32_t now_ms);
+
+/** Milliseconds until the next poll is due (0 = poll now). */
+uint32_t sp_sync_wait_ms(const SpotifySync *s, uint32_t now_ms);
+
+/** A poll returned track data. */
+void sp_sync_on_track(SpotifySync *s, bool playing, uint32_t progress_ms,
+                      uint32_t duration_ms, uint32_t now_ms);
+
+/** A poll returned HTTP 204 — nothing playing. */
+void sp_sync_on_nothing(SpotifySync *s, uint32_t now_ms);
+
+/** A poll failed (network, auth or parse error). State is kept. */
+void sp_sync_on_error(SpotifySync *s, uint32_t now_ms);
+
+/**
+ * The user did something that changes playback (a command, or switching
+ * to the USB source): poll now and confirm with a few follow-ups.
+ */
+void sp_sync_on_command(SpotifySync *s, uint32_t now_ms);
+
@@ -0,0 +1,135 @@
+#include "volume_scheduler.h"
+#include "config.h"
+
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static uint32_t clamp_gap(uint32_t gap) {
+    if (gap < VOLUME_GAP_MIN_MS) return VOLUME_GAP_MIN_MS;
+    if (gap > VOLUME_GAP_MAX_MS) return VOLUME_GAP_MAX_MS;
+    return gap;
+}
+
+// The send was dropped by the speaker: back off past the spacing that
+// failed and queue the target again unless a newer one is already waiting
+// or it has been retried enough.
+static void reject(VolumeScheduler *s) {
+    uint32_t spacing = s->has_sent ? s->last_send_ms - s->prev_send_ms : s->gap_ms;
+    if (spacing > s->reject_floor_ms) s->reject_floor_ms = spacing;
+
+    uint32_t widened = s->gap_ms + s->gap_ms / 2;
+    if (widened < s->reject_floor_ms + VOLUME_GAP_STEP_MS)
+        widened = s->reject_floor_ms + VOLUME_GAP_STEP_MS;
+    s->gap_ms = clamp_gap(widened);
+
+    if (s->pending < 0) {
+        if (s->retries < VOLUME_MAX_RETRIES) {
+            s->pending = s->last_target;
+            s->retries++;
+        } else {
+            s->dropped++;
+        }
+    }
+    s->n_unconfirmed = 0;
+    s->rejected++;
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+void vol_sched_init(VolumeScheduler *s, uint32_t initial_gap_ms) {
+    memset(s, 0, sizeof(*s));
+    s->gap_ms      = clamp_gap(initial_gap_ms);
+    s->pending     = -1;
+    s->last_target = -1;
+    s->speaker     = -1;
+    s->before      = -1;
+}
+
+void vol_sched_set_target(VolumeScheduler *s, int volume) {
+    if (s->pending >= 0 && s->pending != volume) s->coalesced++;
+    s->pending     = volume;
+    s->last_target = volume;
+    s->retries     = 0;
+}
+
+uint32_t vol_sched_wait_ms(const VolumeScheduler *s, uint32_t now_ms) {
+    if (s->pending < 0) return UINT32_MAX;
+    if (!s->has_sent) return 0;
+    uint32_t since = now_ms - s->last_send_ms;
+    return (since >= s->gap_ms) ? 0 : s->gap_ms - since;
+}
+
+int vol_sched_poll(VolumeScheduler *s, uint32_t now_ms) {
+    if (vol_sched_wait_ms(s, now_ms) != 0) return -1;
+
+    int v = s->pending;
+    s->pending      = -1;
+    s->prev_send_ms = s->has_sent ? s->last_send_ms : now_ms - s->gap_ms;
+    s->last_send_ms = now_ms;
+    s->has_sent     = true;
+    s->sends++;
+    return v;
+}
+
+void vol_sched_on_sent(VolumeScheduler *s, int volume, bool ok, uint32_t now_ms) {
+    if (!ok) {
+        reject(s);
+        return;
+    }
+    // Newest first; the oldest unconfirmed value falls off the end
+    if (s->n_unconfirmed == 0) s->before = s->speaker;
+    if (s->n_unconfirmed < VOL_SCHED_HISTORY) s->n_unconfirmed++;
+    memmove(&s->unconfirmed[1], &s->unconfirmed[0],
+            (s->n_unconfirmed - 1) * sizeof(s->unconfirmed[0]));
+    s->unconfirmed[0]       = volume;
+    s->confirm_deadline_ms  = now_ms + VOLUME_CONFIRM_MS;
+}
+
+bool vol_sched_on_readback(VolumeScheduler *s, int volume, uint32_t now_ms) {
+    s->speaker = volume;
+    if (s->n_unconfirmed == 0) return false;
+    if ((int32_t)(now_ms - s->confirm_deadline_ms) > 0) {
+        // No verdict in time — leave the gap where it is.
+        s->n_unconfirmed = 0;
+        return false;
+    }
+
+    if (volume == s->unconfirmed[0]) {
+        // Latest send landed: probe a little faster, but stay clear of the
+        // widest spacing the speaker has rejected.  The floor decays so one
+        // bad moment does not pin the gap forever.
+        uint32_t gap = s->gap_ms > VOLUME_GAP_STEP_MS ? s->gap_ms - VOLUME_GAP_STEP_MS : 0;
+        if (s->reject_floor_ms > 0) s->reject_floor_ms--;
+        if (gap < s->reject_floor_ms + VOLUME_GAP_STEP_MS)
+            gap = s->reject_floor_ms + VOLUME_GAP_STEP_MS;
+        s->gap_ms = clamp_gap(gap);
+        s->n_unconfirmed = 0;
+        s->retries       = 0;
+        s->confirmed++;
+        return false;
+    }
+
+    for (uint8_t i = 1; i < s->n_unconfirmed; i++) {
+        if (volume == s->unconfirmed[i]) return false;   // an earlier send, still catching up
+    }
+    if (volume == s->before) {
+        reject(s);                                       // speaker kept its old value
+        return false;
+    }
+
+    // Nothing we sent: someone changed it elsewhere, and they win
+    s->pending       = -1;
+    s->n_unconfirmed = 0;
+    s->external++;
+    return true;
+}
+
+bool vol_sched_busy(const VolumeScheduler *s, uint32_t now_ms) {
+    if (s->pending >= 0) return true;
+    return s->n_unconfirmed > 0 && (int32_t)(now_ms - s->confirm_deadline_ms) <= 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Volume send scheduler.
+ *
+ * The KEF drops volume writes that arrive too soon after the previous one.
+ * Rather than a fixed debounce, the scheduler keeps a send spacing (gap_ms)
+ * and learns it from the speaker: a readback that confirms the last value
+ * sent shrinks the gap a step; a readback showing some other value, or a
+ * failed request, marks the send as rejected, widens the gap past the
+ * spacing that failed and re-queues the target — at most
+ * VOLUME_MAX_RETRIES times, so an unreachable speaker does not tie up the
+ * control task.  A readback showing the speaker's value from before the
+ * send is a rejection; one matching nothing recently sent is a change made
+ * elsewhere (app, remote), which wins and drops the target.
+ *
+ * The first change after an idle period goes out immediately (leading
+ * edge); changes made while the gap is running are coalesced and only the
+ * latest is sent when it expires (trailing edge).
+ *
+ * No Arduino or FreeRTOS dependencies — time is passed in, so the same code
+ * runs against a simulated speaker on a host.  Not thread-safe; main.cpp
+ * serialises the control task (sends) and the state task (readbacks).
+ */
+
+#define VOL_SCHED_HISTORY 4
+
+typedef struct {
+    uint32_t gap_ms;           // current minimum spacing between send starts
+    uint32_t reject_floor_ms;  // widest spacing seen rejected (decays on confirms)
+    int      pending;          // target waiting to go out, -1 if none
+    int      last_target;      // most recent target accepted by set_target
+    uint8_t  retries;          // re-sends of last_target after rejections
+    int      speaker;          // last volume the speaker reported, -1 if none
+    int      before;           // speaker's volume before the unconfirmed sends
+    bool     has_sent;
+    uint32_t last_send_ms;     // start time of the last send
+    uint32_t prev_send_ms;     // start time of the send before that
+
+    // Values sent but not yet confirmed, newest first
+    int      unconfirmed[VOL_SCHED_HISTORY];
+    uint8_t  n_unconfirmed;
+    uint32_t confirm_deadline_ms;
+
+    // Counters
+    uint32_t sends;
+    uint32_t confirmed;
+    uint32_t rejected;
+    uint32_t dropped;          // targets given up after VOLUME_MAX_RETRIES
+    uint32_t external;         // readbacks taken as changes made elsewhere
+    uint32_t coalesced;        // targets replaced before they were sent
+} VolumeScheduler;
+
+void vol_sched_init(VolumeScheduler *s, uint32_t initial_gap_ms);
+
+/** New target from the encoder. Replaces any target not yet sent. */
+void vol_sched_set_target(VolumeScheduler *s, int volume);
+
+/**
+ * Volume to send now, or -1 if nothing is due.  The caller must report the
+ * outcome with vol_sched_on_sent() before polling again.
+ */
+int vol_sched_poll(VolumeScheduler *s, uint32_t now_ms);
+
+/** Milliseconds until a pending target may be sent (0 = now, UINT32_MAX = nothing pending). */
+uint32_t vol_sched_wait_ms(const VolumeScheduler *s, uint32_t now_ms);
+
+/** Outcome of the send returned by the last vol_sched_poll(). */
+void vol_sched_on_sent(VolumeScheduler *s, int volume, bool ok, uint32_t now_ms);
+
+/**
+ * Volume reported by the speaker (event or poll).  Returns true if it was a
+ * change made elsewhere, which replaces any target still queued.
+ */
+bool vol_sched_on_readback(VolumeScheduler *s, int volume, uint32_t now_ms);
+
+/** True while a target is queued or a send awaits confirmation. */
+bool vol_sched_busy(const VolumeScheduler *s, uint32_t now_ms);
@@ -0,0 +1,67 @@
+#include "art_blend.h"
+
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// One pixel, all channels at once
+//
+// Spread RGB565 as 00000GGGGGG00000RRRRR000000BBBBB.  Each field then has
+// at least 5 spare bits above it, so a * (32 - w) + b * w (at most
+// 63 * 32) never carries into the next field, and >> 5 followed by the
+// mask drops exactly the fractional bits of each channel.
+// ---------------------------------------------------------------------------
+
+#define SPREAD_MASK 0x07E0F81Fu
+
+static inline uint32_t blend_px(uint32_t a, uint32_t b, uint32_t w) {
+    uint32_t sa = (a | (a << 16)) & SPREAD_MASK;
+    uint32_t sb = (b | (b << 16)) & SPREAD_MASK;
+    uint32_t m  = ((sa * (ART_BLEND_MAX - w) + sb * w) >> 5) & SPREAD_MASK;
+    return (m | (m >> 16)) & 0xFFFFu;
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+void art_blend_rgb565(const uint16_t *a, const uint16_t *b, uint16_t *out,
+                      size_t n, uint32_t w) {
+    if (w > ART_BLEND_MAX) w = ART_BLEND_MAX;
+    size_t i = 0;
+
+    // Pairs need all three pointers on the same 4-byte phase.
+    bool paired = ((((uintptr_t)a ^ (uintptr_t)b) | ((uintptr_t)a ^ (uintptr_t)out)) & 3) == 0;
+    if (paired && ((uintptr_t)a & 2) && n > 0) {
+        out[0] = (uint16_t)blend_px(a[0], b[0], w);
+        i = 1;
+    }
+
+    if (paired) {
+        // memcpy keeps the 32-bit accesses alias-safe; it compiles to l32i/s32i.
+        for (; i + 2 <= n; i += 2) {
+            uint32_t pa, pb;
+            memcpy(&pa, a + i, 4);
+            memcpy(&pb, b + i, 4);
+            uint32_t lo = blend_px(pa & 0xFFFFu, pb & 0xFFFFu, w);
+            uint32_t hi = blend_px(pa >> 16,     pb >> 16,     w);
+            uint32_t po = lo | (hi << 16);
+            memcpy(out + i, &po, 4);
+        }
+    }
+
+    for (; i < n; i++) {
+        out[i] = (uint16_t)blend_px(a[i], b[i], w);
+    }
+}
+
+void art_blend_rgb565_ref(const uint16_t *a, const uint16_t *b, uint16_t *out,
+                          size_t n, uint32_t w) {
+    if (w > ART_BLEND_MAX) w = ART_BLEND_MAX;
+    const uint32_t v = ART_BLEND_MAX - w;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t r  = (((a[i] >> 11) & 0x1F) * v + ((b[i] >> 11) & 0x1F) * w) / ART_BLEND_MAX;
+        uint32_t g  = (((a[i] >> 5)  & 0x3F) * v + ((b[i] >> 5)  & 0x3F) * w) / ART_BLEND_MAX;
+        uint32_t bl = (( a[i]        & 0x1F) * v + ( b[i]        & 0x1F) * w) / ART_BLEND_MAX;
+        out[i] = (uint16_t)((r << 11) | (g << 5) | bl);
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * RGB565 cross-fade kernel.
+ *
+ * Every channel of every pixel becomes
+ *     (a * (32 - w) + b * w) / 32     (integer division, w in 0..32)
+ * so w = 0 gives a and w = 32 gives b exactly.
+ *
+ * art_blend_rgb565() is the fast path: all three channels of a pixel are
+ * blended with one multiply per source (the 0x07E0F81F spread), and pixels
+ * move two per 32-bit load/store to halve PSRAM transactions.  Unaligned
+ * buffers and odd tails fall back to one pixel at a time.
+ * art_blend_rgb565_ref() is the plain per-channel definition; the two are
+ * bit-identical.  Pure C — no Arduino, LVGL or FreeRTOS dependencies.
+ */
+
+#define ART_BLEND_MAX 32   // weight that yields b
+
+void art_blend_rgb565(const uint16_t *a, const uint16_t *b, uint16_t *out,
+                      size_t n, uint32_t w);
+
+void art_blend_rgb565_ref(const uint16_t *a, const uint16_t *b, uint16_t *out,
+                          size_t n, uint32_t w);
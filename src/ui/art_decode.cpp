@@ -0,0 +1,227 @@
+#include "art_decode.h"
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <TJpg_Decoder.h>   // brings in the library's tjpgd
+#include <esp_heap_caps.h>
+#else
+// Native test env: the library's tjpgd.c is built on its own (see
+// scripts/native_tjpgd.py) and the scratch crop comes from the heap.
+#include <tjpgd.h>
+#define heap_caps_malloc(size, caps) malloc(size)
+#endif
+
+// tjpgd work area.  Sized for the fast-decode Huffman tables; jd_prepare()
+// fails with JDR_MEM1 rather than overrunning if it is ever too small.
+#define ART_DECODE_POOL 10240
+
+static uint8_t s_pool[ART_DECODE_POOL] __attribute__((aligned(4)));
+
+// The canvas shows the centre ALBUM_ART_SIZE / ALBUM_ART_JPEG_SRC of the
+// cover (360 of 640 px).  A source at least that large is cropped 1:1 into
+// the frame; a smaller one (Spotify's 300 px variant) has the same region
+// cropped into a scratch buffer and upscaled.
+typedef struct {
+    ArtReadFn     read;
+    void         *ctx;
+    uint16_t     *dst;         // frame, or the scratch crop when scaling
+    int           dst_size;    // crop edge in source px (= dst stride)
+    int           crop_x;      // crop top-left in the source
+    int           crop_y;
+    bool          stopped;     // output() ended the decode below the crop
+    volatile int *rows_done;   // only raised on the 1:1 path
+} DecodeJob;
+
+// ---------------------------------------------------------------------------
+// tjpgd callbacks
+// ---------------------------------------------------------------------------
+
+static size_t job_input(JDEC *jd, uint8_t *buf, size_t len) {
+    DecodeJob *job = (DecodeJob *)jd->device;
+    return job->read(job->ctx, buf, len);
+}
+
+// Copies the part of each decoded MCU block inside the crop into dst.
+//
+// For a 640×640 cover at scale=1 tjpgd passes 16×16 blocks and we keep
+// the centre 360×360:
+//   offset = (ALBUM_ART_JPEG_SRC - ALBUM_ART_SIZE) / 2 = 140 px
+// Blocks arrive in raster order, so the first block below the crop ends
+// the decode — the last 140 rows are never entropy-decoded or IDCT'd.
+static int job_output(JDEC *jd, void *bitmap, JRECT *rect) {
+    DecodeJob *job = (DecodeJob *)jd->device;
+    const uint16_t *px = (const uint16_t *)bitmap;
+
+    const int size = job->dst_size;
+    if (rect->top >= job->crop_y + size) {
+        job->stopped = true;
+        return 0;
+    }
+
+    int x = rect->left;
+    int y = rect->top;
+    int w = rect->right - rect->left + 1;
+    int h = rect->bottom - rect->top + 1;
+
+    for (int row = 0; row < h; row++) {
+        int dst_y = (y + row) - job->crop_y;
+        if (dst_y < 0 || dst_y >= size) continue;
+
+        int src_left  = x;
+        int src_right = x + w;   // exclusive
+        int cl = (src_left  < job->crop_x)        ? job->crop_x        : src_left;
+        int cr = (src_right > job->crop_x + size) ? job->crop_x + size : src_right;
+        int copy_len = cr - cl;
+        if (copy_len <= 0) continue;
+
+        int dst_x   = cl - job->crop_x;
+        int src_off = cl - src_left;
+        memcpy(&job->dst[dst_y * size + dst_x],
+               &px[row * w + src_off],
+               copy_len * sizeof(uint16_t));
+    }
+
+    // Last block of an MCU row: everything above its bottom edge is final.
+    if (job->rows_done && rect->right + 1 >= jd->width) {
+        int done = rect->bottom + 1 - job->crop_y;
+        if (done > size) done = size;
+        if (done > *job->rows_done) *job->rows_done = done;
+    }
+    return 1;
+}
+
+// ---------------------------------------------------------------------------
+// Bilinear upscale — n×n RGB565 crop to the ALBUM_ART_SIZE² frame
+//
+// Pixel centres are aligned (dst d samples src (d + 0.5) * n / N - 0.5),
+// 5-bit weights, all three channels blended at once in one 32-bit word.
+// ---------------------------------------------------------------------------
+
+// Spread RGB565 as 00000GGGGGG00000RRRRR000000BBBBB: each channel gets at
+// least 5 bits of headroom, enough for a multiply by a weight of 0..32.
+static inline uint32_t spread565(uint16_t c) {
+    return ((uint32_t)c | ((uint32_t)c << 16)) & 0x07E0F81Fu;
+}
+
+static inline uint16_t pack565(uint32_t v) {
+    return (uint16_t)((v & 0xF81Fu) | ((v >> 16) & 0x07E0u));
+}
+
+// (a * (32 - f) + b * f) / 32 per channel, f in 0..32.
+static inline uint32_t lerp565(uint32_t a, uint32_t b, uint32_t f) {
+    return ((a * (32 - f) + b * f) >> 5) & 0x07E0F81Fu;
+}
+
+static void upscale_bilinear(const uint16_t *src, int n, uint16_t *dst) {
+    const int N = ALBUM_ART_SIZE;
+    for (int dy = 0; dy < N; dy++) {
+        // 24.8 fixed point source row, clamped to the edge rows.
+        int fy = ((2 * dy + 1) * n * 256) / (2 * N) - 128;
+        if (fy < 0) fy = 0;
+        int y0 = fy >> 8;
+        int y1 = (y0 + 1 < n) ? y0 + 1 : y0;
+        uint32_t wy = (uint32_t)(fy & 0xFF) >> 3;
+
+        const uint16_t *r0 = src + y0 * n;
+        const uint16_t *r1 = src + y1 * n;
+        uint16_t *out = dst + dy * N;
+        for (int dx = 0; dx < N; dx++) {
+            int fx = ((2 * dx + 1) * n * 256) / (2 * N) - 128;
+            if (fx < 0) fx = 0;
+            int x0 = fx >> 8;
+            int x1 = (x0 + 1 < n) ? x0 + 1 : x0;
+            uint32_t wx = (uint32_t)(fx & 0xFF) >> 3;
+
+            uint32_t top = lerp565(spread565(r0[x0]), spread565(r0[x1]), wx);
+            uint32_t bot = lerp565(spread565(r1[x0]), spread565(r1[x1]), wx);
+            out[dx] = pack565(lerp565(top, bot, wy));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Memory source
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const uint8_t *data;
+    size_t         size;
+    size_t         pos;
+} MemSource;
+
+static size_t mem_read(void *ctx, uint8_t *buf, size_t len) {
+    MemSource *m = (MemSource *)ctx;
+    size_t n = m->size - m->pos;
+    if (n > len) n = len;
+    if (buf) memcpy(buf, m->data + m->pos, n);
+    m->pos += n;
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+bool art_decode(ArtReadFn read, void *ctx, uint16_t *frame, volatile int *rows_done) {
+    if (!read || !frame) return false;
+
+    DecodeJob job = {};
+    job.read = read;
+    job.ctx  = ctx;
+    if (rows_done) *rows_done = 0;
+
+    JDEC jd;
+    memset(&jd, 0, sizeof(jd));   // leaves the library's byte-swap option off
+    JRESULT res = jd_prepare(&jd, job_input, s_pool, sizeof(s_pool), &job);
+    if (res != JDR_OK) {
+        DEBUG_PRINTF("[Art] jd_prepare failed (%d)\n", (int)res);
+        return false;
+    }
+
+    // Same framing whatever the source size: the centre 360/640 of it.
+    int edge = (jd.width < jd.height) ? jd.width : jd.height;
+    int crop = (edge * ALBUM_ART_SIZE + ALBUM_ART_JPEG_SRC / 2) / ALBUM_ART_JPEG_SRC;
+    bool scaled = crop < ALBUM_ART_SIZE;
+    if (!scaled) crop = ALBUM_ART_SIZE;
+    if (crop < 1) return false;
+
+    job.dst_size = crop;
+    job.crop_x   = (jd.width  - crop) / 2;
+    job.crop_y   = (jd.height - crop) / 2;
+    if (scaled) {
+        job.dst = (uint16_t *)heap_caps_malloc(crop * crop * sizeof(uint16_t),
+                                               MALLOC_CAP_SPIRAM);
+        if (!job.dst) {
+            DEBUG_PRINTLN("[Art] PSRAM alloc failed for crop");
+            return false;
+        }
+    } else {
+        job.dst       = frame;
+        job.rows_done = rows_done;
+    }
+
+    res = jd_decomp(&jd, job_output, ALBUM_ART_JPEG_SCALE == 1 ? 0 :
+                                     ALBUM_ART_JPEG_SCALE == 2 ? 1 :
+                                     ALBUM_ART_JPEG_SCALE == 4 ? 2 : 3);
+    bool ok = (res == JDR_OK) || (res == JDR_INTR && job.stopped);
+    if (!ok) {
+        DEBUG_PRINTF("[Art] jd_decomp failed (%d)\n", (int)res);
+    } else if (scaled) {
+        upscale_bilinear(job.dst, crop, frame);
+    }
+
+    if (scaled) free(job.dst);
+    if (ok && rows_done) *rows_done = ALBUM_ART_SIZE;
+    return ok;
+}
+
+bool art_decode_jpeg(const uint8_t *jpeg, size_t size, uint16_t *frame,
+                     volatile int *rows_done) {
+    if (!jpeg || size == 0) return false;
+    MemSource m = { jpeg, size, 0 };
+    return art_decode(mem_read, &m, frame, rows_done);
+}
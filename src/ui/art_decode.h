@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Pull-driven album-art decoder.
+ *
+ * Decodes a Spotify cover JPEG straight into an ALBUM_ART_SIZE² RGB565
+ * frame, keeping the centre ALBUM_ART_SIZE / ALBUM_ART_JPEG_SRC of it.  A
+ * 640 px cover is cropped 1:1 and the decode stops below the crop; a
+ * smaller one (the 300 px variant) is cropped the same way and upscaled
+ * bilinearly, so both look framed alike.  Input comes from
+ * a read callback, so the decoder can consume an HTTP body as it arrives
+ * instead of waiting for the whole file.  Not re-entrant: one decode at a
+ * time (artTask, or setup() before the tasks start).
+ */
+
+/**
+ * Read up to len bytes into buf, or skip them if buf is nullptr.  Returns
+ * the number of bytes produced; fewer than len means end of input.
+ */
+typedef size_t (*ArtReadFn)(void *ctx, uint8_t *buf, size_t len);
+
+/**
+ * Decode from read() into frame.  *rows_done (if non-null) is raised as
+ * each MCU row of the crop lands — progress for logging and benchmarks
+ * (time to first row); the caller decodes into a hidden buffer and shows
+ * it only once this returns.  1:1 path only; an upscaled cover reports
+ * all its rows at the end.  Returns true if the whole crop decoded.
+ */
+bool art_decode(ArtReadFn read, void *ctx, uint16_t *frame, volatile int *rows_done);
+
+/** As art_decode(), from a complete JPEG in memory. */
+bool art_decode_jpeg(const uint8_t *jpeg, size_t size, uint16_t *frame,
+                     volatile int *rows_done);
@@ -1,10 +1,14 @@
 #include "main_screen.h"
 #include "config.h"
 #include "../drivers/mic_pdm.h"
+#include "art_decode.h"
+#include "art_blend.h"
+#include "wave_render.h"
 
-#include <TJpg_Decoder.h>
+#include <esp_timer.h>
 #include <math.h>
 #include <string.h>
+#include <atomic>
 
 // ---------------------------------------------------------------------------
 // Widget handles (file-local)
@@ -18,12 +22,20 @@ static lv_obj_t *s_vol_shadow[4]   = {};   // outline: 4 cardinal-offset black l
 static lv_obj_t *s_vol_label       = NULL;
 static lv_obj_t *s_title_label      = NULL;
 static lv_obj_t *s_artist_label     = NULL;
-static lv_obj_t *s_progress_outline = NULL;  // kept but hidden (replaced by waveform)
-static lv_obj_t *s_progress_bar     = NULL;  // kept but hidden (replaced by waveform)
-
-// Waveform visualiser — driven by microphone amplitude in real time
-static lv_obj_t *s_wave_canvas = NULL;
-static uint8_t  *s_wave_buf    = NULL;  // WAVE_CANVAS_W × WAVE_CANVAS_H × 2 bytes (RGB565)
+static lv_obj_t *s_progress_outline = NULL;  // black edge behind the progress line
+static lv_obj_t *s_progress_bar     = NULL;  // track progress, the waveform's centre line
+
+// Waveform visualiser — driven by microphone amplitude in real time.
+// Ping-pong buffers: the wave task draws into the back one while the canvas
+// shows the front; Core 1 only swaps pointers (see main_screen_wave_tick).
+// s_wave_ready is the hand-off: the wave task stores true with release after
+// its pixel writes, Core 1 stores false with release after the swap, and each
+// side loads it with acquire before touching the buffers — the pixels may be
+// in PSRAM, so volatile alone would not order them against the flag.
+static lv_obj_t          *s_wave_canvas = NULL;
+static uint8_t           *s_wave_buf[2] = {};     // WAVE_CANVAS_W × WAVE_CANVAS_H × 3 bytes each
+static std::atomic<int>   s_wave_front{0};        // index of the buffer on the canvas
+static std::atomic<bool>  s_wave_ready{false};    // back buffer holds a finished frame
 
 // Bottom playback control buttons (created on s_screen, below overlays)
 static lv_obj_t *s_btn_mute      = NULL;  // USB source: mute toggle (center)
@@ -55,39 +67,22 @@ static bool      s_standby_visible = false;
 // PSRAM-backed RGB565 buffer for album art (360×360×2 = 259 200 bytes)
 static uint16_t *s_art_buf = NULL;
 
-// ---------------------------------------------------------------------------
-// TJpgDec callback — center-crops the 640×640 JPEG into s_art_buf (360×360)
-//
-// Spotify delivers 640×640 JPEGs. TJpgDec at scale=1 decodes MCU blocks
-// (16×16 px each) and passes each block to this callback. We keep only the
-// center 360×360 region:
-//   offset = (ALBUM_ART_JPEG_SRC - ALBUM_ART_SIZE) / 2 = 140 px
-// ---------------------------------------------------------------------------
-
-static bool art_decode_cb(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *bitmap) {
-    if (!s_art_buf) return false;
-
-    constexpr int CROP = (ALBUM_ART_JPEG_SRC - ALBUM_ART_SIZE) / 2; // = 140
+// Second buffer of the same size: the art pipeline decodes into it while
+// s_art_buf is on screen, then main_screen_swap_art() exchanges the two.
+// Plain pointers: main.cpp's g_art_dirty release/acquire hand-off orders
+// the exchange on Core 1 before artTask reads main_screen_art_back().
+static uint16_t *s_art_back = NULL;
 
-    for (int row = 0; row < (int)h; row++) {
-        int dst_y = (y + row) - CROP;
-        if (dst_y < 0 || dst_y >= ALBUM_ART_SIZE) continue;
+// Third buffer for cross-fades: the blended frames are written here while
+// the old (s_art_buf) and new (s_art_back) frames stay intact as sources.
+static uint16_t *s_art_spare = NULL;
 
-        int src_left  = x;
-        int src_right = x + (int)w;   // exclusive
-        int cl = (src_left  < CROP)               ? CROP               : src_left;
-        int cr = (src_right > CROP + ALBUM_ART_SIZE) ? CROP + ALBUM_ART_SIZE : src_right;
-        int copy_len = cr - cl;
-        if (copy_len <= 0) continue;
-
-        int dst_x   = cl - CROP;
-        int src_off = cl - src_left;
-        memcpy(&s_art_buf[dst_y * ALBUM_ART_SIZE + dst_x],
-               &bitmap[row * w + src_off],
-               copy_len * sizeof(uint16_t));
-    }
-    return true;
-}
+// Cross-fade state.  Pass k of ART_FADE_STEPS - 1 writes every row of
+// s_art_spare at weight k / ART_FADE_STEPS, a time-budgeted band per
+// main_screen_art_tick(); the canvas moves onto s_art_spare once the first
+// pass is complete, and onto the new frame itself at the end.
+static int s_fade_step = 0;   // pass in progress, 0 = not fading
+static int s_fade_row  = 0;   // next row to blend in this pass
 
 // ---------------------------------------------------------------------------
 // Control panel button callbacks
@@ -164,6 +159,10 @@ void main_screen_create() {
     // ---- [1] Background art canvas (full screen, initially hidden) ----
     s_art_buf = (uint16_t *)heap_caps_malloc(
         ALBUM_ART_SIZE * ALBUM_ART_SIZE * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+    s_art_back = (uint16_t *)heap_caps_malloc(
+        ALBUM_ART_SIZE * ALBUM_ART_SIZE * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+    s_art_spare = (uint16_t *)heap_caps_malloc(
+        ALBUM_ART_SIZE * ALBUM_ART_SIZE * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
 
     s_art_canvas = lv_canvas_create(s_screen);
     if (s_art_buf) {
@@ -269,49 +268,53 @@ void main_screen_create() {
     lv_obj_set_style_shadow_ofs_x(s_artist_label, 0, 0);
     lv_obj_set_style_shadow_ofs_y(s_artist_label, 0, 0);
 
-    // ---- [5] Track progress bar — black outline + Spotify-green fill ----
-    // Outline bar (slightly larger, all black) — drawn first so it sits behind.
+    // ---- [5] Track progress — a thin line along the waveform's centre ----
+    // Created before the waveform canvas so the waves draw over it.  Outline
+    // bar (slightly larger, all black) first so it sits behind.
     s_progress_outline = lv_bar_create(s_screen);
-    lv_obj_set_size(s_progress_outline, 206, 16);
-    lv_obj_align(s_progress_outline, LV_ALIGN_CENTER, 0, 81);
+    lv_obj_set_size(s_progress_outline, WAVE_CANVAS_W + 4, 7);
+    lv_obj_align(s_progress_outline, LV_ALIGN_CENTER, 0, 62);
     lv_bar_set_range(s_progress_outline, 0, 100);
     lv_bar_set_value(s_progress_outline, 0, LV_ANIM_OFF);
-    lv_obj_set_style_radius(s_progress_outline, 8, LV_PART_MAIN);
-    lv_obj_set_style_radius(s_progress_outline, 8, LV_PART_INDICATOR);
+    lv_obj_set_style_radius(s_progress_outline, 3, LV_PART_MAIN);
+    lv_obj_set_style_radius(s_progress_outline, 3, LV_PART_INDICATOR);
     lv_obj_set_style_bg_color(s_progress_outline, lv_color_hex(0x000000), LV_PART_MAIN);
     lv_obj_set_style_bg_opa(s_progress_outline, LV_OPA_COVER, LV_PART_MAIN);
     lv_obj_set_style_bg_color(s_progress_outline, lv_color_hex(0x000000), LV_PART_INDICATOR);
     lv_obj_set_style_bg_opa(s_progress_outline, LV_OPA_COVER, LV_PART_INDICATOR);
     lv_obj_clear_flag(s_progress_outline, LV_OBJ_FLAG_CLICKABLE);
 
-    // Main progress bar — centered on the outline, Spotify green fill
+    // Progress line — centred on the outline, same blue as the volume arc
     s_progress_bar = lv_bar_create(s_screen);
-    lv_obj_set_size(s_progress_bar, 200, 10);
-    lv_obj_align(s_progress_bar, LV_ALIGN_CENTER, 0, 81);
-    lv_bar_set_range(s_progress_bar, 0, 100);
+    lv_obj_set_size(s_progress_bar, WAVE_CANVAS_W, 3);
+    lv_obj_align(s_progress_bar, LV_ALIGN_CENTER, 0, 62);
+    lv_bar_set_range(s_progress_bar, 0, 1000);   // permille: moves every frame
     lv_bar_set_value(s_progress_bar, 0, LV_ANIM_OFF);
-    lv_obj_set_style_radius(s_progress_bar, 5, LV_PART_MAIN);
-    lv_obj_set_style_radius(s_progress_bar, 5, LV_PART_INDICATOR);
+    lv_obj_set_style_radius(s_progress_bar, 1, LV_PART_MAIN);
+    lv_obj_set_style_radius(s_progress_bar, 1, LV_PART_INDICATOR);
     lv_obj_set_style_bg_color(s_progress_bar, lv_color_hex(0x1E1E1E), LV_PART_MAIN);
     lv_obj_set_style_bg_opa(s_progress_bar, LV_OPA_COVER, LV_PART_MAIN);
     lv_obj_set_style_bg_color(s_progress_bar, lv_color_hex(0x00BFFF), LV_PART_INDICATOR);
     lv_obj_set_style_bg_opa(s_progress_bar, LV_OPA_COVER, LV_PART_INDICATOR);
     lv_obj_clear_flag(s_progress_bar, LV_OBJ_FLAG_CLICKABLE);
-    // Both progress bar objects are permanently hidden — replaced by the
-    // waveform canvas below.  Kept as objects so existing update logic compiles.
-    lv_obj_add_flag(s_progress_outline, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_add_flag(s_progress_bar,     LV_OBJ_FLAG_HIDDEN);
-
-    // ---- [5b] Waveform visualiser canvas — mic-driven, replaces progress bar ----
-    // Canvas: WAVE_CANVAS_W × WAVE_CANVAS_H px, RGB565, in internal SRAM.
-    // Layer order: sits directly above the progress bar objects (already hidden).
+
+    // ---- [5b] Waveform visualiser canvas — mic-driven, over the progress line ----
+    // Canvas: WAVE_CANVAS_W × WAVE_CANVAS_H px, internal SRAM (PSRAM if short).
+    // Layer order: sits directly above the progress line, whose centre it shares.
     // Bars grow symmetrically from the vertical centre, oldest bar on the left.
     // TRUE_COLOR_ALPHA: 3 bytes/pixel (RGB565 + 8-bit alpha). alpha=0 = transparent.
-    s_wave_buf = (uint8_t *)malloc((size_t)WAVE_CANVAS_W * WAVE_CANVAS_H * 3);
-    if (s_wave_buf) {
-        memset(s_wave_buf, 0, (size_t)WAVE_CANVAS_W * WAVE_CANVAS_H * 3);
+    // Two buffers so the wave task never draws into the one LVGL is reading.
+    const size_t wave_bytes = (size_t)WAVE_CANVAS_W * WAVE_CANVAS_H * 3;
+    for (int i = 0; i < 2; i++) {
+        s_wave_buf[i] = (uint8_t *)malloc(wave_bytes);
+        if (!s_wave_buf[i]) {
+            s_wave_buf[i] = (uint8_t *)heap_caps_malloc(wave_bytes, MALLOC_CAP_SPIRAM);
+        }
+        if (s_wave_buf[i]) memset(s_wave_buf[i], 0, wave_bytes);
+    }
+    if (s_wave_buf[0] && s_wave_buf[1]) {
         s_wave_canvas = lv_canvas_create(s_screen);
-        lv_canvas_set_buffer(s_wave_canvas, s_wave_buf,
+        lv_canvas_set_buffer(s_wave_canvas, s_wave_buf[s_wave_front.load()],
                              WAVE_CANVAS_W, WAVE_CANVAS_H, LV_IMG_CF_TRUE_COLOR_ALPHA);
         lv_obj_set_size(s_wave_canvas, WAVE_CANVAS_W, WAVE_CANVAS_H);
         // y=+62: centred between artist label (bottom ≈ +32) and button row (top ≈ +92).
@@ -516,7 +519,7 @@ void main_screen_create() {
 void main_screen_update(int volume, const char *title,
                         const char *artist, bool is_playing,
                         bool source_is_usb, bool is_muted,
-                        bool spotify_active, int progress_pct) {
+                        bool spotify_active) {
     if (s_screen == NULL) return;
 
     // Cache for button callbacks (Core 1 only)
@@ -530,11 +533,6 @@ void main_screen_update(int volume, const char *title,
         lv_label_set_text_fmt(s_vol_shadow[i], "%d", volume);
     }
 
-    // Progress bars are permanently hidden — replaced by the waveform canvas.
-    // (Already hidden in main_screen_create; kept here defensively.)
-    lv_obj_add_flag(s_progress_outline, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_add_flag(s_progress_bar,     LV_OBJ_FLAG_HIDDEN);
-
     // Waveform canvas: reveal on first state update (stays visible thereafter).
     if (s_wave_canvas) {
         lv_obj_clear_flag(s_wave_canvas, LV_OBJ_FLAG_HIDDEN);
@@ -587,148 +585,217 @@ void main_screen_update(int volume, const char *title,
     }
 }
 
+// ---------------------------------------------------------------------------
+// main_screen_update_progress
+// Called from Core 1 every loop() with the playback clock's position.
+// ---------------------------------------------------------------------------
+
+void main_screen_update_progress(int permille) {
+    static int s_progress = -1;
+    if (!s_progress_bar || permille == s_progress) return;
+    s_progress = permille;
+    lv_bar_set_value(s_progress_bar, permille, LV_ANIM_OFF);
+}
+
 // ---------------------------------------------------------------------------
 // main_screen_update_art
-// Called from Core 1. Decodes JPEG via TJpgDec, blits to background canvas.
-// Pass nullptr to clear art (black background, scrim hidden).
+// Called from Core 1. Decodes a whole JPEG into the back buffer and swaps
+// it onto the background canvas.  Pass nullptr to clear art (canvas hidden).
 // ---------------------------------------------------------------------------
 
-void main_screen_update_art(const uint8_t *jpeg_buf, size_t jpeg_size) {
-    if (!s_art_canvas || !s_art_buf) return;
+bool main_screen_update_art(const uint8_t *jpeg_buf, size_t jpeg_size) {
+    if (!s_art_canvas || !s_art_buf) return false;
 
     if (!jpeg_buf || jpeg_size == 0) {
-        // No art: hide canvas
+        // No art: hide canvas.  The next cover arrives through a swap, so
+        // there are no stale pixels to clear.
         lv_obj_add_flag(s_art_canvas, LV_OBJ_FLAG_HIDDEN);
-        // Fill black so stale pixels don't flash on next show
-        lv_canvas_fill_bg(s_art_canvas, lv_color_hex(0x0A0A0A), LV_OPA_COVER);
-        return;
+        return false;
     }
 
-    TJpgDec.setJpgScale(ALBUM_ART_JPEG_SCALE);
-    TJpgDec.setCallback(art_decode_cb);
-    TJpgDec.drawJpg(0, 0, jpeg_buf, jpeg_size);
+    if (!s_art_back || !art_decode_jpeg(jpeg_buf, jpeg_size, s_art_back, nullptr)) {
+        return false;
+    }
+    main_screen_swap_art();
 
-    // Show canvas, force redraw
+    DEBUG_PRINTLN("[Art] Background canvas updated");
+    return true;
+}
+
+const uint16_t *main_screen_art_frame() {
+    return s_art_buf;
+}
+
+uint16_t *main_screen_art_back() {
+    return s_art_back;
+}
+
+static void show_art_buffer(uint16_t *buf) {
+    lv_canvas_set_buffer(s_art_canvas, buf,
+                         ALBUM_ART_SIZE, ALBUM_ART_SIZE, LV_IMG_CF_TRUE_COLOR);
     lv_obj_clear_flag(s_art_canvas, LV_OBJ_FLAG_HIDDEN);
     lv_obj_invalidate(s_art_canvas);
+}
 
-    DEBUG_PRINTLN("[Art] Background canvas updated");
+// The new frame is on screen: it becomes the front buffer, the old front is
+// handed back to the art pipeline.
+static void finish_art_swap() {
+    uint16_t *front = s_art_back;
+    s_art_back  = s_art_buf;
+    s_art_buf   = front;
+    s_fade_step = 0;
+    show_art_buffer(s_art_buf);
 }
 
-// ---------------------------------------------------------------------------
-// main_screen_update_waveform
-//
-// Redraws the waveform canvas with 'count' amplitude bars (0–255 each).
-// Bars grow symmetrically from the canvas centre line, oldest bar on the left.
-// Called from Core 1 every MIC_BAR_MS ms by loop().
-// ---------------------------------------------------------------------------
+void main_screen_swap_art() {
+    if (!s_art_canvas || !s_art_buf || !s_art_back || s_fade_step) return;
+
+    // LVGL renders the canvas synchronously inside lv_timer_handler(), so
+    // once we are here nothing is reading the old front buffer.  Nothing
+    // to fade from when no art is showing.
+    if (ART_FADE_STEPS < 2 || !s_art_spare ||
+        lv_obj_has_flag(s_art_canvas, LV_OBJ_FLAG_HIDDEN)) {
+        finish_art_swap();
+        return;
+    }
+    s_fade_step = 1;
+    s_fade_row  = 0;
+}
+
+bool main_screen_art_tick(uint32_t budget_us) {
+    if (!s_fade_step) return false;
+
+    const int64_t  start = esp_timer_get_time();
+    const uint32_t w     = (uint32_t)(s_fade_step * ART_BLEND_MAX / ART_FADE_STEPS);
+    const int      first = s_fade_row;
+
+    while (s_fade_row < ALBUM_ART_SIZE) {
+        int rows = ALBUM_ART_SIZE - s_fade_row;
+        if (rows > ART_FADE_ROWS) rows = ART_FADE_ROWS;
+        size_t off = (size_t)s_fade_row * ALBUM_ART_SIZE;
+        art_blend_rgb565(s_art_buf + off, s_art_back + off, s_art_spare + off,
+                         (size_t)rows * ALBUM_ART_SIZE, w);
+        s_fade_row += rows;
+        if ((uint32_t)(esp_timer_get_time() - start) >= budget_us) break;
+    }
+
+    // From the second pass on the canvas shows s_art_spare: redraw the band.
+    if (s_fade_step > 1 && s_fade_row > first) {
+        lv_area_t band;
+        lv_obj_get_coords(s_art_canvas, &band);
+        band.y2 = band.y1 + s_fade_row - 1;
+        band.y1 = band.y1 + first;
+        lv_obj_invalidate_area(s_art_canvas, &band);
+    }
+    if (s_fade_row < ALBUM_ART_SIZE) return true;
+
+    if (s_fade_step == 1) show_art_buffer(s_art_spare);
+    s_fade_row = 0;
+    if (++s_fade_step >= ART_FADE_STEPS) {
+        finish_art_swap();   // last step is the new frame itself
+        return false;
+    }
+    return true;
+}
 
 // ---------------------------------------------------------------------------
-// Siri-style multicolour waveform renderer.
+// Siri-style multicolour waveform.
 //
-// Draws 4 overlapping sine waves — one per frequency band — directly into the
-// RGB565 canvas pixel buffer.  Each wave is amplitude-modulated by its band's
-// energy and shaped by a Hann window so the edges taper to nothing (giving the
-// "eye / lens" silhouette).  Phases advance every call for flowing animation.
+// 4 overlapping sine waves — one per frequency band — each amplitude-
+// modulated by its band's energy and shaped by a Hann window so the edges
+// taper to nothing (giving the "eye / lens" silhouette).  Phases advance
+// every call for flowing animation.  This function owns the per-band
+// auto-gain and the phases; the pixels are drawn by ui/wave_render.
 //
-// Additive RGB blending is used: where two waves share a pixel their colours
-// sum (clamped at 255), producing vivid mixed hues at intersections.
+// Runs on the wave task, never on the LVGL thread: it only touches the back
+// buffer, and only while Core 1 has not yet taken the previous frame.
 //
-// Band → colour mapping:
-//   bass  (<250 Hz)  deep blue   (  0,  60, 255)
-//   mid   (250-1kHz) cyan        (  0, 220, 255)
-//   hmid  (1-4kHz)   green-gold  ( 80, 255,  40)
-//   high  (>4kHz)    pink-mag    (255,  40, 180)
+// Bands: the mic analyser's log-spaced bands, lowest on wave 0 (see
+// MIC_BANDS in config.h).
 // ---------------------------------------------------------------------------
-void main_screen_update_waveform(const uint8_t *levels, int count) {
-    if (!s_wave_canvas || !s_wave_buf) return;
-
-    // Read raw band energies (0–255 → 0.0–1.0)
-    float raw_bass = g_band_bass / 255.0f;
-    float raw_mid  = g_band_mid  / 255.0f;
-    float raw_hmid = g_band_hmid / 255.0f;
-    float raw_high = g_band_high / 255.0f;
+bool main_screen_render_waveform() {
+    if (!s_wave_canvas) return false;
+    // Core 1 has not swapped the last frame in yet
+    if (s_wave_ready.load(std::memory_order_acquire)) return false;
+
+    // Latest mic block, interpolated to "now" between the last two blocks so
+    // the waves move smoothly whatever the render rate.
+    static MicTrack track = {};
+    MicSnapshot snap;
+    if (mic_pdm_snapshot(&snap)) mic_track_push(&track, &snap);
+    const uint32_t now_us = (uint32_t)esp_timer_get_time();
+
+    // Fold the analyser's bands into the four waves (0–255 → 0.0–1.0); with
+    // MIC_BANDS == WAVE_BANDS this is one band per wave.  Each wave takes the
+    // loudest analyser band in its share of the spectrum.
+    const int n_bands = track.cur.n_bands;
+    float raw[WAVE_BANDS];
+    for (int w = 0; w < WAVE_BANDS; w++) {
+        int lo = w * n_bands / WAVE_BANDS;
+        int hi = (w + 1) * n_bands / WAVE_BANDS;
+        if (hi <= lo && lo < n_bands) hi = lo + 1;
+        float v = 0.0f;
+        for (int b = lo; b < hi; b++) v = fmaxf(v, mic_track_band(&track, b, now_us));
+        raw[w] = v / 255.0f;
+    }
 
     // Per-band auto-gain: each band tracks its own rolling peak so all four
     // waves share equal visual presence regardless of which frequency dominates.
     // Fast attack, ~3 s decay half-life at 12.5 Hz. Floor keeps silence flat.
-    static float pk_bass = 0.15f, pk_mid = 0.15f;
-    static float pk_hmid = 0.15f, pk_high = 0.15f;
+    static float pk[WAVE_BANDS] = { 0.15f, 0.15f, 0.15f, 0.15f };
     constexpr float DECAY = 0.982f, FLOOR = 0.15f;
-    if (raw_bass > pk_bass) pk_bass = raw_bass; pk_bass *= DECAY; if (pk_bass < FLOOR) pk_bass = FLOOR;
-    if (raw_mid  > pk_mid ) pk_mid  = raw_mid;  pk_mid  *= DECAY; if (pk_mid  < FLOOR) pk_mid  = FLOOR;
-    if (raw_hmid > pk_hmid) pk_hmid = raw_hmid; pk_hmid *= DECAY; if (pk_hmid < FLOOR) pk_hmid = FLOOR;
-    if (raw_high > pk_high) pk_high = raw_high; pk_high *= DECAY; if (pk_high < FLOOR) pk_high = FLOOR;
+    // Beat pulse: each new beat lifts every wave part of the way to full
+    // height, fading over a few frames.
+    static uint32_t last_beats = 0;
+    static float    pulse      = 0.0f;
+    pulse *= 0.6f;
+    if (track.cur.beats != last_beats) {
+        last_beats = track.cur.beats;
+        pulse = 1.0f;
+    }
 
-    float bass = raw_bass / pk_bass; if (bass > 1.0f) bass = 1.0f;
-    float mid  = raw_mid  / pk_mid;  if (mid  > 1.0f) mid  = 1.0f;
-    float hmid = raw_hmid / pk_hmid; if (hmid > 1.0f) hmid = 1.0f;
-    float high = raw_high / pk_high; if (high > 1.0f) high = 1.0f;
+    float level[WAVE_BANDS];
+    for (int w = 0; w < WAVE_BANDS; w++) {
+        if (raw[w] > pk[w]) pk[w] = raw[w];
+        pk[w] *= DECAY;
+        if (pk[w] < FLOOR) pk[w] = FLOOR;
+        level[w] = raw[w] / pk[w];
+        if (level[w] > 1.0f) level[w] = 1.0f;
+        level[w] += (1.0f - level[w]) * WAVE_BEAT_LIFT * pulse;
+    }
 
     // Advance phase for each wave every call (~12.5 Hz).
     // Different speeds give each wave its own character.
-    static float t_bass = 0.0f, t_mid = 0.0f, t_hmid = 0.0f, t_high = 0.0f;
-    t_bass += 0.07f;
-    t_mid  += 0.11f;
-    t_hmid += 0.16f;
-    t_high += 0.22f;
-
-    const int   W   = WAVE_CANVAS_W;   // 160
-    const int   H   = WAVE_CANVAS_H;   // 40
-    const int   cy  = H / 2;           // 20 — vertical centre
-    const float glow = 5.5f;           // neon glow radius in pixels
-    const float mhh  = (float)cy - glow - 2.0f; // wave peak never clips canvas edge
-
-    // Clear to fully transparent (alpha byte = 0 in the 3-byte TRUE_COLOR_ALPHA format).
-    memset(s_wave_buf, 0, (size_t)(W * H) * 3);
-
-    for (int x = 0; x < W; x++) {
-        float cx  = (float)x / (float)(W - 1);
-        float win = sinf(3.14159265f * cx);  // Hann window — tapers to 0 at edges
-
-        // Floating-point wave peak offsets (signed px from canvas centre row).
-        float p_bass_f = bass * win * sinf(2.0f * 3.14159265f * 1.5f * cx + t_bass) * mhh;
-        float p_mid_f  = mid  * win * sinf(2.0f * 3.14159265f * 2.5f * cx + t_mid ) * mhh;
-        float p_hmid_f = hmid * win * sinf(2.0f * 3.14159265f * 4.0f * cx + t_hmid) * mhh;
-        float p_high_f = high * win * sinf(2.0f * 3.14159265f * 6.5f * cx + t_high) * mhh;
-
-        for (int y = 0; y < H; y++) {
-            float dy_f = (float)(cy - y);
-
-            // Linear falloff from each wave's peak, scaled by Hann window.
-            // Linear (not quadratic) keeps the full glow width uniformly coloured —
-            // quadratic caused dark near-black pixels at the outer edge (the "black
-            // border").  Threshold clips the absolute dimmest outer fringe cleanly.
-            float g_bass = 0.0f, g_mid = 0.0f, g_hmid = 0.0f, g_high = 0.0f;
-            float d;
-            d = fabsf(dy_f - p_bass_f);
-            if (d < glow) { float t = (1.0f - d / glow) * win; g_bass = bass * t; }
-            d = fabsf(dy_f - p_mid_f);
-            if (d < glow) { float t = (1.0f - d / glow) * win; g_mid  = mid  * t; }
-            d = fabsf(dy_f - p_hmid_f);
-            if (d < glow) { float t = (1.0f - d / glow) * win; g_hmid = hmid * t; }
-            d = fabsf(dy_f - p_high_f);
-            if (d < glow) { float t = (1.0f - d / glow) * win; g_high = high * t; }
-
-            // Additive RGB — neon palette, vivid at crossings.
-            // bass=electric blue  mid=cyan-teal  hmid=lime-green  high=hot-pink
-            float fr = g_bass *  20 + g_mid *   0 + g_hmid * 120 + g_high * 255;
-            float fg = g_bass * 120 + g_mid * 255 + g_hmid * 255 + g_high *  40;
-            float fb = g_bass * 255 + g_mid * 220 + g_hmid *  20 + g_high * 230;
-
-            if (fr > 10.0f || fg > 10.0f || fb > 10.0f) {
-                uint8_t r8 = fr > 255.0f ? 255 : (uint8_t)fr;
-                uint8_t g8 = fg > 255.0f ? 255 : (uint8_t)fg;
-                uint8_t b8 = fb > 255.0f ? 255 : (uint8_t)fb;
-                lv_color_t c  = lv_color_make(r8, g8, b8);
-                uint8_t  *px  = s_wave_buf + ((size_t)(y * W + x)) * 3;
-                px[0] = (uint8_t)(c.full & 0xFF);  // RGB565 low byte
-                px[1] = (uint8_t)(c.full >> 8);    // RGB565 high byte
-                px[2] = 0xFF;                       // alpha = fully opaque
-            }
-        }
+    static WaveParams wave = {};
+    wave.phase[0] += WAVE_RADIANS(0.07f);
+    wave.phase[1] += WAVE_RADIANS(0.11f);
+    wave.phase[2] += WAVE_RADIANS(0.16f);
+    wave.phase[3] += WAVE_RADIANS(0.22f);
+    for (int w = 0; w < WAVE_BANDS; w++) {
+        wave.amp_q15[w] = (uint16_t)(level[w] * 32768.0f);
     }
 
+    // Tables + fixed point, glow bands only (see ui/wave_render.h).
+    int back = s_wave_front.load(std::memory_order_relaxed) ^ 1;
+    wave_render(s_wave_buf[back], &wave);
+
+    s_wave_ready.store(true, std::memory_order_release);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// main_screen_wave_tick — Core 1: put the finished back buffer on the canvas.
+// A pointer swap and an invalidate; the drawing happened on the wave task.
+// ---------------------------------------------------------------------------
+void main_screen_wave_tick() {
+    if (!s_wave_canvas || !s_wave_ready.load(std::memory_order_acquire)) return;
+
+    int back = s_wave_front.load(std::memory_order_relaxed) ^ 1;
+    lv_canvas_set_buffer(s_wave_canvas, s_wave_buf[back],
+                         WAVE_CANVAS_W, WAVE_CANVAS_H, LV_IMG_CF_TRUE_COLOR_ALPHA);
+    s_wave_front.store(back, std::memory_order_relaxed);
+    // Old front is now free for the next frame
+    s_wave_ready.store(false, std::memory_order_release);
     lv_obj_invalidate(s_wave_canvas);
 }
 
@@ -17,17 +17,54 @@ void main_screen_create();
 void main_screen_update(int volume, const char *title,
                         const char *artist, bool is_playing,
                         bool source_is_usb, bool is_muted,
-                        bool spotify_active, int progress_pct);
+                        bool spotify_active);
 
 /**
- * Decode a JPEG and blit it to the album art canvas.
- * Must be called only from Core 1 (the LVGL thread).
+ * Set the track progress bar, in thousandths of the track.  loop() calls it
+ * every frame from the playback clock; unchanged values cost nothing.
+ * Core 1 only.
+ */
+void main_screen_update_progress(int permille);
+
+/**
+ * Decode a whole JPEG into the back buffer and swap it onto the album art
+ * canvas.  Must be called only from Core 1 (the LVGL thread).
  *
- * @param jpeg_buf  Raw JPEG bytes (allocated in PSRAM by kef_fetch_jpeg).
+ * @param jpeg_buf  Raw JPEG bytes.
  *                  Pass nullptr to clear the canvas to the background color.
  * @param jpeg_size Number of bytes in jpeg_buf.
+ * @return true if a JPEG was decoded onto the canvas.
+ */
+bool main_screen_update_art(const uint8_t *jpeg_buf, size_t jpeg_size);
+
+/**
+ * The album art on the canvas — ALBUM_ART_SIZE² RGB565 pixels — or nullptr
+ * if the buffer could not be allocated.  Valid until the next swap.
+ */
+const uint16_t *main_screen_art_frame();
+
+/**
+ * The off-screen art buffer (same size), or nullptr.  The art pipeline
+ * fills it from Core 0 between swaps (see the art pipeline notes in
+ * main.cpp); the pointer changes on every swap.
  */
-void main_screen_update_art(const uint8_t *jpeg_buf, size_t jpeg_size);
+uint16_t *main_screen_art_back();
+
+/**
+ * Put the back buffer on the canvas and keep the old front as the new back
+ * buffer — a pointer exchange, no pixel copy.  If art is already showing,
+ * the swap happens at the end of a cross-fade driven by
+ * main_screen_art_tick(); the back buffer must not be written until then.
+ * Core 1 only.
+ */
+void main_screen_swap_art();
+
+/**
+ * Advance a cross-fade started by main_screen_swap_art(), blending for
+ * about budget_us and redrawing only the rows blended.  Returns true while
+ * the fade is still running.  Call every loop(); Core 1 only.
+ */
+bool main_screen_art_tick(uint32_t budget_us);
 
 /**
  * Toggle the control panel overlay (swipe-from-top reveals it).
@@ -74,8 +111,14 @@ const char *main_screen_take_track_cmd();
 lv_obj_t *main_screen_get_obj();
 
 /**
- * Redraw the waveform visualiser with amplitude history.
- * levels[0] is the oldest sample, levels[count-1] the newest (0–255 each).
- * count should equal MIC_N_BARS from config.h.  Core 1 only.
+ * Draw the next waveform frame into the hidden canvas buffer.
+ * Wave task only — does not call LVGL.  Returns false (and draws nothing)
+ * while the previous frame is still waiting for main_screen_wave_tick().
+ */
+bool main_screen_render_waveform();
+
+/**
+ * Show the waveform frame finished by main_screen_render_waveform(), if any.
+ * Core 1 only: swaps the canvas buffer pointer and invalidates.
  */
-void main_screen_update_waveform(const uint8_t *levels, int count);
+void main_screen_wave_tick();
@@ -0,0 +1,182 @@
+#include "wave_render.h"
+#include "config.h"
+
+#include <math.h>
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// Shape and palette
+//
+// Band → colour (additive RGB, 0..255 per unit of glow):
+//   bass  electric blue  ( 20, 120, 255)
+//   mid   cyan-teal      (  0, 255, 220)
+//   hmid  lime-green     (120, 255,  20)
+//   high  hot-pink       (255,  40, 230)
+// ---------------------------------------------------------------------------
+
+#define WAVE_GLOW       5.5f    // neon glow radius in pixels
+#define WAVE_THRESHOLD  10      // pixels dimmer than this in every channel stay transparent
+
+static const float   kCycles[WAVE_BANDS] = { 1.5f, 2.5f, 4.0f, 6.5f };  // across the canvas
+static const uint8_t kRed  [WAVE_BANDS]  = {  20,   0, 120, 255 };
+static const uint8_t kGreen[WAVE_BANDS]  = { 120, 255, 255,  40 };
+static const uint8_t kBlue [WAVE_BANDS]  = { 255, 220,  20, 230 };
+
+static const int W  = WAVE_CANVAS_W;
+static const int H  = WAVE_CANVAS_H;
+static const int CY = H / 2;                               // vertical centre row
+
+static inline void put_pixel(uint8_t *buf, int x, int y, uint32_t r, uint32_t g, uint32_t b) {
+    uint16_t c  = (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+    uint8_t *px = buf + ((size_t)(y * W + x)) * 3;
+    px[0] = (uint8_t)(c & 0xFF);   // RGB565 low byte
+    px[1] = (uint8_t)(c >> 8);     // RGB565 high byte
+    px[2] = 0xFF;                  // alpha = fully opaque
+}
+
+// ---------------------------------------------------------------------------
+// Tables (built on first use)
+// ---------------------------------------------------------------------------
+
+#define SIN_BITS 10
+#define SIN_LEN  (1 << SIN_BITS)
+
+static int16_t  s_sin[SIN_LEN + 1];         // Q15 sine over one turn, +1 for interpolation
+static int16_t  s_hann[WAVE_CANVAS_W];      // Q15 sin(π x / (W-1)), 0..1
+static uint32_t s_step[WAVE_BANDS];         // phase advance per column, 2^32 = one turn
+static bool     s_tables = false;
+
+static void build_tables() {
+    for (int i = 0; i <= SIN_LEN; i++) {
+        s_sin[i] = (int16_t)lrintf(32767.0f * sinf(6.28318531f * (float)i / SIN_LEN));
+    }
+    for (int x = 0; x < W; x++) {
+        s_hann[x] = (int16_t)lrintf(32767.0f * sinf(3.14159265f * (float)x / (float)(W - 1)));
+    }
+    for (int k = 0; k < WAVE_BANDS; k++) {
+        s_step[k] = (uint32_t)llrint(kCycles[k] * 4294967296.0 / (double)(W - 1));
+    }
+    s_tables = true;
+}
+
+// Q15 sine of a 2^32-per-turn angle, linearly interpolated between entries.
+static inline int32_t sin_q15(uint32_t angle) {
+    uint32_t i    = angle >> (32 - SIN_BITS);
+    int32_t  frac = (int32_t)((angle >> (32 - SIN_BITS - 15)) & 0x7FFF);
+    int32_t  a    = s_sin[i];
+    return a + (((s_sin[i + 1] - a) * frac) >> 15);
+}
+
+// ---------------------------------------------------------------------------
+// Fixed-point renderer
+// ---------------------------------------------------------------------------
+
+void wave_render(uint8_t *buf, const WaveParams *p) {
+    if (!s_tables) build_tables();
+
+    const int32_t glow_q8  = (int32_t)(WAVE_GLOW * 256.0f);                  // 1408
+    const int32_t mhh_q8   = (int32_t)(((float)CY - WAVE_GLOW - 2.0f) * 256.0f);
+    const uint32_t inv_glow = (uint32_t)((32768.0 * 65536.0) / (WAVE_GLOW * 256.0) + 0.5);
+    const int32_t cy_q8    = CY << 8;
+
+    memset(buf, 0, (size_t)(W * H) * 3);
+
+    // Per-column colour accumulators, Q15 per unit of colour.  Kept zero
+    // between columns by clearing only the rows a column touched.
+    int32_t acc_r[WAVE_CANVAS_H] = {}, acc_g[WAVE_CANVAS_H] = {}, acc_b[WAVE_CANVAS_H] = {};
+
+    for (int x = 0; x < W; x++) {
+        int32_t win = s_hann[x];
+        int lo = H, hi = -1;   // rows touched in this column
+
+        for (int k = 0; k < WAVE_BANDS; k++) {
+            int32_t aw = ((int32_t)p->amp_q15[k] * win) >> 15;   // level × window, Q15
+            if (aw == 0) continue;
+
+            // Wave peak offset from the centre row, Q8 px (up is positive).
+            int32_t s    = sin_q15(p->phase[k] + s_step[k] * (uint32_t)x);
+            int32_t peak = (((aw * s) >> 15) * mhh_q8) >> 15;
+
+            // Rows whose distance from the peak is under the glow radius.
+            int32_t top_q8 = cy_q8 - peak - glow_q8;
+            int32_t bot_q8 = cy_q8 - peak + glow_q8;
+            int y0 = (top_q8 >> 8) + 1;
+            int y1 = (bot_q8 - 1) >> 8;
+            if (y0 < 0) y0 = 0;
+            if (y1 > H - 1) y1 = H - 1;
+            if (y0 < lo) lo = y0;
+            if (y1 > hi) hi = y1;
+
+            for (int y = y0; y <= y1; y++) {
+                int32_t d = ((CY - y) << 8) - peak;
+                if (d < 0) d = -d;
+                int32_t fall = (int32_t)(((uint32_t)(glow_q8 - d) * inv_glow) >> 16);  // Q15
+                int32_t g    = (aw * fall) >> 15;
+                acc_r[y] += g * kRed[k];
+                acc_g[y] += g * kGreen[k];
+                acc_b[y] += g * kBlue[k];
+            }
+        }
+
+        const int32_t thr = WAVE_THRESHOLD << 15;
+        for (int y = lo; y <= hi; y++) {
+            if (acc_r[y] > thr || acc_g[y] > thr || acc_b[y] > thr) {
+                uint32_t r = (uint32_t)(acc_r[y] >> 15); if (r > 255) r = 255;
+                uint32_t g = (uint32_t)(acc_g[y] >> 15); if (g > 255) g = 255;
+                uint32_t b = (uint32_t)(acc_b[y] >> 15); if (b > 255) b = 255;
+                put_pixel(buf, x, y, r, g, b);
+            }
+            acc_r[y] = acc_g[y] = acc_b[y] = 0;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Float reference
+// ---------------------------------------------------------------------------
+
+void wave_render_ref(uint8_t *buf, const WaveParams *p) {
+    const float glow = WAVE_GLOW;
+    const float mhh  = (float)CY - glow - 2.0f;   // wave peak never clips canvas edge
+
+    float amp[WAVE_BANDS], t[WAVE_BANDS];
+    for (int k = 0; k < WAVE_BANDS; k++) {
+        amp[k] = p->amp_q15[k] / 32768.0f;
+        t[k]   = p->phase[k] * (6.28318531f / 4294967296.0f);
+    }
+
+    memset(buf, 0, (size_t)(W * H) * 3);
+
+    for (int x = 0; x < W; x++) {
+        float cx  = (float)x / (float)(W - 1);
+        float win = sinf(3.14159265f * cx);   // Hann window — tapers to 0 at edges
+
+        float peak[WAVE_BANDS];
+        for (int k = 0; k < WAVE_BANDS; k++) {
+            peak[k] = amp[k] * win * sinf(2.0f * 3.14159265f * kCycles[k] * cx + t[k]) * mhh;
+        }
+
+        for (int y = 0; y < H; y++) {
+            float dy = (float)(CY - y);
+
+            // Linear falloff from each wave's peak, scaled by the window.
+            float fr = 0.0f, fg = 0.0f, fb = 0.0f;
+            for (int k = 0; k < WAVE_BANDS; k++) {
+                float d = fabsf(dy - peak[k]);
+                if (d < glow) {
+                    float g = amp[k] * (1.0f - d / glow) * win;
+                    fr += g * kRed[k];
+                    fg += g * kGreen[k];
+                    fb += g * kBlue[k];
+                }
+            }
+
+            if (fr > WAVE_THRESHOLD || fg > WAVE_THRESHOLD || fb > WAVE_THRESHOLD) {
+                put_pixel(buf, x, y,
+                          fr > 255.0f ? 255 : (uint32_t)fr,
+                          fg > 255.0f ? 255 : (uint32_t)fg,
+                          fb > 255.0f ? 255 : (uint32_t)fb);
+            }
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Siri-style waveform renderer for the WAVE_CANVAS_W × WAVE_CANVAS_H canvas
+ * (3-byte TRUE_COLOR_ALPHA pixels: RGB565 little-endian + alpha).
+ *
+ * Four overlapping sine waves — one per frequency band — each amplitude-
+ * modulated by its band's level and shaped by a Hann window so the edges
+ * taper to nothing.  Each wave has a linear neon glow WAVE_GLOW px wide on
+ * either side; where waves overlap their colours add (clamped at 255).
+ *
+ * wave_render() is the fast path: sine and Hann values come from tables,
+ * all per-pixel math is Q15/Q8 fixed point, and each column only visits
+ * the rows inside each wave's glow band.  wave_render_ref() is the float
+ * renderer it replaced, kept as the definition; the two agree to within a
+ * couple of 8-bit colour steps per channel.  Pure C — no Arduino, LVGL or
+ * FreeRTOS dependencies.
+ */
+
+#define WAVE_BANDS 4          // bass, mid, high-mid, high
+
+typedef struct {
+    uint16_t amp_q15[WAVE_BANDS];  // band level after auto-gain, 0..32768 = 0..1
+    uint32_t phase[WAVE_BANDS];    // wave phase, 2^32 = one turn
+} WaveParams;
+
+/** Convert radians to a WaveParams phase step. */
+#define WAVE_RADIANS(r) ((uint32_t)((r) * 683565275.576f))   // 2^32 / 2π
+
+void wave_render(uint8_t *buf, const WaveParams *p);
+
+void wave_render_ref(uint8_t *buf, const WaveParams *p);
@@ -0,0 +1,116 @@
+// Host tests for ui/art_blend: the two-pixel SWAR kernel must match the
+// per-channel reference bit for bit at every weight, alignment and length.
+// The benchmark times both on a full album-art frame.
+#include <unity.h>
+#include "ui/art_blend.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#define N 1031   // odd, so every run ends on a one-pixel tail
+
+static uint16_t s_a[N + 2], s_b[N + 2], s_fast[N + 2], s_ref[N + 2];
+static uint32_t s_rng;
+
+static const size_t kLengths[] = { N, N - 1, 3, 2, 1 };
+
+static uint16_t rnd16() {
+    s_rng = s_rng * 1103515245u + 12345u;
+    return (uint16_t)(s_rng >> 8);
+}
+
+void setUp() {
+    s_rng = 1;
+    for (int i = 0; i < N + 2; i++) {
+        s_a[i] = rnd16();
+        s_b[i] = rnd16();
+    }
+    // Channel extremes in both directions
+    s_a[0] = 0xFFFF; s_b[0] = 0x0000;
+    s_a[1] = 0x0000; s_b[1] = 0xFFFF;
+    s_a[2] = 0xF800; s_b[2] = 0x07E0;
+    s_a[3] = 0x001F; s_b[3] = 0xF81F;
+}
+
+void tearDown() {}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+static void test_matches_reference_everywhere() {
+    // Offsets of 0 or 1 pixel make each buffer 4-byte aligned or not.
+    for (uint32_t w = 0; w <= ART_BLEND_MAX; w++) {
+        for (int oa = 0; oa < 2; oa++)
+        for (int ob = 0; ob < 2; ob++)
+        for (int oo = 0; oo < 2; oo++)
+        for (size_t n : kLengths) {
+            memset(s_fast, 0, sizeof(s_fast));
+            memset(s_ref, 0, sizeof(s_ref));
+            art_blend_rgb565(s_a + oa, s_b + ob, s_fast + oo, n, w);
+            art_blend_rgb565_ref(s_a + oa, s_b + ob, s_ref + oo, n, w);
+            TEST_ASSERT_EQUAL_MEMORY(s_ref, s_fast, sizeof(s_fast));
+        }
+    }
+}
+
+static void test_end_weights_are_exact() {
+    art_blend_rgb565(s_a, s_b, s_fast, N, 0);
+    TEST_ASSERT_EQUAL_MEMORY(s_a, s_fast, N * sizeof(uint16_t));
+    art_blend_rgb565(s_a, s_b, s_fast, N, ART_BLEND_MAX);
+    TEST_ASSERT_EQUAL_MEMORY(s_b, s_fast, N * sizeof(uint16_t));
+}
+
+static void test_halfway_per_channel() {
+    const uint16_t a = 0xF800 | (0x3F << 5) | 0x1F;   // white
+    const uint16_t b = 0x0000;
+    uint16_t out;
+    art_blend_rgb565(&a, &b, &out, 1, ART_BLEND_MAX / 2);
+    TEST_ASSERT_EQUAL_INT(15, out >> 11);            // 31 * 16 / 32
+    TEST_ASSERT_EQUAL_INT(31, (out >> 5) & 0x3F);    // 63 * 16 / 32
+    TEST_ASSERT_EQUAL_INT(15, out & 0x1F);
+}
+
+static void test_zero_length_writes_nothing() {
+    s_fast[0] = 0x1234;
+    art_blend_rgb565(s_a, s_b, s_fast, 0, 16);
+    TEST_ASSERT_EQUAL_INT(0x1234, s_fast[0]);
+}
+
+static void test_benchmark() {
+    const size_t px = ALBUM_ART_SIZE * ALBUM_ART_SIZE;
+    std::vector<uint16_t> a(px), b(px), out(px);
+    for (size_t i = 0; i < px; i++) {
+        a[i] = rnd16();
+        b[i] = rnd16();
+    }
+
+    const int frames = 200;
+    double us[2];
+    for (int pass = 0; pass < 2; pass++) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            uint32_t w = 1 + i % (ART_BLEND_MAX - 1);   // a fade's inner weights
+            (pass ? art_blend_rgb565_ref : art_blend_rgb565)(a.data(), b.data(), out.data(), px, w);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        us[pass] = std::chrono::duration<double, std::micro>(t1 - t0).count() / frames;
+    }
+    char msg[112];
+    snprintf(msg, sizeof(msg), "host: SWAR %.1f us/frame, reference %.1f us/frame (%.2fx)",
+             us[0], us[1], us[1] / us[0]);
+    TEST_MESSAGE(msg);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_reference_everywhere);
+    RUN_TEST(test_end_weights_are_exact);
+    RUN_TEST(test_halfway_per_channel);
+    RUN_TEST(test_zero_length_writes_nothing);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
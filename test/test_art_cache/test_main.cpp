@@ -0,0 +1,166 @@
+// Host tests for state/art_cache: URL keys, LRU eviction by byte budget and
+// by entry cap, probe counters, and that every block the cache allocates is
+// released exactly once.
+#include <unity.h>
+#include "state/art_cache.h"
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define FRAME_BYTES (ALBUM_ART_SIZE * ALBUM_ART_SIZE * 2)
+
+static ArtCache s_cache;
+static int      s_live;          // blocks allocated and not yet released
+static bool     s_fail_alloc;
+
+static void *count_alloc(size_t size) {
+    if (s_fail_alloc) return nullptr;
+    s_live++;
+    return malloc(size);
+}
+
+static void count_release(void *p) {
+    if (p) s_live--;
+    free(p);
+}
+
+void setUp() {
+    s_live       = 0;
+    s_fail_alloc = false;
+    art_cache_init(&s_cache, 3 * FRAME_BYTES, count_alloc, count_release);
+}
+
+void tearDown() {
+    // Whatever was evicted or replaced has been released
+    int held = art_cache_count(&s_cache);
+    for (auto &e : s_cache.entries) free(e.data);
+    TEST_ASSERT_EQUAL_INT(held, s_live);
+}
+
+static std::vector<uint8_t> frame(uint8_t fill) {
+    return std::vector<uint8_t>(FRAME_BYTES, fill);
+}
+
+static bool put(uint64_t key, uint8_t fill) {
+    std::vector<uint8_t> f = frame(fill);
+    return art_cache_put(&s_cache, key, f.data(), f.size());
+}
+
+static bool holds(uint64_t key) {
+    return art_cache_get(&s_cache, key, nullptr) != nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// Keys
+// ---------------------------------------------------------------------------
+
+static void test_key_is_stable_and_never_zero() {
+    const char *large = "https://i.scdn.co/image/ab67616d0000b273abc123";
+    const char *small = "https://i.scdn.co/image/ab67616d00001e02abc123";
+    TEST_ASSERT_TRUE(art_cache_key(large) == art_cache_key(large));
+    TEST_ASSERT_TRUE(art_cache_key(large) != art_cache_key(small));
+    TEST_ASSERT_TRUE(art_cache_key("") != 0);
+}
+
+// ---------------------------------------------------------------------------
+// Entries
+// ---------------------------------------------------------------------------
+
+static void test_put_keeps_a_copy() {
+    std::vector<uint8_t> f = frame(0x11);
+    TEST_ASSERT_TRUE(art_cache_put(&s_cache, 7, f.data(), f.size()));
+    f.assign(f.size(), 0x22);
+
+    size_t size = 0;
+    const uint8_t *got = (const uint8_t *)art_cache_get(&s_cache, 7, &size);
+    TEST_ASSERT_TRUE(got != nullptr && got != f.data());
+    TEST_ASSERT_EQUAL_INT(FRAME_BYTES, (int)size);
+    TEST_ASSERT_EQUAL_INT(0x11, got[0]);
+    TEST_ASSERT_EQUAL_INT(0x11, got[FRAME_BYTES - 1]);
+}
+
+static void test_probe_counts_and_get_does_not() {
+    put(7, 1);
+    TEST_ASSERT_TRUE(art_cache_probe(&s_cache, 7));
+    TEST_ASSERT_FALSE(art_cache_probe(&s_cache, 8));
+    art_cache_get(&s_cache, 7, nullptr);
+    art_cache_get(&s_cache, 8, nullptr);
+    TEST_ASSERT_EQUAL_UINT32(1, s_cache.hits);
+    TEST_ASSERT_EQUAL_UINT32(1, s_cache.misses);
+}
+
+static void test_replacing_a_key_keeps_one_entry() {
+    put(7, 1);
+    put(7, 2);
+    TEST_ASSERT_EQUAL_INT(1, art_cache_count(&s_cache));
+    TEST_ASSERT_EQUAL_INT(FRAME_BYTES, (int)s_cache.used);
+    TEST_ASSERT_EQUAL_INT(2, ((const uint8_t *)art_cache_get(&s_cache, 7, nullptr))[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, s_cache.evictions);
+}
+
+static void test_oversized_and_failed_puts_cache_nothing() {
+    std::vector<uint8_t> big(s_cache.budget + 1, 0);
+    TEST_ASSERT_FALSE(art_cache_put(&s_cache, 7, big.data(), big.size()));
+    TEST_ASSERT_FALSE(put(0, 1));   // 0 means "no art"
+
+    s_fail_alloc = true;
+    TEST_ASSERT_FALSE(put(8, 1));
+    s_fail_alloc = false;
+    TEST_ASSERT_FALSE(holds(7));
+    TEST_ASSERT_FALSE(holds(8));
+    TEST_ASSERT_EQUAL_INT(0, (int)s_cache.used);
+}
+
+// ---------------------------------------------------------------------------
+// Eviction
+// ---------------------------------------------------------------------------
+
+static void test_budget_evicts_least_recently_used() {
+    put(1, 1);
+    put(2, 2);
+    put(3, 3);
+    TEST_ASSERT_TRUE(art_cache_probe(&s_cache, 1));   // 2 is now the oldest
+    put(4, 4);
+    TEST_ASSERT_TRUE(holds(1));
+    TEST_ASSERT_FALSE(holds(2));
+    TEST_ASSERT_TRUE(holds(3));
+    TEST_ASSERT_TRUE(holds(4));
+    TEST_ASSERT_EQUAL_UINT32(1, s_cache.evictions);
+    TEST_ASSERT_LESS_OR_EQUAL(s_cache.budget, s_cache.used);
+}
+
+static void test_entry_cap_evicts_least_recently_used() {
+    const uint8_t b = 0;
+    for (uint64_t k = 1; k <= ART_CACHE_MAX_ENTRIES; k++) art_cache_put(&s_cache, k, &b, 1);
+    art_cache_probe(&s_cache, 1);
+    art_cache_put(&s_cache, 100, &b, 1);
+    TEST_ASSERT_EQUAL_INT(ART_CACHE_MAX_ENTRIES, art_cache_count(&s_cache));
+    TEST_ASSERT_TRUE(holds(1));
+    TEST_ASSERT_FALSE(holds(2));
+    TEST_ASSERT_TRUE(holds(100));
+}
+
+static void test_lru_survives_clock_wrap() {
+    s_cache.clock = UINT32_MAX - 1;
+    put(1, 1);   // stamped UINT32_MAX
+    put(2, 2);   // stamped 0
+    put(3, 3);
+    put(4, 4);
+    TEST_ASSERT_FALSE(holds(1));
+    TEST_ASSERT_TRUE(holds(2));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_key_is_stable_and_never_zero);
+    RUN_TEST(test_put_keeps_a_copy);
+    RUN_TEST(test_probe_counts_and_get_does_not);
+    RUN_TEST(test_replacing_a_key_keeps_one_entry);
+    RUN_TEST(test_oversized_and_failed_puts_cache_nothing);
+    RUN_TEST(test_budget_evicts_least_recently_used);
+    RUN_TEST(test_entry_cap_evicts_least_recently_used);
+    RUN_TEST(test_lru_survives_clock_wrap);
+    return UNITY_END();
+}
@@ -0,0 +1,284 @@
+// Host tests and a streaming benchmark for ui/art_decode, built against
+// tjpgd alone (scripts/native_tjpgd.py).  cover_640.jpg and cover_300.jpg
+// are one synthetic cover at Spotify's two sizes — baseline, 4:2:0,
+// quality 85, 75 KB and 22 KB — with gradients and grain for a realistic
+// entropy load and four flat colour patches at known spots inside the crop.
+//
+// The per-size benchmark times art_decode_jpeg() on each: the 640 px cover
+// cropped 1:1 against the 300 px one cropped and upscaled, the trade-off
+// state/art_plan weighs on the board.
+//
+// The benchmark feeds it through the ArtReadFn seam the way artTask feeds
+// an HTTP body, at simulated link speeds: a read that asks for bytes that
+// have not arrived yet advances a simulated clock to when they would, and
+// decode time is the host's own.  It reports time to first row and time to
+// complete.  artTask decodes into the hidden back buffer and swaps it in
+// only when the decode returns, so complete is when the cover appears;
+// first row is the progress figure artTask logs.  Host times are for
+// comparing changes, not a prediction of the board's.
+#include <unity.h>
+#include "ui/art_decode.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#define FRAME_PX   (ALBUM_ART_SIZE * ALBUM_ART_SIZE)
+#define PATCH_TOL  16    // per channel, 0..255: JPEG error on a flat patch
+#define BENCH_RUNS 5     // median of
+
+typedef std::chrono::steady_clock Clock;
+
+static std::vector<uint8_t>  s_cover_640;
+static std::vector<uint8_t>  s_cover_300;
+static std::vector<uint16_t> s_frame(FRAME_PX);
+static std::vector<uint16_t> s_ref(FRAME_PX);
+
+void setUp() {
+    std::fill(s_frame.begin(), s_frame.end(), 0);
+}
+
+void tearDown() {}
+
+// ---------------------------------------------------------------------------
+// Fixtures
+// ---------------------------------------------------------------------------
+
+static std::vector<uint8_t> read_file(const char *name) {
+    std::string path = __FILE__;
+    path = path.substr(0, path.find_last_of("/\\") + 1) + name;
+
+    std::vector<uint8_t> data;
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) return data;
+    fseek(f, 0, SEEK_END);
+    data.resize((size_t)ftell(f));
+    fseek(f, 0, SEEK_SET);
+    if (fread(data.data(), 1, data.size(), f) != data.size()) data.clear();
+    fclose(f);
+    return data;
+}
+
+// The cover's patches, in frame coordinates.  They sit at the same fraction
+// of either cover, so both sizes must put them here.
+typedef struct {
+    int     x, y;
+    uint8_t r, g, b;
+} Patch;
+
+static const Patch kPatches[] = {
+    {  80,  80, 220,  40,  40 },
+    { 280,  80,  40, 200,  60 },
+    {  80, 280,  40,  60, 210 },
+    { 280, 280, 235, 235, 235 },
+};
+
+static void check_patches(const uint16_t *frame) {
+    for (const Patch &p : kPatches) {
+        uint16_t c = frame[p.y * ALBUM_ART_SIZE + p.x];
+        int r = (c >> 11) * 255 / 31;
+        int g = ((c >> 5) & 63) * 255 / 63;
+        int b = (c & 31) * 255 / 31;
+        char msg[64];
+        snprintf(msg, sizeof(msg), "patch at %d,%d is %d,%d,%d", p.x, p.y, r, g, b);
+        TEST_ASSERT_INT_WITHIN_MESSAGE(PATCH_TOL, p.r, r, msg);
+        TEST_ASSERT_INT_WITHIN_MESSAGE(PATCH_TOL, p.g, g, msg);
+        TEST_ASSERT_INT_WITHIN_MESSAGE(PATCH_TOL, p.b, b, msg);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Simulated link
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const std::vector<uint8_t> *jpeg;
+    size_t            limit;          // body length the link delivers
+    double            bytes_per_us;   // 0 = already in memory
+    size_t            pos;
+    Clock::time_point t0;
+    double            waited_us;
+    double            first_row_us;   // < 0 until a row landed
+    volatile int      rows;
+} Link;
+
+static double link_now_us(const Link *l) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - l->t0).count() +
+           l->waited_us;
+}
+
+// Same bookkeeping as artTask's art_stream_read(): the first row is noted
+// at the read after it lands.
+static size_t link_read(void *ctx, uint8_t *buf, size_t len) {
+    Link *l = (Link *)ctx;
+    if (l->first_row_us < 0 && l->rows > 0) l->first_row_us = link_now_us(l);
+
+    size_t n = std::min(len, l->limit - l->pos);
+    if (l->bytes_per_us > 0) {
+        double arrives = (l->pos + n) / l->bytes_per_us;
+        double now = link_now_us(l);
+        if (arrives > now) l->waited_us += arrives - now;
+    }
+    if (buf) memcpy(buf, l->jpeg->data() + l->pos, n);
+    l->pos += n;
+    return n;
+}
+
+typedef struct {
+    bool   ok;
+    double first_row_ms;
+    double complete_ms;
+    double waited_ms;
+    size_t consumed;
+} StreamResult;
+
+static StreamResult stream(const std::vector<uint8_t> &jpeg, double mbit_s, uint16_t *frame,
+                           size_t limit = 0) {
+    Link l = {};
+    l.jpeg         = &jpeg;
+    l.limit        = limit ? limit : jpeg.size();
+    l.bytes_per_us = mbit_s / 8.0;
+    l.first_row_us = -1;
+    l.t0           = Clock::now();
+
+    StreamResult r;
+    r.ok           = art_decode(link_read, &l, frame, &l.rows);
+    r.complete_ms  = link_now_us(&l) / 1000.0;
+    r.first_row_ms = (l.first_row_us < 0 ? link_now_us(&l) : l.first_row_us) / 1000.0;
+    r.waited_ms    = l.waited_us / 1000.0;
+    r.consumed     = l.pos;
+    return r;
+}
+
+// Median of BENCH_RUNS by completion time.
+static StreamResult stream_median(const std::vector<uint8_t> &jpeg, double mbit_s) {
+    StreamResult runs[BENCH_RUNS];
+    for (auto &r : runs) r = stream(jpeg, mbit_s, s_frame.data());
+    std::sort(runs, runs + BENCH_RUNS, [](const StreamResult &a, const StreamResult &b) {
+        return a.complete_ms < b.complete_ms;
+    });
+    return runs[BENCH_RUNS / 2];
+}
+
+// ---------------------------------------------------------------------------
+// Decoding
+// ---------------------------------------------------------------------------
+
+static void test_cover_640_decodes_to_the_crop() {
+    TEST_ASSERT_FALSE(s_cover_640.empty());
+    volatile int rows = 0;
+    TEST_ASSERT_TRUE(art_decode_jpeg(s_cover_640.data(), s_cover_640.size(),
+                                     s_frame.data(), &rows));
+    TEST_ASSERT_EQUAL_INT(ALBUM_ART_SIZE, rows);
+    check_patches(s_frame.data());
+}
+
+static void test_cover_300_is_upscaled_to_the_same_framing() {
+    TEST_ASSERT_FALSE(s_cover_300.empty());
+    volatile int rows = 0;
+    TEST_ASSERT_TRUE(art_decode_jpeg(s_cover_300.data(), s_cover_300.size(),
+                                     s_frame.data(), &rows));
+    TEST_ASSERT_EQUAL_INT(ALBUM_ART_SIZE, rows);
+    check_patches(s_frame.data());
+}
+
+static void test_decode_stops_below_the_crop() {
+    // The last 140 source rows are never needed, so their bytes are never read
+    StreamResult r = stream(s_cover_640, 0, s_frame.data());
+    TEST_ASSERT_TRUE(r.ok);
+    TEST_ASSERT_LESS_THAN(s_cover_640.size(), r.consumed);
+    char msg[64];
+    snprintf(msg, sizeof(msg), "read %u of %u bytes", (unsigned)r.consumed,
+             (unsigned)s_cover_640.size());
+    TEST_MESSAGE(msg);
+}
+
+static void test_streamed_frame_matches_in_memory() {
+    TEST_ASSERT_TRUE(art_decode_jpeg(s_cover_640.data(), s_cover_640.size(), s_ref.data(), nullptr));
+    StreamResult r = stream(s_cover_640, 4.0, s_frame.data());
+    TEST_ASSERT_TRUE(r.ok);
+    TEST_ASSERT_EQUAL_MEMORY(s_ref.data(), s_frame.data(), FRAME_PX * sizeof(uint16_t));
+}
+
+static void test_rows_land_while_the_body_arrives() {
+    // On a slow link the crop's first rows decode long before the last
+    StreamResult r = stream(s_cover_640, 1.0, s_frame.data());
+    TEST_ASSERT_TRUE(r.ok);
+    TEST_ASSERT_TRUE(r.first_row_ms < r.complete_ms / 2);
+}
+
+static void test_truncated_body_fails() {
+    StreamResult r = stream(s_cover_640, 0, s_frame.data(), s_cover_640.size() / 3);
+    TEST_ASSERT_FALSE(r.ok);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+static void test_benchmark_link_speeds() {
+    static const double kMbit[] = { 0, 16.0, 4.0, 1.0 };   // 0 = in memory
+
+    double decode_ms = 0;
+    for (double mbit : kMbit) {
+        StreamResult r = stream_median(s_cover_640, mbit);
+        TEST_ASSERT_TRUE(r.ok);
+        TEST_ASSERT_TRUE(r.first_row_ms <= r.complete_ms);
+
+        char msg[160];
+        if (mbit == 0) {
+            decode_ms = r.complete_ms;
+            snprintf(msg, sizeof(msg), "host, 640 px in memory: first row %.2f ms, complete %.2f ms",
+                     r.first_row_ms, r.complete_ms);
+        } else {
+            // Streaming overlaps the decode with the transfer and skips the
+            // tail: never slower than downloading the whole file first.
+            double download_ms = s_cover_640.size() * 8.0 / (mbit * 1000.0);
+            TEST_ASSERT_TRUE(r.complete_ms < download_ms + decode_ms);
+            snprintf(msg, sizeof(msg),
+                     "host, 640 px at %g Mbit/s: first row %.1f ms, complete %.1f ms "
+                     "(%.1f waiting); download-then-decode %.1f ms",
+                     mbit, r.first_row_ms, r.complete_ms, r.waited_ms, download_ms + decode_ms);
+        }
+        TEST_MESSAGE(msg);
+    }
+}
+
+static double decode_ms(const std::vector<uint8_t> &jpeg) {
+    const int runs = 20;
+    TEST_ASSERT_TRUE(art_decode_jpeg(jpeg.data(), jpeg.size(), s_frame.data(), nullptr));
+    auto t0 = Clock::now();
+    for (int i = 0; i < runs; i++) art_decode_jpeg(jpeg.data(), jpeg.size(), s_frame.data(), nullptr);
+    auto t1 = Clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / runs;
+}
+
+static void test_benchmark_decode_per_size() {
+    double ms_640 = decode_ms(s_cover_640);
+    double ms_300 = decode_ms(s_cover_300);
+    char msg[128];
+    snprintf(msg, sizeof(msg), "host: 640 px %.2f ms/cover (%u B), 300 px %.2f ms/cover (%u B)",
+             ms_640, (unsigned)s_cover_640.size(), ms_300, (unsigned)s_cover_300.size());
+    TEST_MESSAGE(msg);
+}
+
+int main() {
+    s_cover_640 = read_file("cover_640.jpg");
+    s_cover_300 = read_file("cover_300.jpg");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_cover_640_decodes_to_the_crop);
+    RUN_TEST(test_cover_300_is_upscaled_to_the_same_framing);
+    RUN_TEST(test_decode_stops_below_the_crop);
+    RUN_TEST(test_streamed_frame_matches_in_memory);
+    RUN_TEST(test_rows_land_while_the_body_arrives);
+    RUN_TEST(test_truncated_body_fails);
+    RUN_TEST(test_benchmark_link_speeds);
+    RUN_TEST(test_benchmark_decode_per_size);
+    return UNITY_END();
+}
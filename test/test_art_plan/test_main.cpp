@@ -0,0 +1,128 @@
+// Host tests for state/art_plan: Spotify URL rewriting and the cost model
+// that picks the 640 px or 300 px cover from measured fetch + decode times.
+#include <unity.h>
+#include "state/art_plan.h"
+#include "config.h"
+
+#include <string.h>
+
+#define LARGE_URL "https://i.scdn.co/image/ab67616d0000b273abc123"
+#define SMALL_URL "https://i.scdn.co/image/ab67616d00001e02abc123"
+#define THUMB_URL "https://i.scdn.co/image/ab67616d00004851abc123"
+
+static ArtPlan p;
+
+void setUp() { art_plan_init(&p, ART_SMALL_MAX_COST_PCT); }
+
+void tearDown() {}
+
+// Run n covers where each variant always costs the given time.
+static void run(int n, uint32_t large_ms, uint32_t small_ms, int counts[ART_VARIANT_COUNT]) {
+    counts[ART_VARIANT_LARGE] = counts[ART_VARIANT_SMALL] = 0;
+    for (int i = 0; i < n; i++) {
+        ArtVariant v = art_plan_choose(&p);
+        counts[v]++;
+        art_plan_record(&p, v, v == ART_VARIANT_SMALL ? small_ms : large_ms);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// URL rewriting
+// ---------------------------------------------------------------------------
+
+static void test_url_between_sizes() {
+    char out[128];
+    TEST_ASSERT_TRUE(art_plan_variant_url(LARGE_URL, ART_VARIANT_SMALL, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING(SMALL_URL, out);
+    TEST_ASSERT_TRUE(art_plan_variant_url(THUMB_URL, ART_VARIANT_LARGE, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING(LARGE_URL, out);
+    TEST_ASSERT_TRUE(art_plan_variant_url(LARGE_URL, ART_VARIANT_LARGE, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING(LARGE_URL, out);
+}
+
+static void test_url_not_rewritten() {
+    char out[128] = "untouched";
+    TEST_ASSERT_FALSE(art_plan_variant_url("https://i.scdn.co/image/ab67616d12345678abc",
+                                           ART_VARIANT_LARGE, out, sizeof(out)));
+    TEST_ASSERT_FALSE(art_plan_variant_url("http://example.com/cover.jpg",
+                                           ART_VARIANT_LARGE, out, sizeof(out)));
+    TEST_ASSERT_FALSE(art_plan_variant_url(nullptr, ART_VARIANT_LARGE, out, sizeof(out)));
+    TEST_ASSERT_FALSE(art_plan_variant_url(LARGE_URL, ART_VARIANT_SMALL, out, 10));
+    TEST_ASSERT_EQUAL_STRING("untouched", out);
+}
+
+// ---------------------------------------------------------------------------
+// Cost model
+// ---------------------------------------------------------------------------
+
+static void test_samples_both_before_choosing() {
+    int seen[ART_VARIANT_COUNT] = { 0, 0 };
+    for (int i = 0; i < 4; i++) {
+        ArtVariant v = art_plan_choose(&p);
+        seen[v]++;
+        art_plan_record(&p, v, 500);
+    }
+    TEST_ASSERT_EQUAL_INT(2, seen[ART_VARIANT_LARGE]);
+    TEST_ASSERT_EQUAL_INT(2, seen[ART_VARIANT_SMALL]);
+}
+
+static void test_small_wins_when_clearly_cheaper() {
+    int n[ART_VARIANT_COUNT];
+    run(200, 900, 300, n);
+    TEST_ASSERT_GREATER_THAN(n[ART_VARIANT_LARGE] * 8, n[ART_VARIANT_SMALL]);
+    TEST_ASSERT_GREATER_THAN(2, n[ART_VARIANT_LARGE]);   // still re-sampled
+}
+
+static void test_large_wins_unless_clearly_cheaper() {
+    int n[ART_VARIANT_COUNT];
+    run(200, 900, 800, n);   // small is 89% of large, above the threshold
+    TEST_ASSERT_GREATER_THAN(n[ART_VARIANT_SMALL] * 8, n[ART_VARIANT_LARGE]);
+}
+
+static void test_threshold_is_strict() {
+    // Exactly ART_SMALL_MAX_COST_PCT of the large cost is not cheap enough.
+    int n[ART_VARIANT_COUNT];
+    run(64, 1000, 10 * ART_SMALL_MAX_COST_PCT, n);
+    TEST_ASSERT_GREATER_THAN(n[ART_VARIANT_SMALL], n[ART_VARIANT_LARGE]);
+}
+
+static void test_explores_every_nth_cover() {
+    int n[ART_VARIANT_COUNT];
+    run(4, 900, 300, n);       // warm-up
+    run(ART_PLAN_EXPLORE * 10, 900, 300, n);
+    TEST_ASSERT_EQUAL_INT(10, n[ART_VARIANT_LARGE]);
+}
+
+static void test_follows_a_changing_network() {
+    int n[ART_VARIANT_COUNT];
+    run(100, 900, 300, n);     // slow link: small wins
+    run(200, 400, 380, n);     // fast link: decode dominates, large wins
+    ArtVariant last[8];
+    for (int i = 0; i < 8; i++) {
+        last[i] = art_plan_choose(&p);
+        art_plan_record(&p, last[i], last[i] == ART_VARIANT_SMALL ? 380 : 400);
+    }
+    int large = 0;
+    for (ArtVariant v : last) large += (v == ART_VARIANT_LARGE);
+    TEST_ASSERT_GREATER_OR_EQUAL(7, large);
+}
+
+static void test_record_ignores_bad_variant() {
+    art_plan_record(&p, ART_VARIANT_COUNT, 100);
+    TEST_ASSERT_EQUAL_UINT32(0, p.samples[ART_VARIANT_LARGE]);
+    TEST_ASSERT_EQUAL_UINT32(0, p.samples[ART_VARIANT_SMALL]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_url_between_sizes);
+    RUN_TEST(test_url_not_rewritten);
+    RUN_TEST(test_samples_both_before_choosing);
+    RUN_TEST(test_small_wins_when_clearly_cheaper);
+    RUN_TEST(test_large_wins_unless_clearly_cheaper);
+    RUN_TEST(test_threshold_is_strict);
+    RUN_TEST(test_explores_every_nth_cover);
+    RUN_TEST(test_follows_a_changing_network);
+    RUN_TEST(test_record_ignores_bad_variant);
+    return UNITY_END();
+}
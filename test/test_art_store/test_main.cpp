@@ -0,0 +1,282 @@
+// Host tests for state/art_store against a directory-backed ArtStoreFs:
+// LRU eviction, persistence across reopen, recovery from damaged files, and
+// that showing a stored cover does not rewrite the index.
+#include <unity.h>
+#include "state/art_store.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------------------------
+// Directory-backed ArtStoreFs
+// ---------------------------------------------------------------------------
+
+struct DirFs {
+    fs::path root;
+    int      index_writes = 0;   // writes of index.tmp, i.e. index rewrites
+};
+
+static DirFs s_dir;
+
+static fs::path path_of(void *ctx, const char *name) {
+    return ((DirFs *)ctx)->root / name;
+}
+
+static long dir_size(void *ctx, const char *name) {
+    std::error_code ec;
+    auto n = fs::file_size(path_of(ctx, name), ec);
+    return ec ? -1 : (long)n;
+}
+
+static bool dir_read(void *ctx, const char *name, void *buf, size_t len) {
+    std::ifstream f(path_of(ctx, name), std::ios::binary);
+    f.read((char *)buf, (std::streamsize)len);
+    return (size_t)f.gcount() == len;
+}
+
+static bool dir_write(void *ctx, const char *name, const void *buf, size_t len) {
+    if (std::string(name) == "index.tmp") ((DirFs *)ctx)->index_writes++;
+    std::ofstream f(path_of(ctx, name), std::ios::binary | std::ios::trunc);
+    f.write((const char *)buf, (std::streamsize)len);
+    return (bool)f;
+}
+
+static bool dir_remove(void *ctx, const char *name) {
+    std::error_code ec;
+    return fs::remove(path_of(ctx, name), ec);
+}
+
+static bool dir_rename(void *ctx, const char *from, const char *to) {
+    std::error_code ec;
+    fs::rename(path_of(ctx, from), path_of(ctx, to), ec);
+    return !ec;
+}
+
+static void dir_list(void *ctx, void (*cb)(void *arg, const char *name), void *arg) {
+    std::vector<std::string> names;   // the callback may delete files
+    for (auto &e : fs::directory_iterator(((DirFs *)ctx)->root)) {
+        names.push_back(e.path().filename().string());
+    }
+    for (auto &n : names) cb(arg, n.c_str());
+}
+
+static const ArtStoreFs s_fs = {
+    &s_dir, dir_size, dir_read, dir_write, dir_remove, dir_rename, dir_list
+};
+
+static bool exists(const char *name) { return fs::exists(s_dir.root / name); }
+
+static void put_file(const char *name, const std::string &bytes) {
+    std::ofstream f(s_dir.root / name, std::ios::binary | std::ios::trunc);
+    f << bytes;
+}
+
+void setUp() {
+    s_dir.root = fs::temp_directory_path() / "kefknob_art_store_test";
+    fs::remove_all(s_dir.root);
+    fs::create_directories(s_dir.root);
+    s_dir.index_writes = 0;
+}
+
+void tearDown() { fs::remove_all(s_dir.root); }
+
+static std::vector<char> cover(char fill, size_t len) { return std::vector<char>(len, fill); }
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+static void test_save_and_load() {
+    ArtStore s;
+    TEST_ASSERT_TRUE(art_store_open(&s, &s_fs, 1000));
+    auto a = cover('a', 300);
+    TEST_ASSERT_TRUE(art_store_save(&s, 1, a.data(), a.size()));
+    TEST_ASSERT_TRUE(exists("0000000000000001.jpg"));
+    TEST_ASSERT_EQUAL_UINT32(300, art_store_size(&s, 1));
+
+    std::vector<char> buf(300);
+    TEST_ASSERT_TRUE(art_store_load(&s, 1, buf.data(), buf.size()));
+    TEST_ASSERT_EQUAL_MEMORY(a.data(), buf.data(), 300);
+    TEST_ASSERT_FALSE(art_store_load(&s, 2, buf.data(), buf.size()));
+    TEST_ASSERT_EQUAL_UINT32(1, s.hits);
+    TEST_ASSERT_EQUAL_UINT32(1, s.misses);
+}
+
+static void test_larger_than_budget_is_refused() {
+    ArtStore s;
+    art_store_open(&s, &s_fs, 100);
+    auto a = cover('a', 101);
+    TEST_ASSERT_FALSE(art_store_save(&s, 1, a.data(), a.size()));
+    TEST_ASSERT_EQUAL_INT(0, s.count);
+}
+
+static void test_budget_evicts_least_recently_used() {
+    ArtStore s;
+    art_store_open(&s, &s_fs, 1000);
+    auto a = cover('a', 300);
+    art_store_save(&s, 1, a.data(), a.size());
+    art_store_save(&s, 2, a.data(), a.size());
+    art_store_save(&s, 3, a.data(), a.size());
+    std::vector<char> buf(300);
+    art_store_load(&s, 1, buf.data(), buf.size());   // 2 is now the oldest
+
+    TEST_ASSERT_TRUE(art_store_save(&s, 4, a.data(), a.size()));
+    TEST_ASSERT_EQUAL_UINT32(0, art_store_size(&s, 2));
+    TEST_ASSERT_FALSE(exists("0000000000000002.jpg"));
+    TEST_ASSERT_EQUAL_UINT32(300, art_store_size(&s, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, s.evictions);
+    TEST_ASSERT_TRUE(art_store_latest(&s) == 4);
+}
+
+static void test_entry_cap_evicts_least_recently_used() {
+    ArtStore s;
+    art_store_open(&s, &s_fs, 1 << 20);
+    auto a = cover('a', 10);
+    const int n = ART_STORE_MAX_ENTRIES + 12;
+    for (int i = 1; i <= n; i++) TEST_ASSERT_TRUE(art_store_save(&s, i, a.data(), a.size()));
+    TEST_ASSERT_EQUAL_INT(ART_STORE_MAX_ENTRIES, s.count);
+    TEST_ASSERT_EQUAL_UINT32(12, s.evictions);
+    TEST_ASSERT_EQUAL_UINT32(0, art_store_size(&s, 12));
+    TEST_ASSERT_EQUAL_UINT32(10, art_store_size(&s, 13));
+}
+
+static void test_reopen_keeps_covers_and_order() {
+    {
+        ArtStore s;
+        art_store_open(&s, &s_fs, 1000);
+        auto a = cover('a', 300);
+        art_store_save(&s, 1, a.data(), a.size());
+        art_store_save(&s, 2, a.data(), a.size());
+    }
+    ArtStore r;
+    TEST_ASSERT_TRUE(art_store_open(&r, &s_fs, 1000));
+    TEST_ASSERT_EQUAL_INT(2, r.count);
+    TEST_ASSERT_TRUE(art_store_latest(&r) == 2);
+    TEST_ASSERT_EQUAL_UINT32(300, art_store_size(&r, 1));
+}
+
+static void test_smaller_budget_on_reopen_evicts() {
+    {
+        ArtStore s;
+        art_store_open(&s, &s_fs, 1000);
+        auto a = cover('a', 300);
+        art_store_save(&s, 1, a.data(), a.size());
+        art_store_save(&s, 2, a.data(), a.size());
+    }
+    ArtStore r;
+    art_store_open(&r, &s_fs, 400);
+    TEST_ASSERT_EQUAL_INT(1, r.count);
+    TEST_ASSERT_EQUAL_UINT32(300, art_store_size(&r, 2));
+    TEST_ASSERT_FALSE(exists("0000000000000001.jpg"));
+}
+
+static void test_damaged_cover_and_orphans_are_swept() {
+    {
+        ArtStore s;
+        art_store_open(&s, &s_fs, 1000);
+        auto a = cover('a', 300);
+        art_store_save(&s, 1, a.data(), a.size());
+        art_store_save(&s, 2, a.data(), a.size());
+    }
+    put_file("0000000000000002.jpg", "x");        // truncated by a power cut
+    put_file("00000000000000ff.jpg", "orphan");   // written, never indexed
+
+    ArtStore r;
+    TEST_ASSERT_TRUE(art_store_open(&r, &s_fs, 1000));
+    TEST_ASSERT_EQUAL_INT(1, r.count);
+    TEST_ASSERT_EQUAL_UINT32(0, art_store_size(&r, 2));
+    TEST_ASSERT_FALSE(exists("00000000000000ff.jpg"));
+}
+
+static void test_corrupt_index_starts_empty() {
+    {
+        ArtStore s;
+        art_store_open(&s, &s_fs, 1000);
+        auto a = cover('a', 300);
+        art_store_save(&s, 1, a.data(), a.size());
+    }
+    put_file("index.bin", "garbage-garbage-garbage");
+
+    ArtStore r;
+    TEST_ASSERT_FALSE(art_store_open(&r, &s_fs, 1000));
+    TEST_ASSERT_EQUAL_INT(0, r.count);
+    TEST_ASSERT_FALSE(exists("0000000000000001.jpg"));
+    auto a = cover('a', 10);
+    TEST_ASSERT_TRUE(art_store_save(&r, 5, a.data(), a.size()));   // still usable
+}
+
+static void test_load_does_not_rewrite_index() {
+    ArtStore s;
+    art_store_open(&s, &s_fs, 1000);
+    auto a = cover('a', 300);
+    art_store_save(&s, 1, a.data(), a.size());
+    art_store_save(&s, 2, a.data(), a.size());
+    int writes = s_dir.index_writes;
+
+    std::vector<char> buf(300);
+    for (int i = 0; i < 10; i++) art_store_load(&s, 1, buf.data(), buf.size());
+    TEST_ASSERT_EQUAL_INT(writes, s_dir.index_writes);
+    TEST_ASSERT_TRUE(s.recency_dirty);
+    TEST_ASSERT_TRUE(art_store_latest(&s) == 1);
+}
+
+static void test_flush_writes_recency_once() {
+    ArtStore s;
+    art_store_open(&s, &s_fs, 1000);
+    auto a = cover('a', 300);
+    art_store_save(&s, 1, a.data(), a.size());
+    art_store_save(&s, 2, a.data(), a.size());
+    int writes = s_dir.index_writes;
+
+    TEST_ASSERT_TRUE(art_store_flush(&s));            // nothing to write
+    TEST_ASSERT_EQUAL_INT(writes, s_dir.index_writes);
+
+    std::vector<char> buf(300);
+    art_store_load(&s, 1, buf.data(), buf.size());
+    TEST_ASSERT_TRUE(art_store_flush(&s));
+    TEST_ASSERT_EQUAL_INT(writes + 1, s_dir.index_writes);
+    TEST_ASSERT_FALSE(s.recency_dirty);
+    TEST_ASSERT_TRUE(art_store_flush(&s));
+    TEST_ASSERT_EQUAL_INT(writes + 1, s_dir.index_writes);
+
+    ArtStore r;
+    art_store_open(&r, &s_fs, 1000);
+    TEST_ASSERT_TRUE(art_store_latest(&r) == 1);      // flushed recency survived
+}
+
+static void test_save_carries_pending_recency() {
+    ArtStore s;
+    art_store_open(&s, &s_fs, 1000);
+    auto a = cover('a', 300);
+    art_store_save(&s, 1, a.data(), a.size());
+    art_store_save(&s, 2, a.data(), a.size());
+    std::vector<char> buf(300);
+    art_store_load(&s, 1, buf.data(), buf.size());
+    art_store_save(&s, 3, a.data(), a.size());        // index written anyway
+    TEST_ASSERT_FALSE(s.recency_dirty);
+
+    ArtStore r;
+    art_store_open(&r, &s_fs, 700);                   // room for two: drops 2
+    TEST_ASSERT_EQUAL_UINT32(0, art_store_size(&r, 2));
+    TEST_ASSERT_EQUAL_UINT32(300, art_store_size(&r, 1));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_save_and_load);
+    RUN_TEST(test_larger_than_budget_is_refused);
+    RUN_TEST(test_budget_evicts_least_recently_used);
+    RUN_TEST(test_entry_cap_evicts_least_recently_used);
+    RUN_TEST(test_reopen_keeps_covers_and_order);
+    RUN_TEST(test_smaller_budget_on_reopen_evicts);
+    RUN_TEST(test_damaged_cover_and_orphans_are_swept);
+    RUN_TEST(test_corrupt_index_starts_empty);
+    RUN_TEST(test_load_does_not_rewrite_index);
+    RUN_TEST(test_flush_writes_recency_once);
+    RUN_TEST(test_save_carries_pending_recency);
+    return UNITY_END();
+}
@@ -0,0 +1,226 @@
+// Host tests for state/auto_level: volume trajectories from a simulated
+// room (ambient floor with jitter, speech bursts, speaker leakage into the
+// mic) fed in 32 ms blocks and polled like controlTask does.
+#include <unity.h>
+#include "state/auto_level.h"
+#include "config.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <functional>
+#include <random>
+#include <vector>
+
+void setUp() {}
+
+void tearDown() {}
+
+// ---------------------------------------------------------------------------
+// Room simulation
+// ---------------------------------------------------------------------------
+
+struct Span { double t0, t1; };
+
+struct Scenario {
+    double len_s;
+    std::function<double(double)> room_db;     // ambient floor at t
+    std::vector<Span> speech;                  // +18 dB bursts
+    std::vector<Span> paused;                  // speaker silent
+    std::vector<std::pair<double, int>> knob;  // user sets the volume
+    unsigned seed;
+};
+
+struct Sample {
+    double t;
+    int    volume;
+    bool   paused;
+};
+
+struct Trajectory {
+    std::vector<Sample> samples;   // one per second
+    uint32_t nudges;
+    int      steps_over_one;       // auto-level moves larger than one step
+    int      moves_while_paused;
+    int      final_volume;
+
+    int volume_at(double t) const {
+        for (const Sample &s : samples) if (s.t >= t) return s.volume;
+        return final_volume;
+    }
+    int max_between(double t0, double t1) const {
+        int m = -1;
+        for (const Sample &s : samples) if (s.t >= t0 && s.t < t1 && s.volume > m) m = s.volume;
+        return m;
+    }
+    int min_between(double t0, double t1) const {
+        int m = 1000;
+        for (const Sample &s : samples) if (s.t >= t0 && s.t < t1 && s.volume < m) m = s.volume;
+        return m;
+    }
+};
+
+static bool inside(const std::vector<Span> &v, double t) {
+    for (const Span &s : v) if (t >= s.t0 && t < s.t1) return true;
+    return false;
+}
+
+static double power(double db) { return pow(10.0, db / 10.0); }
+
+static Trajectory run(const Scenario &sc) {
+    std::mt19937 rng(sc.seed);
+    std::normal_distribution<double> jitter(0.0, 2.0);
+    AutoLevel al;
+    auto_level_init(&al, 0);
+
+    Trajectory tr = {};
+    int volume = -1;
+    size_t knob = 0;
+    for (uint32_t ms = 0; ms < sc.len_s * 1000; ms += 32) {
+        double t = ms / 1000.0;
+        while (knob < sc.knob.size() && t >= sc.knob[knob].first) volume = sc.knob[knob++].second;
+        bool paused = inside(sc.paused, t);
+
+        // The KEF moves about 0.5 dB per step at the mic
+        double room  = sc.room_db(t) + jitter(rng) + (inside(sc.speech, t) ? 18.0 : 0.0);
+        double music = 20.0 + 0.5 * volume + 6.0 * sin(t * 3.1) + jitter(rng);
+        double p     = power(room) + (paused ? 0.0 : power(music));
+        auto_level_on_block(&al, (float)sqrt(p), paused, ms);
+
+        if (ms % 64 == 0) {   // controlTask sees every other block
+            int v = auto_level_poll(&al, volume, !paused, ms);
+            if (v >= 0) {
+                if (abs(v - volume) > 1) tr.steps_over_one++;
+                if (paused) tr.moves_while_paused++;
+                volume = v;
+            }
+        }
+        if (ms % 1000 < 32) tr.samples.push_back({ t, volume, paused });
+    }
+    tr.nudges       = al.nudges;
+    tr.final_volume = volume;
+    return tr;
+}
+
+static void report(const char *name, const Trajectory &tr) {
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%s: %u nudges, final volume %d", name,
+             (unsigned)tr.nudges, tr.final_volume);
+    TEST_MESSAGE(msg);
+}
+
+static void assert_well_behaved(const Trajectory &tr) {
+    TEST_ASSERT_EQUAL_INT(0, tr.steps_over_one);
+    TEST_ASSERT_EQUAL_INT(0, tr.moves_while_paused);
+}
+
+// ---------------------------------------------------------------------------
+// Unit behaviour
+// ---------------------------------------------------------------------------
+
+static void test_nothing_without_a_volume() {
+    AutoLevel al;
+    auto_level_init(&al, 0);
+    for (uint32_t ms = 0; ms < 20000; ms += 32) auto_level_on_block(&al, 100.0f, true, ms);
+    TEST_ASSERT_TRUE(al.have_noise);
+    TEST_ASSERT_EQUAL_INT(-1, auto_level_poll(&al, -1, true, 20000));
+    TEST_ASSERT_EQUAL_INT(-1, auto_level_target(&al));
+}
+
+static void test_room_only_measured_once_speaker_settles() {
+    AutoLevel al;
+    auto_level_init(&al, 0);
+    uint32_t ms = 0;
+    for (; ms < 20000; ms += 32) auto_level_on_block(&al, 100.0f, false, ms);
+    TEST_ASSERT_FALSE(al.have_noise);   // music alone never seeds the estimate
+    for (; ms < 20000 + AUTO_LEVEL_SETTLE_MS; ms += 32) auto_level_on_block(&al, 100.0f, true, ms);
+    TEST_ASSERT_FALSE(al.have_noise);   // speaker may still be ringing out
+    for (; ms < 20000 + AUTO_LEVEL_SETTLE_MS + 3000; ms += 32) auto_level_on_block(&al, 100.0f, true, ms);
+    TEST_ASSERT_TRUE(al.have_noise);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 40.0f, al.noise_db);   // 100 counts RMS
+}
+
+// ---------------------------------------------------------------------------
+// Trajectories
+// ---------------------------------------------------------------------------
+
+static void test_dishwasher_raises_then_returns() {
+    // Quiet room; +14 dB from 3 to 10 min, with pauses that let the mic hear it.
+    Scenario sc = { 900, [](double t) { return (t >= 180 && t < 600) ? 44.0 : 30.0; },
+                    {}, { { 0, 20 }, { 240, 255 }, { 420, 430 }, { 660, 675 } }, { { 5, 30 } }, 1 };
+    Trajectory tr = run(sc);
+    report("dishwasher", tr);
+    assert_well_behaved(tr);
+
+    TEST_ASSERT_EQUAL_INT(30, tr.max_between(0, 240));     // unnoticed until a pause
+    TEST_ASSERT_EQUAL_INT(40, tr.volume_at(320));          // +10 steps, the range limit
+    TEST_ASSERT_LESS_OR_EQUAL(30 + AUTO_LEVEL_RANGE, tr.max_between(0, 900));
+    TEST_ASSERT_EQUAL_INT(30, tr.volume_at(720));          // back to the user's setting
+    TEST_ASSERT_EQUAL_INT(30, tr.final_volume);
+}
+
+static void test_chatter_is_ignored() {
+    // Steady room; speech bursts while paused and while playing.
+    Scenario sc = { 600, [](double) { return 32.0; },
+                    { { 30, 33 }, { 45, 47 }, { 100, 104 }, { 130, 131 }, { 250, 256 },
+                      { 300, 302 }, { 305, 309 } },
+                    { { 0, 60 }, { 240, 320 } }, { { 5, 35 } }, 2 };
+    Trajectory tr = run(sc);
+    report("chatter", tr);
+    TEST_ASSERT_EQUAL_UINT32(0, tr.nudges);
+    TEST_ASSERT_EQUAL_INT(35, tr.min_between(5, 600));
+    TEST_ASSERT_EQUAL_INT(35, tr.max_between(5, 600));
+}
+
+static void test_music_cannot_raise_the_estimate() {
+    // No pauses after the first: the room gets louder, then quieter.
+    Scenario sc = { 900, [](double t) { return t < 60 ? 36.0 : (t < 400 ? 46.0 : 26.0); },
+                    {}, { { 0, 30 } }, { { 5, 30 } }, 3 };
+    Trajectory tr = run(sc);
+    report("music only", tr);
+    assert_well_behaved(tr);
+    TEST_ASSERT_EQUAL_INT(30, tr.max_between(5, 900));
+}
+
+static void test_knob_re_anchors() {
+    // Noise rises, auto-level turns up, then the user turns it down.
+    Scenario sc = { 700, [](double t) { return t >= 120 ? 42.0 : 30.0; },
+                    {}, { { 0, 20 }, { 150, 165 } }, { { 5, 30 }, { 300, 28 } }, 4 };
+    Trajectory tr = run(sc);
+    report("knob", tr);
+    assert_well_behaved(tr);
+    TEST_ASSERT_GREATER_THAN(35, tr.max_between(150, 300));   // had turned up
+    TEST_ASSERT_EQUAL_INT(28, tr.min_between(301, 700));      // user's choice holds
+    TEST_ASSERT_EQUAL_INT(28, tr.max_between(301, 700));
+}
+
+static void test_stays_inside_auto_bounds() {
+    // User above AUTO_LEVEL_VOL_MAX, room falls: auto-level only comes down.
+    Scenario loud = { 400, [](double t) { return t >= 100 ? 24.0 : 36.0; },
+                      {}, { { 0, 20 }, { 130, 145 } }, { { 5, 70 } }, 5 };
+    Trajectory tr = run(loud);
+    report("loud setting", tr);
+    assert_well_behaved(tr);
+    TEST_ASSERT_LESS_OR_EQUAL(70, tr.max_between(5, 400));
+    TEST_ASSERT_LESS_OR_EQUAL(AUTO_LEVEL_VOL_MAX, tr.final_volume);
+
+    // User near AUTO_LEVEL_VOL_MIN, room falls further.
+    Scenario quiet = { 400, [](double t) { return t >= 100 ? 20.0 : 36.0; },
+                       {}, { { 0, 20 }, { 130, 145 } }, { { 5, 8 } }, 6 };
+    tr = run(quiet);
+    report("quiet setting", tr);
+    assert_well_behaved(tr);
+    TEST_ASSERT_GREATER_THAN(0, (int)tr.nudges);
+    TEST_ASSERT_EQUAL_INT(AUTO_LEVEL_VOL_MIN, tr.min_between(5, 400));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_nothing_without_a_volume);
+    RUN_TEST(test_room_only_measured_once_speaker_settles);
+    RUN_TEST(test_dishwasher_raises_then_returns);
+    RUN_TEST(test_chatter_is_ignored);
+    RUN_TEST(test_music_cannot_raise_the_estimate);
+    RUN_TEST(test_knob_re_anchors);
+    RUN_TEST(test_stays_inside_auto_bounds);
+    return UNITY_END();
+}
@@ -0,0 +1,209 @@
+// Host tests for audio/beat_tracker, fed through audio/spectrum at the mic's
+// settings like mic_pdm does.  The fixtures next to this file are synthetic
+// drum loops (kick/snare/hi-hat with timing jitter over a chord pad and a
+// noise floor) at known tempos: 6 s, 16 kHz mono, G.711 µ-law to keep them
+// small.  padnoise_000 is the pad and noise alone.
+#include <unity.h>
+#include "audio/beat_tracker.h"
+#include "audio/spectrum.h"
+#include "config.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define BLOCK_MS     (SPECTRUM_N * 1000.0f / MIC_SAMPLE_RATE)
+#define SETTLE_S     4.0f     // tempo and beats are judged after this
+#define TEMPO_TOL    0.04f    // relative
+#define BEAT_TOL_S   0.07f    // beat within this of the true time
+
+static Spectrum    s_spectrum;
+static BeatTracker s_beat;
+
+void setUp() {
+    spectrum_init(&s_spectrum, MIC_BANDS, MIC_BAND_LO_HZ, MIC_BAND_HI_HZ, MIC_SAMPLE_RATE);
+    beat_init(&s_beat, BLOCK_MS);
+}
+
+void tearDown() {}
+
+// ---------------------------------------------------------------------------
+// WAV fixtures
+// ---------------------------------------------------------------------------
+
+static int16_t ulaw_decode(uint8_t u) {
+    u = ~u;
+    int t = (((u & 0x0F) << 3) + 0x84) << ((u >> 4) & 7);
+    return (int16_t)((u & 0x80) ? 0x84 - t : t - 0x84);
+}
+
+// Mono 16-bit PCM or 8-bit µ-law at MIC_SAMPLE_RATE; empty on anything else.
+static std::vector<int16_t> read_wav(const char *name) {
+    std::string path = __FILE__;
+    path = path.substr(0, path.find_last_of("/\\") + 1) + name;
+
+    std::vector<int16_t> pcm;
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) return pcm;
+
+    char     id[4];
+    uint32_t len;
+    uint16_t format = 0, channels = 0, bits = 0;
+    uint32_t rate = 0;
+    fseek(f, 12, SEEK_SET);   // "RIFF" <size> "WAVE"
+    while (fread(id, 1, 4, f) == 4 && fread(&len, 4, 1, f) == 1) {
+        if (!memcmp(id, "fmt ", 4)) {
+            uint8_t fmt[16];
+            if (len < 16 || fread(fmt, 1, 16, f) != 16) break;
+            memcpy(&format, fmt, 2);
+            memcpy(&channels, fmt + 2, 2);
+            memcpy(&rate, fmt + 4, 4);
+            memcpy(&bits, fmt + 14, 2);
+            fseek(f, (long)(len - 16 + (len & 1)), SEEK_CUR);
+        } else if (!memcmp(id, "data", 4)) {
+            if (channels != 1 || rate != MIC_SAMPLE_RATE) break;
+            if (format == 1 && bits == 16) {
+                pcm.resize(len / 2);
+                if (fread(pcm.data(), 2, pcm.size(), f) != pcm.size()) pcm.clear();
+            } else if (format == 7 && bits == 8) {
+                std::vector<uint8_t> raw(len);
+                if (fread(raw.data(), 1, len, f) == len) {
+                    for (uint8_t u : raw) pcm.push_back(ulaw_decode(u));
+                }
+            }
+            break;
+        } else {
+            fseek(f, (long)(len + (len & 1)), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    return pcm;
+}
+
+// ---------------------------------------------------------------------------
+// Running a clip
+// ---------------------------------------------------------------------------
+
+struct ClipResult {
+    float median_bpm;       // over the blocks after SETTLE_S
+    float f_measure;        // beats after SETTLE_S against the true grid
+    int   beats_in_silence; // beats later than BEAT_HOLD_MS into trailing silence
+};
+
+static float block_end_s(size_t block) {
+    return (block + 1) * (float)SPECTRUM_N / MIC_SAMPLE_RATE;
+}
+
+static ClipResult run_clip(const std::vector<int16_t> &pcm, float true_bpm) {
+    std::vector<float> bpms, beats;
+    size_t blocks = pcm.size() / SPECTRUM_N;
+    for (size_t i = 0; i < blocks; i++) {
+        SpectrumFrame f;
+        spectrum_run(&s_spectrum, &pcm[i * SPECTRUM_N], SPECTRUM_N, &f);
+        bool beat = beat_update(&s_beat, f.flux);
+        float t = block_end_s(i);
+        if (t < SETTLE_S) continue;
+        bpms.push_back(beat_bpm(&s_beat));
+        if (beat) beats.push_back(t - BLOCK_MS / 2000.0f);   // block centre
+    }
+
+    ClipResult r = { 0.0f, 0.0f, 0 };
+    std::sort(bpms.begin(), bpms.end());
+    if (!bpms.empty()) r.median_bpm = bpms[bpms.size() / 2];
+
+    if (true_bpm > 0) {
+        float period = 60.0f / true_bpm, end = block_end_s(blocks - 1);
+        int hits = 0, truth = 0;
+        std::vector<bool> used((size_t)(end / period) + 2, false);
+        for (float t : beats) {
+            int k = (int)lrintf(t / period);
+            if (fabsf(t - k * period) < BEAT_TOL_S && !used[k]) { used[k] = true; hits++; }
+        }
+        for (int k = 0; k * period < end - BEAT_TOL_S; k++) truth += (k * period >= SETTLE_S);
+        float precision = beats.empty() ? 0.0f : (float)hits / beats.size();
+        float recall    = truth ? (float)hits / truth : 0.0f;
+        r.f_measure = (precision + recall > 0) ? 2 * precision * recall / (precision + recall) : 0.0f;
+    }
+
+    // The music stops: beats must stop once BEAT_HOLD_MS passes without onsets.
+    static const int16_t silence[SPECTRUM_N] = {};
+    for (int i = 0; i < (int)(4000.0f / BLOCK_MS); i++) {
+        SpectrumFrame f;
+        spectrum_run(&s_spectrum, silence, SPECTRUM_N, &f);
+        if (beat_update(&s_beat, f.flux) && i * BLOCK_MS > BEAT_HOLD_MS + BLOCK_MS) r.beats_in_silence++;
+    }
+    return r;
+}
+
+static void check_clip(const char *name, float true_bpm, bool check_phase = true) {
+    std::vector<int16_t> pcm = read_wav(name);
+    TEST_ASSERT_GREATER_THAN_MESSAGE(0, (int)pcm.size(), name);
+    ClipResult r = run_clip(pcm, true_bpm);
+
+    char msg[112];
+    snprintf(msg, sizeof(msg), "%s: %.1f BPM (true %.0f), beat F %.2f, %u onsets",
+             name, r.median_bpm, true_bpm, r.f_measure, (unsigned)s_beat.onsets);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_FLOAT_WITHIN(TEMPO_TOL * true_bpm, true_bpm, r.median_bpm);
+    if (check_phase) TEST_ASSERT_GREATER_THAN(0.8f, r.f_measure);
+    TEST_ASSERT_EQUAL_INT(0, r.beats_in_silence);
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+static void test_flux_impulses_at_120_bpm() {
+    // 500 ms apart = 15.625 blocks, so onsets fall between grid points.
+    int beats = 0;
+    for (int i = 0; i < 400; i++) {
+        float t = i * BLOCK_MS, phase = fmodf(t, 500.0f);
+        float flux = (phase < BLOCK_MS) ? 1000.0f : 10.0f + (i * 7919 % 13);
+        beats += beat_update(&s_beat, flux);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(TEMPO_TOL * 120.0f, 120.0f, beat_bpm(&s_beat));
+    TEST_ASSERT_GREATER_THAN(15, beats);
+}
+
+static void test_no_tempo_before_evidence() {
+    for (int i = 0; i < 20; i++) beat_update(&s_beat, 10.0f);
+    TEST_ASSERT_EQUAL_INT(0, (int)beat_bpm(&s_beat));
+    TEST_ASSERT_EQUAL_UINT32(0, s_beat.beats);
+}
+
+static void test_ballad_72() { check_clip("ballad_072.wav", 72.0f); }
+static void test_house_120() { check_clip("house_120.wav", 120.0f); }
+static void test_edm_128()   { check_clip("edm_128.wav", 128.0f); }
+
+// The trap pattern's ghost kick three-quarters into the beat wins the
+// phase at first; the loop only pulls onto the beat after ~9 s, longer
+// than the clip, so this one checks the tempo alone.
+static void test_trap_140()  { check_clip("trap_140.wav", 140.0f, false); }
+
+static void test_pad_and_noise_has_no_beat() {
+    std::vector<int16_t> pcm = read_wav("padnoise_000.wav");
+    TEST_ASSERT_GREATER_THAN(0, (int)pcm.size());
+    ClipResult r = run_clip(pcm, 0.0f);
+    char msg[80];
+    snprintf(msg, sizeof(msg), "padnoise_000.wav: %.1f BPM, %u beats, %u onsets",
+             r.median_bpm, (unsigned)s_beat.beats, (unsigned)s_beat.onsets);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_INT(0, (int)r.median_bpm);
+    TEST_ASSERT_EQUAL_INT(0, r.beats_in_silence);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_flux_impulses_at_120_bpm);
+    RUN_TEST(test_no_tempo_before_evidence);
+    RUN_TEST(test_ballad_72);
+    RUN_TEST(test_house_120);
+    RUN_TEST(test_edm_128);
+    RUN_TEST(test_trap_140);
+    RUN_TEST(test_pad_and_noise_has_no_beat);
+    return UNITY_END();
+}
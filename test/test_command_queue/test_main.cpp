@@ -0,0 +1,153 @@
+// Host tests for state/command_queue: per-class coalescing, overflow, and a
+// two-thread stress run of the SPSC ring.
+#include <unity.h>
+#include "state/command_queue.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+static CmdBatch drain() {
+    CmdBatch b;
+    cmd_queue_drain(&b);
+    return b;
+}
+
+void setUp() {
+    CmdBatch b;
+    while (cmd_queue_drain(&b)) {}   // the ring is global state
+}
+
+void tearDown() {}
+
+// ---------------------------------------------------------------------------
+// Coalescing
+// ---------------------------------------------------------------------------
+
+static void test_empty_drain_resets_batch() {
+    CmdBatch b;
+    memset(&b, 0x5A, sizeof(b));
+    TEST_ASSERT_FALSE(cmd_queue_drain(&b));
+    TEST_ASSERT_EQUAL_INT(0, b.skip);
+    TEST_ASSERT_FALSE(b.play_pause);
+    TEST_ASSERT_EQUAL_INT(-1, b.mute);
+    TEST_ASSERT_EQUAL_INT(CMD_NONE, b.source);
+    TEST_ASSERT_EQUAL_INT(0, b.light[0]);
+}
+
+static void test_skips_are_counted() {
+    cmd_queue_push(CMD_NEXT, 10);
+    cmd_queue_push(CMD_NEXT, 11);
+    cmd_queue_push(CMD_PREVIOUS, 12);
+    cmd_queue_push(CMD_NEXT, 13);
+    CmdBatch b = drain();
+    TEST_ASSERT_EQUAL_INT(2, b.skip);
+    TEST_ASSERT_EQUAL_UINT32(10, b.queued_ms);   // oldest tap
+}
+
+static void test_toggles_collapse_by_parity() {
+    cmd_queue_push(CMD_PLAY_PAUSE, 0);
+    cmd_queue_push(CMD_PLAY_PAUSE, 0);
+    cmd_queue_push(CMD_POWER_TOGGLE, 0);
+    cmd_queue_push(CMD_LIGHT_TOGGLE, 0);
+    cmd_queue_push(CMD_LIGHT_TOGGLE, 0);
+    cmd_queue_push(CMD_LIGHT_TOGGLE, 0);
+    CmdBatch b = drain();
+    TEST_ASSERT_FALSE(b.play_pause);
+    TEST_ASSERT_TRUE(b.power_toggle);
+    TEST_ASSERT_TRUE(b.light_toggle);
+}
+
+static void test_latest_wins() {
+    cmd_queue_push(CMD_MUTE, 0);
+    cmd_queue_push(CMD_UNMUTE, 0);
+    cmd_queue_push(CMD_SOURCE_USB, 0);
+    cmd_queue_push(CMD_WAKE_WIFI, 0);
+    cmd_queue_push(CMD_LIGHT_SET, 0, "{\"brightness\":10}");
+    cmd_queue_push(CMD_LIGHT_SET, 0, "{\"brightness\":20}");
+    CmdBatch b = drain();
+    TEST_ASSERT_EQUAL_INT(0, b.mute);
+    TEST_ASSERT_EQUAL_INT(CMD_WAKE_WIFI, b.source);
+    TEST_ASSERT_EQUAL_STRING("{\"brightness\":20}", b.light);
+}
+
+static void test_full_ring_drops_and_counts() {
+    uint32_t dropped = cmd_queue_dropped();
+    for (int i = 0; i < CMD_QUEUE_LEN; i++) TEST_ASSERT_TRUE(cmd_queue_push(CMD_NEXT, 0));
+    TEST_ASSERT_EQUAL_UINT32(CMD_QUEUE_LEN, cmd_queue_pending());
+    TEST_ASSERT_FALSE(cmd_queue_push(CMD_NEXT, 0));
+    TEST_ASSERT_EQUAL_UINT32(dropped + 1, cmd_queue_dropped());
+    TEST_ASSERT_EQUAL_INT(CMD_QUEUE_LEN, drain().skip);
+    TEST_ASSERT_EQUAL_UINT32(0, cmd_queue_pending());
+}
+
+static void test_command_names() {
+    TEST_ASSERT_EQUAL_INT(CMD_PLAY_PAUSE, cmd_from_string("pause"));
+    TEST_ASSERT_EQUAL_INT(CMD_WAKE_USB, cmd_from_string("pwr_usb"));
+    TEST_ASSERT_EQUAL_INT(CMD_NONE, cmd_from_string("bogus"));
+}
+
+// ---------------------------------------------------------------------------
+// Two-thread stress: one producer, one consumer, as on the device
+// ---------------------------------------------------------------------------
+
+static void test_spsc_stress() {
+    const int N = 200000;
+    std::atomic<bool> done{false};
+    long pushed_next = 0;
+
+    std::thread producer([&] {
+        for (int i = 0; i < N; i++) {
+            CmdType t = (i % 3 == 0) ? CMD_LIGHT_SET : CMD_NEXT;
+            char p[48];
+            snprintf(p, sizeof(p), "{\"v\":%d,\"check\":%d}", i, i);
+            while (!cmd_queue_push(t, (uint32_t)i, p)) std::this_thread::yield();
+            if (t == CMD_NEXT) pushed_next++;
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    long drained_next = 0;
+    int  last_light = -1;
+    bool torn = false, reordered = false;
+    for (;;) {
+        bool finished = done.load(std::memory_order_acquire);
+        CmdBatch b;
+        if (cmd_queue_drain(&b)) {
+            drained_next += b.skip;
+            if (b.light[0]) {
+                int v = -1, check = -2;
+                if (sscanf(b.light, "{\"v\":%d,\"check\":%d}", &v, &check) != 2 || v != check)
+                    torn = true;
+                if (v <= last_light) reordered = true;
+                last_light = v;
+            }
+        } else if (finished) {
+            break;
+        }
+    }
+    producer.join();
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%ld next taps pushed, %ld drained, %u dropped",
+             pushed_next, drained_next, (unsigned)cmd_queue_dropped());
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_INT(pushed_next, drained_next);   // producer retries, so no loss
+    TEST_ASSERT_FALSE(torn);
+    TEST_ASSERT_FALSE(reordered);
+    TEST_ASSERT_EQUAL_INT((N - 1) / 3 * 3, last_light);  // the final payload arrives
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_drain_resets_batch);
+    RUN_TEST(test_skips_are_counted);
+    RUN_TEST(test_toggles_collapse_by_parity);
+    RUN_TEST(test_latest_wins);
+    RUN_TEST(test_full_ring_drops_and_counts);
+    RUN_TEST(test_command_names);
+    RUN_TEST(test_spsc_stress);
+    return UNITY_END();
+}
@@ -0,0 +1,203 @@
+// Host tests for network/json_arena: the allocator's rewind and in-place
+// paths, and KEF replies parsed through kef_parse's filters — the ones
+// kef_api uses — with no heap allocation once warm.
+#include <unity.h>
+#include "network/json_arena.h"
+#include "network/kef_parse.h"
+
+#include <string>
+
+// KEF_JSON_ARENA_SIZE is sized for the ESP32's 4-byte pointers; host
+// pointers and ArduinoJson slots are twice that, so the host arena is too.
+#define HOST_ARENA_SIZE (4 * 4096)
+
+void setUp() {}
+
+void tearDown() {}
+
+// ---------------------------------------------------------------------------
+// Allocator
+// ---------------------------------------------------------------------------
+
+static void test_blocks_come_from_the_arena() {
+    JsonArena<256> a;
+    void *p = a.allocate(10);
+    void *q = a.allocate(20);
+    TEST_ASSERT_TRUE(p != nullptr && q != nullptr);
+    TEST_ASSERT_TRUE((uint8_t *)q > (uint8_t *)p);
+    TEST_ASSERT_EQUAL_INT(0, (int)((uintptr_t)p % sizeof(void *)));
+    TEST_ASSERT_EQUAL_INT(0, (int)((uintptr_t)q % sizeof(void *)));
+    TEST_ASSERT_EQUAL_UINT32(0, a.spills());
+    a.deallocate(q);
+    a.deallocate(p);
+}
+
+static void test_freeing_everything_rewinds() {
+    JsonArena<256> a;
+    void *p = a.allocate(40);
+    void *q = a.allocate(40);
+    a.deallocate(p);                 // not the newest: space stays taken
+    TEST_ASSERT_GREATER_THAN(0, (int)a.used());
+    a.deallocate(q);
+    TEST_ASSERT_EQUAL_INT(0, (int)a.used());
+}
+
+static void test_newest_block_freed_in_place() {
+    JsonArena<256> a;
+    void *p = a.allocate(16);
+    size_t after_p = a.used();
+    void *q = a.allocate(64);
+    a.deallocate(q);
+    TEST_ASSERT_EQUAL_INT((int)after_p, (int)a.used());
+    a.deallocate(p);
+}
+
+static void test_newest_block_resized_in_place() {
+    JsonArena<256> a;
+    void *p = a.allocate(16);
+    memset(p, 0x5A, 16);
+    void *grown = a.reallocate(p, 100);
+    TEST_ASSERT_TRUE(grown == p);
+    void *shrunk = a.reallocate(p, 8);
+    TEST_ASSERT_TRUE(shrunk == p);
+    TEST_ASSERT_EQUAL_INT(0x5A, ((uint8_t *)p)[7]);
+    TEST_ASSERT_EQUAL_UINT32(0, a.spills());
+    a.deallocate(p);
+}
+
+static void test_older_block_grows_by_copy() {
+    JsonArena<256> a;
+    void *p = a.allocate(16);
+    memcpy(p, "0123456789abcde", 16);
+    void *q = a.allocate(16);
+    void *grown = a.reallocate(p, 48);
+    TEST_ASSERT_TRUE(grown != p);
+    TEST_ASSERT_EQUAL_STRING("0123456789abcde", (const char *)grown);
+    TEST_ASSERT_EQUAL_UINT32(0, a.spills());
+    a.deallocate(q);
+    a.deallocate(grown);
+    TEST_ASSERT_EQUAL_INT(0, (int)a.used());
+}
+
+static void test_overflow_spills_to_heap() {
+    JsonArena<64> a;
+    void *p = a.allocate(200);
+    TEST_ASSERT_TRUE(p != nullptr);
+    TEST_ASSERT_EQUAL_UINT32(1, a.spills());
+    TEST_ASSERT_EQUAL_INT(0, (int)a.used());
+    memset(p, 0, 200);               // really 200 usable bytes
+    void *q = a.reallocate(p, 400);
+    TEST_ASSERT_EQUAL_UINT32(2, a.spills());
+    a.deallocate(q);
+    void *r = a.allocate(16);        // the arena itself is still usable
+    TEST_ASSERT_EQUAL_UINT32(2, a.spills());
+    a.deallocate(r);
+}
+
+// ---------------------------------------------------------------------------
+// KEF replies
+// ---------------------------------------------------------------------------
+
+static const char *kVolumeReply = "[{\"type\":\"i32_\",\"i32_\":35}]";
+
+static const char *kStatusReply =
+    "[{\"type\":\"kefSpeakerStatus\",\"kefSpeakerStatus\":\"powerOn\"}]";
+
+static const char *kSourceReply =
+    "[{\"type\":\"kefPhysicalSource\",\"kefPhysicalSource\":\"wifi\"}]";
+
+static const char *kPowerReply =
+    "[{\"type\":\"kefPowerState\",\"kefPowerState\":\"on\"}]";
+
+static const char *kPlayerReply =
+    "[{\"type\":\"playerData\",\"state\":\"playing\","
+    "\"trackRoles\":{\"title\":\"Teardrop\",\"icon\":\"https://i.scdn.co/image/ab67616d0000b273aa\","
+    "\"mediaData\":{\"metaData\":{\"artist\":\"Massive Attack\",\"album\":\"Mezzanine\"},"
+    "\"resources\":[{\"uri\":\"spotify:track:1\",\"mimeType\":\"audio/ogg\"}]}},"
+    "\"status\":{\"duration\":330000,\"playId\":{\"timestamp\":1}},"
+    "\"controls\":{\"pause\":true,\"next_\":true,\"previous\":true,\"seekTime\":true}}]";
+
+static const char *kEventReply =
+    "[{\"path\":\"player:volume\",\"itemType\":\"update\",\"itemValue\":{\"type\":\"i32_\",\"i32_\":40}},"
+    "{\"path\":\"settings:/mediaPlayer/mute\",\"itemType\":\"update\","
+    "\"itemValue\":{\"type\":\"bool_\",\"bool_\":true}}]";
+
+static void test_replies_parse_without_heap_once_warm() {
+    const JsonDocument &getdata_filter = kef_getdata_filter();
+    const JsonDocument &event_filter   = kef_event_filter();
+
+    static JsonArena<HOST_ARENA_SIZE> arena;
+    JsonDocument doc(&arena);
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_TRUE(deserializeJson(doc, kVolumeReply,
+                         DeserializationOption::Filter(getdata_filter)) == DeserializationError::Ok);
+        TEST_ASSERT_EQUAL_INT(35, doc[0]["i32_"].as<int>());
+
+        TEST_ASSERT_TRUE(deserializeJson(doc, kStatusReply,
+                         DeserializationOption::Filter(getdata_filter)) == DeserializationError::Ok);
+        TEST_ASSERT_EQUAL_STRING("powerOn", doc[0]["kefSpeakerStatus"].as<const char *>());
+
+        TEST_ASSERT_TRUE(deserializeJson(doc, kSourceReply,
+                         DeserializationOption::Filter(getdata_filter)) == DeserializationError::Ok);
+        TEST_ASSERT_EQUAL_STRING("wifi", doc[0]["kefPhysicalSource"].as<const char *>());
+
+        TEST_ASSERT_TRUE(deserializeJson(doc, kPowerReply,
+                         DeserializationOption::Filter(getdata_filter)) == DeserializationError::Ok);
+        TEST_ASSERT_EQUAL_STRING("on", doc[0]["kefPowerState"].as<const char *>());
+
+        TEST_ASSERT_TRUE(deserializeJson(doc, kPlayerReply,
+                         DeserializationOption::Filter(getdata_filter)) == DeserializationError::Ok);
+        TEST_ASSERT_EQUAL_STRING("playing", doc[0]["state"].as<const char *>());
+        TEST_ASSERT_EQUAL_STRING("Massive Attack",
+                                 doc[0]["trackRoles"]["mediaData"]["metaData"]["artist"].as<const char *>());
+        TEST_ASSERT_EQUAL_INT(330000, doc[0]["status"]["duration"].as<int>());
+        TEST_ASSERT_TRUE(doc[0]["controls"].isNull());   // filtered out
+
+        TEST_ASSERT_TRUE(deserializeJson(doc, kEventReply,
+                         DeserializationOption::Filter(event_filter)) == DeserializationError::Ok);
+        TEST_ASSERT_EQUAL_INT(2, (int)doc.size());
+        TEST_ASSERT_EQUAL_INT(40, doc[0]["itemValue"]["i32_"].as<int>());
+        TEST_ASSERT_TRUE(doc[1]["itemValue"]["bool_"].as<bool>());
+        TEST_ASSERT_TRUE(doc[0]["itemType"].isNull());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, arena.spills());
+    doc.clear();
+    TEST_ASSERT_EQUAL_INT(0, (int)arena.used());
+}
+
+static void test_oversized_reply_spills_and_recovers() {
+    std::string big = "[";
+    for (int i = 0; i < 400; i++) {
+        if (i) big += ",";
+        big += "{\"path\":\"player:item" + std::to_string(i) + "\",\"value\":\"" +
+               std::string(40, 'x') + "\"}";
+    }
+    big += "]";
+
+    static JsonArena<HOST_ARENA_SIZE> arena;
+    JsonDocument doc(&arena);
+    TEST_ASSERT_TRUE(deserializeJson(doc, big) == DeserializationError::Ok);
+    TEST_ASSERT_EQUAL_INT(400, (int)doc.size());
+    TEST_ASSERT_EQUAL_STRING("player:item399", doc[399]["path"].as<const char *>());
+    uint32_t spills = arena.spills();
+    TEST_ASSERT_GREATER_THAN(0, (int)spills);
+
+    // Back to normal replies: the arena serves them again
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(deserializeJson(doc, kVolumeReply) == DeserializationError::Ok);
+    }
+    TEST_ASSERT_EQUAL_UINT32(spills, arena.spills());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_blocks_come_from_the_arena);
+    RUN_TEST(test_freeing_everything_rewinds);
+    RUN_TEST(test_newest_block_freed_in_place);
+    RUN_TEST(test_newest_block_resized_in_place);
+    RUN_TEST(test_older_block_grows_by_copy);
+    RUN_TEST(test_overflow_spills_to_heap);
+    RUN_TEST(test_replies_parse_without_heap_once_warm);
+    RUN_TEST(test_oversized_reply_spills_and_recovers);
+    return UNITY_END();
+}
@@ -0,0 +1,271 @@
+// Host tests for state/kef_event_link with a fake clock: subscribe and
+// retry, the first poll reply turning events live, WiFi loss, and a long
+// session against a stand-in speaker that forgets the queue and stops
+// answering, checking the fallback poll covers each gap.
+#include <unity.h>
+#include "state/kef_event_link.h"
+#include "config.h"
+
+#include <stdio.h>
+
+static KefEventLink l;
+static uint32_t     t;   // fake clock
+
+void setUp() {
+    t = 1000;
+    kef_link_init(&l, t);
+}
+
+void tearDown() {}
+
+// ---------------------------------------------------------------------------
+// Transitions
+// ---------------------------------------------------------------------------
+
+static void test_subscribes_at_once() {
+    TEST_ASSERT_EQUAL_INT(KEF_LINK_SUBSCRIBE, kef_link_next(&l, true, t));
+    TEST_ASSERT_FALSE(kef_link_live(&l));
+}
+
+static void test_live_only_after_first_poll_reply() {
+    kef_link_on_subscribe(&l, true, t);
+    TEST_ASSERT_EQUAL_INT(KEF_LINK_POLL, kef_link_next(&l, true, t));
+    TEST_ASSERT_FALSE(kef_link_live(&l));   // stateTask still polls
+
+    kef_link_on_poll(&l, true, t + KEF_POLL_TIMEOUT);
+    TEST_ASSERT_TRUE(kef_link_live(&l));
+    TEST_ASSERT_EQUAL_INT(KEF_LINK_POLL, kef_link_next(&l, true, t + KEF_POLL_TIMEOUT));
+    TEST_ASSERT_EQUAL_UINT32(1, l.subscribes);
+    TEST_ASSERT_EQUAL_UINT32(1, l.polls);
+}
+
+static void test_failed_subscribe_waits_before_retrying() {
+    kef_link_on_subscribe(&l, false, t);
+    TEST_ASSERT_EQUAL_INT(KEF_LINK_WAIT, kef_link_next(&l, true, t));
+    TEST_ASSERT_EQUAL_UINT32(KEF_EVENT_RETRY_MS, kef_link_wait_ms(&l, t));
+    TEST_ASSERT_EQUAL_INT(KEF_LINK_WAIT, kef_link_next(&l, true, t + KEF_EVENT_RETRY_MS - 1));
+    TEST_ASSERT_EQUAL_INT(KEF_LINK_SUBSCRIBE, kef_link_next(&l, true, t + KEF_EVENT_RETRY_MS));
+    TEST_ASSERT_EQUAL_UINT32(0, l.subscribes);
+    TEST_ASSERT_EQUAL_INT(1, l.failures);
+}
+
+static void test_lost_queue_falls_back_and_resubscribes() {
+    kef_link_on_subscribe(&l, true, t);
+    kef_link_on_poll(&l, true, t);
+    TEST_ASSERT_TRUE(kef_link_live(&l));
+
+    t += 20000;
+    kef_link_on_poll(&l, false, t);   // e.g. the speaker forgot the queue
+    TEST_ASSERT_FALSE(kef_link_live(&l));
+    TEST_ASSERT_EQUAL_INT(KEF_LINK_DOWN, l.state);
+    TEST_ASSERT_EQUAL_UINT32(1, l.drops);
+    TEST_ASSERT_EQUAL_INT(KEF_LINK_SUBSCRIBE, kef_link_next(&l, true, t + KEF_EVENT_RETRY_MS));
+
+    kef_link_on_subscribe(&l, true, t + KEF_EVENT_RETRY_MS);
+    kef_link_on_poll(&l, true, t + KEF_EVENT_RETRY_MS + 100);
+    TEST_ASSERT_TRUE(kef_link_live(&l));
+    TEST_ASSERT_EQUAL_INT(0, l.failures);
+}
+
+static void test_wifi_loss_stops_events_but_keeps_the_queue() {
+    kef_link_on_subscribe(&l, true, t);
+    kef_link_on_poll(&l, true, t);
+    kef_link_on_wifi_down(&l);
+    TEST_ASSERT_FALSE(kef_link_live(&l));
+    TEST_ASSERT_EQUAL_INT(KEF_LINK_WAIT, kef_link_next(&l, false, t));
+
+    // Back up: poll the queue we had; the reply decides if it survived
+    TEST_ASSERT_EQUAL_INT(KEF_LINK_POLL, kef_link_next(&l, true, t + 3000));
+    kef_link_on_poll(&l, true, t + 3000);
+    TEST_ASSERT_TRUE(kef_link_live(&l));
+}
+
+static void test_clock_wrap() {
+    t = 0xFFFFF000u;
+    kef_link_init(&l, t);
+    kef_link_on_subscribe(&l, false, t);
+    TEST_ASSERT_EQUAL_UINT32(KEF_EVENT_RETRY_MS, kef_link_wait_ms(&l, t));
+    TEST_ASSERT_EQUAL_INT(KEF_LINK_WAIT, kef_link_next(&l, true, t + 4096));
+    TEST_ASSERT_EQUAL_INT(KEF_LINK_SUBSCRIBE, kef_link_next(&l, true, t + KEF_EVENT_RETRY_MS));
+}
+
+// ---------------------------------------------------------------------------
+// Session against a stand-in speaker
+//
+// Runs kefEventTask's loop and stateTask's fallback poll on a 10 ms fake
+// clock against a stand-in speaker.  The stand-in answers a subscribe in
+// 30 ms; it holds a poll open until something changes (answering 50 ms
+// later) or KEF_POLL_TIMEOUT passes, and answers an error at once for a
+// queue it does not hold.  Over 20 minutes it
+//   - changes something every 37 s (volume, track, ...)
+//   - forgets our queue at 5:00, as when a queue expires
+//   - goes into deep standby at 10:00 — a last speakerStatus event, then
+//     its network drops — and wakes at 11:30 without the queue
+//   - loses WiFi from 15:00 to 15:20, killing the open poll's socket
+// A request to an unreachable speaker blocks for its HTTP timeout.  For
+// every change the test measures how long the knob took to learn it —
+// from an event, or from the fallback poll (every KEF_STATE_POLL_INTERVAL
+// while not live).
+// ---------------------------------------------------------------------------
+
+#define SIM_STEP_MS    10
+#define SIM_END_MS     (20 * 60000u)
+#define SIM_FORGET_MS  300000u
+#define SIM_STANDBY_MS 600000u
+#define SIM_NET_OFF_MS (SIM_STANDBY_MS + 2000)
+#define SIM_WAKE_MS    690000u
+#define SIM_WIFI_OFF   900000u
+#define SIM_WIFI_ON    920000u
+
+typedef enum { SIM_IDLE, SIM_SUBSCRIBING, SIM_POLLING } SimOp;
+
+static bool reachable(uint32_t at) { return at < SIM_NET_OFF_MS || at >= SIM_WAKE_MS; }
+static bool wifi_at(uint32_t at)   { return at < SIM_WIFI_OFF || at >= SIM_WIFI_ON; }
+
+static bool changes_at(uint32_t at) {
+    if (at == SIM_STANDBY_MS || at == SIM_WAKE_MS) return true;   // power off / on
+    return at > 0 && at % 37000 == 0 && reachable(at);
+}
+
+static void test_session_against_stand_in_speaker() {
+    t = 0;
+    kef_link_init(&l, t);
+
+    bool     queue = false;         // the speaker holds our queue
+    SimOp    op = SIM_IDLE;
+    uint32_t op_done = 0;           // when the call in flight returns
+    bool     op_ok = false;
+    bool     dead = false;          // the poll's socket died under it
+    uint32_t poll_start = 0;
+    uint32_t wait_until = 0;
+    uint32_t next_fallback = 0;
+
+    // Earliest change not yet known, split by whether the queue holds it
+    uint32_t unseen_queued = UINT32_MAX, unseen_other = UINT32_MAX;
+    uint32_t changes = 0, worst = 0, by_event = 0, by_poll = 0, live_ms = 0;
+
+    for (t = 0; t < SIM_END_MS; t += SIM_STEP_MS) {
+        // --- The speaker ---
+        if (t == SIM_FORGET_MS || t == SIM_NET_OFF_MS) queue = false;
+        bool wifi = wifi_at(t);
+        if (changes_at(t)) {
+            changes++;
+            uint32_t &slot = queue ? unseen_queued : unseen_other;
+            if (slot == UINT32_MAX) slot = t;
+            if (op == SIM_POLLING && !dead && queue) {
+                op_done = t + 50;   // the held poll answers with the news
+                op_ok   = true;
+            }
+        }
+
+        // --- stateTask: WiFi loss clears the live flag at once ---
+        if (!wifi) kef_link_on_wifi_down(&l);
+
+        // --- kefEventTask: a call in flight ---
+        if (op == SIM_POLLING) {
+            if (!wifi || !reachable(t)) dead = true;
+            if (!dead && !queue && op_done > t + 20) {
+                op_done = t + 20;   // error reply: queue unknown
+                op_ok   = false;
+            }
+        }
+        if (op != SIM_IDLE && t >= op_done) {
+            if (op == SIM_SUBSCRIBING) {
+                kef_link_on_subscribe(&l, op_ok, t);
+            } else {
+                if (op_ok && unseen_queued != UINT32_MAX) {
+                    uint32_t lag = t - unseen_queued;
+                    if (lag > worst) worst = lag;
+                    unseen_queued = UINT32_MAX;
+                    by_event++;
+                }
+                kef_link_on_poll(&l, op_ok, t);
+            }
+            op = SIM_IDLE;
+        }
+
+        // --- kefEventTask: next call ---
+        if (op == SIM_IDLE && t >= wait_until) {
+            switch (kef_link_next(&l, wifi, t)) {
+                case KEF_LINK_WAIT:
+                    wait_until = t + (wifi ? kef_link_wait_ms(&l, t) : 1000);
+                    break;
+                case KEF_LINK_SUBSCRIBE:
+                    op = SIM_SUBSCRIBING;
+                    if (reachable(t)) {
+                        queue   = true;
+                        op_done = t + 30;
+                        op_ok   = true;
+                    } else {
+                        op_done = t + HTTP_TIMEOUT;
+                        op_ok   = false;
+                    }
+                    break;
+                case KEF_LINK_POLL:
+                    op = SIM_POLLING;
+                    poll_start = t;
+                    dead = !reachable(t);
+                    if (dead) {
+                        op_done = t + KEF_POLL_TIMEOUT + 5000;
+                        op_ok   = false;
+                    } else if (!queue) {
+                        op_done = t + 20;
+                        op_ok   = false;
+                    } else {
+                        op_done = t + KEF_POLL_TIMEOUT;
+                        op_ok   = true;
+                    }
+                    break;
+            }
+        }
+        if (op == SIM_POLLING && dead && op_ok) {
+            op_done = poll_start + KEF_POLL_TIMEOUT + 5000;   // read timeout
+            op_ok   = false;
+        }
+
+        // --- stateTask: fallback poll while events are not live ---
+        if (kef_link_live(&l)) {
+            live_ms += SIM_STEP_MS;
+            next_fallback = t;
+        } else if (t >= next_fallback) {
+            next_fallback = t + KEF_STATE_POLL_INTERVAL;
+            if (wifi && reachable(t)) {
+                uint32_t first = unseen_queued < unseen_other ? unseen_queued : unseen_other;
+                if (first != UINT32_MAX) {
+                    if (t - first > worst) worst = t - first;
+                    by_poll++;
+                }
+                unseen_queued = unseen_other = UINT32_MAX;
+            }
+        }
+    }
+
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "20 min: live %u%%, %u subscribes, %u drops; %u changes, %u seen by event, "
+             "%u by fallback poll, worst %u ms",
+             (unsigned)(live_ms * 100ull / SIM_END_MS), (unsigned)l.subscribes,
+             (unsigned)l.drops, (unsigned)changes, (unsigned)by_event, (unsigned)by_poll,
+             (unsigned)worst);
+    TEST_MESSAGE(msg);
+
+    // Start, forgotten queue, standby and WiFi loss: one subscribe each
+    TEST_ASSERT_EQUAL_UINT32(4, l.subscribes);
+    TEST_ASSERT_EQUAL_UINT32(3, l.drops);
+    TEST_ASSERT_GREATER_THAN(80, (int)(live_ms * 100ull / SIM_END_MS));
+    TEST_ASSERT_GREATER_THAN((int)(changes * 3 / 4), (int)by_event);
+    // Nothing waits longer than one fallback poll interval
+    TEST_ASSERT_LESS_OR_EQUAL(KEF_STATE_POLL_INTERVAL + SIM_STEP_MS, worst);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_subscribes_at_once);
+    RUN_TEST(test_live_only_after_first_poll_reply);
+    RUN_TEST(test_failed_subscribe_waits_before_retrying);
+    RUN_TEST(test_lost_queue_falls_back_and_resubscribes);
+    RUN_TEST(test_wifi_loss_stops_events_but_keeps_the_queue);
+    RUN_TEST(test_clock_wrap);
+    RUN_TEST(test_session_against_stand_in_speaker);
+    return UNITY_END();
+}
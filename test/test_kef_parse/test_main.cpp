@@ -0,0 +1,213 @@
+// Host tests for network/kef_parse against canned speaker replies: getData
+// values, modifyQueue queue ids, and pollQueue event batches — including a
+// quiet poll and a queue the speaker no longer knows — all parsed through
+// the same filters kef_api uses.
+#include <unity.h>
+#include "network/kef_parse.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static JsonDocument doc;
+
+void setUp() {
+    doc.clear();
+}
+
+void tearDown() {}
+
+static bool parse(const char *reply, const JsonDocument &filter) {
+    return deserializeJson(doc, reply, DeserializationOption::Filter(filter)) ==
+           DeserializationError::Ok;
+}
+
+// ---------------------------------------------------------------------------
+// getData
+// ---------------------------------------------------------------------------
+
+static const char *kPlayerData =
+    "[{\"type\":\"playerData\",\"state\":\"playing\","
+    "\"trackRoles\":{\"title\":\"Teardrop\",\"icon\":\"https://i.scdn.co/image/ab67616d0000b273aa\","
+    "\"mediaData\":{\"metaData\":{\"artist\":\"Massive Attack\",\"album\":\"Mezzanine\"},"
+    "\"resources\":[{\"uri\":\"spotify:track:1\",\"mimeType\":\"audio/ogg\"}]}},"
+    "\"status\":{\"duration\":330000,\"playId\":{\"timestamp\":1}},"
+    "\"controls\":{\"pause\":true,\"next_\":true,\"previous\":true,\"seekTime\":true}}]";
+
+static void test_getdata_values() {
+    KefState st = {};
+    TEST_ASSERT_TRUE(parse("[{\"type\":\"i32_\",\"i32_\":35}]", kef_getdata_filter()));
+    TEST_ASSERT_TRUE(kef_parse_value(KEF_FIELD_VOLUME, doc[0], &st));
+    TEST_ASSERT_EQUAL_INT(35, st.volume);
+
+    TEST_ASSERT_TRUE(parse("[{\"type\":\"bool_\",\"bool_\":true}]", kef_getdata_filter()));
+    TEST_ASSERT_TRUE(kef_parse_value(KEF_FIELD_MUTE, doc[0], &st));
+    TEST_ASSERT_TRUE(st.muted);
+
+    TEST_ASSERT_TRUE(parse("[{\"type\":\"kefSpeakerStatus\",\"kefSpeakerStatus\":\"powerOn\"}]",
+                           kef_getdata_filter()));
+    TEST_ASSERT_TRUE(kef_parse_value(KEF_FIELD_POWER, doc[0], &st));
+    TEST_ASSERT_TRUE(st.power_on);
+
+    TEST_ASSERT_TRUE(parse("[{\"type\":\"kefPhysicalSource\",\"kefPhysicalSource\":\"usb\"}]",
+                           kef_getdata_filter()));
+    TEST_ASSERT_TRUE(kef_parse_value(KEF_FIELD_SOURCE, doc[0], &st));
+    TEST_ASSERT_EQUAL_STRING("usb", st.source);
+
+    TEST_ASSERT_TRUE(parse(kPlayerData, kef_getdata_filter()));
+    TEST_ASSERT_TRUE(kef_parse_value(KEF_FIELD_PLAYER, doc[0], &st));
+    TEST_ASSERT_TRUE(st.player.playing);
+    TEST_ASSERT_FALSE(st.player.is_standby);
+    TEST_ASSERT_EQUAL_STRING("Teardrop", st.player.title);
+    TEST_ASSERT_EQUAL_STRING("Massive Attack", st.player.artist);
+    TEST_ASSERT_EQUAL_STRING("https://i.scdn.co/image/ab67616d0000b273aa", st.player.cover_url);
+    TEST_ASSERT_EQUAL_UINT32(330000, st.player.duration_ms);
+    TEST_ASSERT_TRUE(doc[0]["controls"].isNull());   // filtered out
+}
+
+static void test_getdata_missing_volume_is_rejected() {
+    KefState st = {};
+    st.volume = 12;
+    TEST_ASSERT_TRUE(parse("[{\"type\":\"string_\",\"string_\":\"x\"}]", kef_getdata_filter()));
+    TEST_ASSERT_FALSE(kef_parse_value(KEF_FIELD_VOLUME, doc[0], &st));
+    TEST_ASSERT_EQUAL_INT(12, st.volume);
+}
+
+static void test_player_standby_states() {
+    KefState st = {};
+    TEST_ASSERT_TRUE(parse("[{\"type\":\"playerData\",\"state\":\"stopped\"}]", kef_getdata_filter()));
+    kef_parse_value(KEF_FIELD_PLAYER, doc[0], &st);
+    TEST_ASSERT_TRUE(st.player.is_standby);
+    TEST_ASSERT_EQUAL_STRING("--", st.player.title);
+    TEST_ASSERT_EQUAL_STRING("", st.player.cover_url);
+
+    TEST_ASSERT_TRUE(parse("[{\"type\":\"playerData\",\"state\":\"pause\"}]", kef_getdata_filter()));
+    kef_parse_value(KEF_FIELD_PLAYER, doc[0], &st);
+    TEST_ASSERT_FALSE(st.player.is_standby);
+    TEST_ASSERT_FALSE(st.player.playing);
+}
+
+// ---------------------------------------------------------------------------
+// modifyQueue
+// ---------------------------------------------------------------------------
+
+static void test_queue_id_loses_its_braces() {
+    char id[64];
+    TEST_ASSERT_TRUE(parse("\"{8b6a5c3e-1f2d-4b7a-9c0e-5d4f3a2b1c0d}\"", kef_accept_all()));
+    TEST_ASSERT_TRUE(kef_parse_queue_id(doc, id, sizeof(id)));
+    TEST_ASSERT_EQUAL_STRING("8b6a5c3e-1f2d-4b7a-9c0e-5d4f3a2b1c0d", id);
+
+    TEST_ASSERT_TRUE(parse("\"8b6a5c3e\"", kef_accept_all()));
+    TEST_ASSERT_TRUE(kef_parse_queue_id(doc, id, sizeof(id)));
+    TEST_ASSERT_EQUAL_STRING("8b6a5c3e", id);
+}
+
+static void test_bad_queue_ids_are_rejected() {
+    char id[16];
+    TEST_ASSERT_TRUE(parse("\"{}\"", kef_accept_all()));
+    TEST_ASSERT_FALSE(kef_parse_queue_id(doc, id, sizeof(id)));
+    TEST_ASSERT_EQUAL_STRING("", id);
+
+    TEST_ASSERT_TRUE(parse("{\"error\":\"bad request\"}", kef_accept_all()));
+    TEST_ASSERT_FALSE(kef_parse_queue_id(doc, id, sizeof(id)));
+
+    // Longer than the buffer: a truncated id would only fail every poll
+    TEST_ASSERT_TRUE(parse("\"{8b6a5c3e-1f2d-4b7a-9c0e-5d4f3a2b1c0d}\"", kef_accept_all()));
+    TEST_ASSERT_FALSE(kef_parse_queue_id(doc, id, sizeof(id)));
+    TEST_ASSERT_EQUAL_STRING("", id);
+}
+
+// ---------------------------------------------------------------------------
+// pollQueue
+// ---------------------------------------------------------------------------
+
+static void test_event_batch_sets_each_field() {
+    static const char *kBatch =
+        "[{\"path\":\"player:volume\",\"itemType\":\"update\","
+        "\"itemValue\":{\"type\":\"i32_\",\"i32_\":40}},"
+        "{\"path\":\"settings:/mediaPlayer/mute\",\"itemType\":\"update\","
+        "\"itemValue\":{\"type\":\"bool_\",\"bool_\":true}},"
+        "{\"path\":\"settings:/kef/host/speakerStatus\",\"itemType\":\"update\","
+        "\"itemValue\":{\"type\":\"kefSpeakerStatus\",\"kefSpeakerStatus\":\"powerOn\"}},"
+        "{\"path\":\"settings:/kef/play/physicalSource\",\"itemType\":\"update\","
+        "\"itemValue\":{\"type\":\"kefPhysicalSource\",\"kefPhysicalSource\":\"wifi\"}},"
+        "{\"path\":\"player:player/data\",\"itemType\":\"update\",\"itemValue\":"
+        "{\"type\":\"playerData\",\"state\":\"pause\",\"trackRoles\":{\"title\":\"Angel\"},"
+        "\"status\":{\"duration\":379000}}}]";
+
+    KefState st = {};
+    TEST_ASSERT_TRUE(parse(kBatch, kef_event_filter()));
+    TEST_ASSERT_TRUE(kef_parse_events(doc, &st));
+    TEST_ASSERT_EQUAL_HEX8(KEF_FIELD_VOLUME | KEF_FIELD_MUTE | KEF_FIELD_POWER |
+                           KEF_FIELD_SOURCE | KEF_FIELD_PLAYER, st.fields);
+    TEST_ASSERT_EQUAL_INT(40, st.volume);
+    TEST_ASSERT_TRUE(st.muted);
+    TEST_ASSERT_TRUE(st.power_on);
+    TEST_ASSERT_EQUAL_STRING("wifi", st.source);
+    TEST_ASSERT_EQUAL_STRING("Angel", st.player.title);
+    TEST_ASSERT_FALSE(st.player.playing);
+    TEST_ASSERT_EQUAL_UINT32(379000, st.player.duration_ms);
+    TEST_ASSERT_TRUE(doc[0]["itemType"].isNull());   // filtered out
+}
+
+static void test_unknown_paths_and_bad_values_are_skipped() {
+    static const char *kBatch =
+        "[{\"path\":\"settings:/kef/host/maximumVolume\",\"itemType\":\"update\","
+        "\"itemValue\":{\"type\":\"i32_\",\"i32_\":90}},"
+        "{\"path\":\"player:volume\",\"itemType\":\"update\",\"itemValue\":{}},"
+        "{\"path\":\"settings:/mediaPlayer/mute\",\"itemType\":\"update\","
+        "\"itemValue\":{\"type\":\"bool_\",\"bool_\":false}}]";
+
+    KefState st = {};
+    st.volume = 20;
+    TEST_ASSERT_TRUE(parse(kBatch, kef_event_filter()));
+    TEST_ASSERT_TRUE(kef_parse_events(doc, &st));
+    TEST_ASSERT_EQUAL_HEX8(KEF_FIELD_MUTE, st.fields);
+    TEST_ASSERT_EQUAL_INT(20, st.volume);
+    TEST_ASSERT_FALSE(st.muted);
+}
+
+static void test_quiet_poll_is_not_an_error() {
+    KefState st = {};
+    TEST_ASSERT_TRUE(parse("[]", kef_event_filter()));
+    TEST_ASSERT_TRUE(kef_parse_events(doc, &st));
+    TEST_ASSERT_EQUAL_HEX8(0, st.fields);
+}
+
+static void test_reply_for_a_lost_queue_drops_it() {
+    // Anything but an event array: the queue has expired or was never known
+    KefState st = {};
+    TEST_ASSERT_TRUE(parse("{\"error\":{\"message\":\"unknown queue\"}}", kef_event_filter()));
+    TEST_ASSERT_FALSE(kef_parse_events(doc, &st));
+    TEST_ASSERT_EQUAL_HEX8(0, st.fields);
+
+    doc.clear();   // a parse error leaves kef_api's document empty
+    TEST_ASSERT_FALSE(kef_parse_events(doc, &st));
+}
+
+static void test_every_path_is_recognised() {
+    for (const auto &p : kKefPaths) {
+        char reply[160];
+        snprintf(reply, sizeof(reply),
+                 "[{\"path\":\"%s\",\"itemType\":\"update\",\"itemValue\":{\"i32_\":1}}]", p.path);
+        KefState st = {};
+        TEST_ASSERT_TRUE(parse(reply, kef_event_filter()));
+        TEST_ASSERT_TRUE(kef_parse_events(doc, &st));
+        TEST_ASSERT_EQUAL_HEX8_MESSAGE(p.field, st.fields, p.path);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_getdata_values);
+    RUN_TEST(test_getdata_missing_volume_is_rejected);
+    RUN_TEST(test_player_standby_states);
+    RUN_TEST(test_queue_id_loses_its_braces);
+    RUN_TEST(test_bad_queue_ids_are_rejected);
+    RUN_TEST(test_event_batch_sets_each_field);
+    RUN_TEST(test_unknown_paths_and_bad_values_are_skipped);
+    RUN_TEST(test_quiet_poll_is_not_an_error);
+    RUN_TEST(test_reply_for_a_lost_queue_drops_it);
+    RUN_TEST(test_every_path_is_recognised);
+    return UNITY_END();
+}
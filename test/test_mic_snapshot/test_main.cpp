@@ -0,0 +1,167 @@
+// Host tests for audio/mic_snapshot: a writer and a reader thread hammer the
+// sequence lock and no torn snapshot may get through; MicTrack counts missed
+// blocks and interpolates band levels between the last two snapshots.
+#include <unity.h>
+#include "audio/mic_snapshot.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+static MicSlot s_slot;
+
+void setUp() {
+    s_slot.seq.store(0);
+    memset(&s_slot.data, 0, sizeof(s_slot.data));
+}
+
+void tearDown() {}
+
+// Every field derives from seq, so a copy mixing two writes is detectable.
+static void fill(MicSnapshot *s, uint32_t seq) {
+    memset(s, 0, sizeof(*s));
+    s->version    = MIC_SNAPSHOT_VERSION;
+    s->n_bands    = 4;
+    s->seq        = seq;
+    s->capture_us = seq * 32000u;
+    s->block_us   = 32000;
+    s->rms        = seq * 0.5f;
+    s->peak       = seq * 1.0f;
+    s->flux       = seq * 2.0f;
+    s->level      = (uint8_t)seq;
+    for (int i = 0; i < SPECTRUM_MAX_BANDS; i++) s->bands[i] = (uint8_t)(seq + i);
+}
+
+static bool consistent(const MicSnapshot &s) {
+    MicSnapshot want;
+    fill(&want, s.seq);
+    return memcmp(&want, &s, sizeof(s)) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Sequence lock
+// ---------------------------------------------------------------------------
+
+static void test_nothing_published_reads_false() {
+    MicSnapshot out;
+    fill(&out, 77);
+    TEST_ASSERT_FALSE(mic_slot_read(&s_slot, &out));
+    TEST_ASSERT_EQUAL_UINT32(77, out.seq);   // left alone
+}
+
+static void test_read_returns_last_publish() {
+    MicSnapshot in, out;
+    fill(&in, 5);
+    mic_slot_publish(&s_slot, &in);
+    fill(&in, 6);
+    mic_slot_publish(&s_slot, &in);
+    TEST_ASSERT_TRUE(mic_slot_read(&s_slot, &out));
+    TEST_ASSERT_EQUAL_MEMORY(&in, &out, sizeof(in));
+}
+
+static void test_two_threads_never_tear() {
+    const uint32_t writes = 300000;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        MicSnapshot s;
+        for (uint32_t i = 1; i <= writes; i++) {
+            fill(&s, i);
+            mic_slot_publish(&s_slot, &s);
+            for (volatile int k = 0; k < 200; k++) {}   // roughly one block apart
+        }
+        done.store(true);
+    });
+
+    uint64_t reads = 0, raced = 0, torn = 0, skipped = 0;
+    uint32_t last = 0;
+    bool ordered = true;
+    MicTrack track;
+    mic_track_init(&track);
+    while (!done.load()) {
+        MicSnapshot s;
+        if (!mic_slot_read(&s_slot, &s)) { raced++; continue; }
+        reads++;
+        if (!consistent(s)) torn++;
+        if (s.seq < last) ordered = false;
+        last = s.seq;
+        skipped += mic_track_push(&track, &s);
+    }
+    writer.join();
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%llu reads, %llu gave up, %llu torn, %u blocks missed",
+             (unsigned long long)reads, (unsigned long long)raced,
+             (unsigned long long)torn, (unsigned)track.missed);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_GREATER_THAN(0, (int)reads);
+    TEST_ASSERT_EQUAL_UINT64(0, torn);
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL_UINT64(skipped, track.missed);
+    TEST_ASSERT_LESS_OR_EQUAL(writes, track.missed + 1);
+}
+
+// ---------------------------------------------------------------------------
+// MicTrack
+// ---------------------------------------------------------------------------
+
+static void test_track_counts_missed_blocks() {
+    MicTrack t;
+    mic_track_init(&t);
+    MicSnapshot s;
+    fill(&s, 10);
+    TEST_ASSERT_EQUAL_UINT32(0, mic_track_push(&t, &s));
+    fill(&s, 11);
+    TEST_ASSERT_EQUAL_UINT32(0, mic_track_push(&t, &s));
+    fill(&s, 15);
+    TEST_ASSERT_EQUAL_UINT32(3, mic_track_push(&t, &s));
+    TEST_ASSERT_EQUAL_UINT32(0, mic_track_push(&t, &s));   // repeat ignored
+    TEST_ASSERT_EQUAL_UINT32(3, t.missed);
+}
+
+static void test_track_interpolates_one_block_behind() {
+    MicTrack t;
+    mic_track_init(&t);
+    MicSnapshot a, b;
+    fill(&a, 10);                  // captured at 320000 µs
+    fill(&b, 11);                  // captured at 352000 µs
+    a.bands[0] = 0;
+    b.bands[0] = 100;
+
+    mic_track_push(&t, &a);
+    TEST_ASSERT_EQUAL_INT(0, (int)mic_track_band(&t, 0, 0));   // no prev yet: cur
+    mic_track_push(&t, &b);
+    // Playback runs block_us behind capture
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f,   mic_track_band(&t, 0, 320000 + 32000));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f,  mic_track_band(&t, 0, 336000 + 32000));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, mic_track_band(&t, 0, 400000 + 32000));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f,   mic_track_band(&t, 0, 100000));        // holds
+}
+
+static void test_track_across_clock_wrap() {
+    MicTrack t;
+    mic_track_init(&t);
+    MicSnapshot a, b;
+    fill(&a, 1);
+    fill(&b, 2);
+    a.capture_us = 0xFFFFC000u;
+    b.capture_us = 0x00004000u;
+    a.bands[0] = 0;
+    b.bands[0] = 200;
+    mic_track_push(&t, &a);
+    mic_track_push(&t, &b);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, mic_track_band(&t, 0, 32000u));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_nothing_published_reads_false);
+    RUN_TEST(test_read_returns_last_publish);
+    RUN_TEST(test_two_threads_never_tear);
+    RUN_TEST(test_track_counts_missed_blocks);
+    RUN_TEST(test_track_interpolates_one_block_behind);
+    RUN_TEST(test_track_across_clock_wrap);
+    return UNITY_END();
+}
@@ -0,0 +1,142 @@
+// Host tests for state/optimistic_state: intents show at once, readbacks
+// confirm them, failures and timeouts roll back, stale readbacks are ignored.
+#include <unity.h>
+#include "state/optimistic_state.h"
+#include "config.h"
+
+#include <atomic>
+#include <thread>
+
+void setUp() { opt_reset(); }
+
+void tearDown() {}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+static void test_boot_defaults() {
+    TEST_ASSERT_FALSE(opt_value(OPT_MUTE));
+    TEST_ASSERT_FALSE(opt_value(OPT_PLAYING));
+    TEST_ASSERT_FALSE(opt_value(OPT_SOURCE_USB));
+    TEST_ASSERT_TRUE(opt_value(OPT_POWER));
+    TEST_ASSERT_EQUAL_UINT32(0, opt_rollbacks());
+}
+
+static void test_intent_shows_until_confirmed() {
+    opt_request(OPT_MUTE, true, 1000);
+    TEST_ASSERT_TRUE(opt_value(OPT_MUTE));
+    TEST_ASSERT_EQUAL_INT(OPT_PENDING, opt_status(OPT_MUTE));
+
+    opt_confirm(OPT_MUTE, true, 1200);
+    TEST_ASSERT_TRUE(opt_value(OPT_MUTE));
+    TEST_ASSERT_EQUAL_INT(OPT_CONFIRMED, opt_status(OPT_MUTE));
+}
+
+static void test_stale_readback_keeps_intent() {
+    opt_request(OPT_PLAYING, true, 1000);
+    opt_confirm(OPT_PLAYING, false, 1100);   // poll that left before the tap
+    TEST_ASSERT_TRUE(opt_value(OPT_PLAYING));
+    TEST_ASSERT_EQUAL_INT(OPT_PENDING, opt_status(OPT_PLAYING));
+}
+
+static void test_failed_command_rolls_back() {
+    opt_request(OPT_SOURCE_USB, true, 1000);
+    opt_fail(OPT_SOURCE_USB);
+    TEST_ASSERT_FALSE(opt_value(OPT_SOURCE_USB));
+    TEST_ASSERT_EQUAL_INT(OPT_ROLLED_BACK, opt_status(OPT_SOURCE_USB));
+    TEST_ASSERT_EQUAL_UINT32(1, opt_rollbacks());
+}
+
+static void test_fail_without_intent_is_ignored() {
+    opt_fail(OPT_MUTE);
+    TEST_ASSERT_EQUAL_INT(OPT_CONFIRMED, opt_status(OPT_MUTE));
+    TEST_ASSERT_EQUAL_UINT32(0, opt_rollbacks());
+}
+
+static void test_timeout_rolls_back() {
+    opt_request(OPT_MUTE, true, 1000);
+    TEST_ASSERT_FALSE(opt_tick(1000 + OPT_PENDING_TIMEOUT_MS));
+    TEST_ASSERT_TRUE(opt_value(OPT_MUTE));
+    TEST_ASSERT_TRUE(opt_tick(1000 + OPT_PENDING_TIMEOUT_MS + 1));
+    TEST_ASSERT_FALSE(opt_value(OPT_MUTE));
+    TEST_ASSERT_EQUAL_UINT32(1, opt_rollbacks());
+}
+
+static void test_power_waits_longer() {
+    opt_request(OPT_POWER, false, 1000);
+    TEST_ASSERT_FALSE(opt_tick(1000 + OPT_PENDING_TIMEOUT_MS + 1));
+    TEST_ASSERT_FALSE(opt_value(OPT_POWER));
+    TEST_ASSERT_TRUE(opt_tick(1000 + OPT_POWER_TIMEOUT_MS + 1));
+    TEST_ASSERT_TRUE(opt_value(OPT_POWER));
+}
+
+static void test_timeout_survives_clock_wrap() {
+    uint32_t t = 0xFFFFFFFFu - 1000;
+    opt_request(OPT_MUTE, true, t);
+    TEST_ASSERT_FALSE(opt_tick(t + 2000));            // wrapped, still in time
+    TEST_ASSERT_TRUE(opt_value(OPT_MUTE));
+    TEST_ASSERT_TRUE(opt_tick(t + OPT_PENDING_TIMEOUT_MS + 1));
+}
+
+static void test_late_readback_after_rollback_confirms() {
+    opt_request(OPT_MUTE, true, 1000);
+    opt_tick(1000 + OPT_PENDING_TIMEOUT_MS + 1);
+    opt_confirm(OPT_MUTE, true, 5000);                // speaker got there after all
+    TEST_ASSERT_TRUE(opt_value(OPT_MUTE));
+    TEST_ASSERT_EQUAL_INT(OPT_CONFIRMED, opt_status(OPT_MUTE));
+}
+
+static void test_rollback_to_same_value_is_not_a_change() {
+    opt_confirm(OPT_MUTE, true, 900);
+    opt_request(OPT_MUTE, true, 1000);                // repeated tap, same value
+    TEST_ASSERT_FALSE(opt_tick(1000 + OPT_PENDING_TIMEOUT_MS + 1));
+    TEST_ASSERT_TRUE(opt_value(OPT_MUTE));
+}
+
+static void test_fields_are_independent() {
+    opt_request(OPT_MUTE, true, 1000);
+    opt_request(OPT_PLAYING, true, 1000);
+    opt_fail(OPT_MUTE);
+    TEST_ASSERT_FALSE(opt_value(OPT_MUTE));
+    TEST_ASSERT_TRUE(opt_value(OPT_PLAYING));
+    TEST_ASSERT_EQUAL_INT(OPT_PENDING, opt_status(OPT_PLAYING));
+}
+
+static void test_concurrent_taps_and_readbacks() {
+    // Core 1 taps while Core 0 confirms and ticks; every call must see a
+    // whole entry, and the final readback must leave the field confirmed.
+    const int N = 100000;
+    std::atomic<bool> go{false};
+    std::thread ui([&] {
+        while (!go.load()) {}
+        for (int i = 0; i < N; i++) opt_request(OPT_MUTE, i & 1, (uint32_t)i);
+    });
+    go.store(true);
+    for (int i = 0; i < N; i++) {
+        opt_confirm(OPT_MUTE, i & 1, (uint32_t)i);
+        opt_tick((uint32_t)i);
+        (void)opt_value(OPT_MUTE);
+    }
+    ui.join();
+    opt_confirm(OPT_MUTE, true, N);   // the last tap asked for true
+    TEST_ASSERT_TRUE(opt_value(OPT_MUTE));
+    TEST_ASSERT_EQUAL_INT(OPT_CONFIRMED, opt_status(OPT_MUTE));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_boot_defaults);
+    RUN_TEST(test_intent_shows_until_confirmed);
+    RUN_TEST(test_stale_readback_keeps_intent);
+    RUN_TEST(test_failed_command_rolls_back);
+    RUN_TEST(test_fail_without_intent_is_ignored);
+    RUN_TEST(test_timeout_rolls_back);
+    RUN_TEST(test_power_waits_longer);
+    RUN_TEST(test_timeout_survives_clock_wrap);
+    RUN_TEST(test_late_readback_after_rollback_confirms);
+    RUN_TEST(test_rollback_to_same_value_is_not_a_change);
+    RUN_TEST(test_fields_are_independent);
+    RUN_TEST(test_concurrent_taps_and_readbacks);
+    return UNITY_END();
+}
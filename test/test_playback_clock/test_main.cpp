@@ -0,0 +1,138 @@
+// Host tests for state/playback_clock with an injected clock: extrapolation,
+// slewing small errors without jumps or reversals, snapping large ones,
+// pause/resume, the duration cap and clock wrap.
+#include <unity.h>
+#include "state/playback_clock.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static PlaybackClock c;
+
+void setUp() { pb_clock_init(&c); }
+
+void tearDown() {}
+
+// Position must never decrease while playing, sampled at 60 fps.
+static void assert_monotonic(uint32_t from_ms, uint32_t to_ms) {
+    uint32_t prev = pb_clock_position_ms(&c, from_ms);
+    for (uint32_t t = from_ms; t <= to_ms; t += 16) {
+        uint32_t p = pb_clock_position_ms(&c, t);
+        TEST_ASSERT_GREATER_OR_EQUAL(prev, p);
+        prev = p;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+static void test_stopped_at_zero_after_init() {
+    TEST_ASSERT_EQUAL_UINT32(0, pb_clock_position_ms(&c, 5000));
+    TEST_ASSERT_EQUAL_INT(0, pb_clock_permille(&c, 5000));
+}
+
+static void test_extrapolates_while_playing() {
+    pb_clock_reset(&c, 10000, 200000, true, 1000);
+    TEST_ASSERT_EQUAL_UINT32(12500, pb_clock_position_ms(&c, 3500));
+    TEST_ASSERT_EQUAL_INT(62, pb_clock_permille(&c, 3500));
+}
+
+static void test_small_lead_is_slewed() {
+    pb_clock_reset(&c, 10000, 200000, true, 1000);
+    const uint32_t t = 11000;                      // estimate is 20000
+    pb_clock_sync(&c, 20000 + PLAYBACK_SNAP_MS / 2, 200000, true, t);
+    TEST_ASSERT_EQUAL_UINT32(0, c.snaps);
+    TEST_ASSERT_EQUAL_INT(PLAYBACK_SNAP_MS / 2, c.last_error_ms);
+    TEST_ASSERT_EQUAL_UINT32(20000, pb_clock_position_ms(&c, t));   // no jump
+    assert_monotonic(t, t + 2 * PLAYBACK_SLEW_MS);
+    // Caught up by the end of the slew, real time after it
+    TEST_ASSERT_INT_WITHIN(1, 20000 + PLAYBACK_SNAP_MS / 2 + PLAYBACK_SLEW_MS,
+                           pb_clock_position_ms(&c, t + PLAYBACK_SLEW_MS));
+    TEST_ASSERT_INT_WITHIN(1, 20000 + PLAYBACK_SNAP_MS / 2 + PLAYBACK_SLEW_MS + 1000,
+                           pb_clock_position_ms(&c, t + PLAYBACK_SLEW_MS + 1000));
+}
+
+static void test_small_lag_slows_without_going_backwards() {
+    pb_clock_reset(&c, 10000, 200000, true, 1000);
+    const uint32_t t = 11000;
+    pb_clock_sync(&c, 20000 - 800, 200000, true, t);
+    TEST_ASSERT_EQUAL_UINT32(0, c.snaps);
+    assert_monotonic(t, t + 2 * PLAYBACK_SLEW_MS);
+    TEST_ASSERT_INT_WITHIN(1, 19200 + PLAYBACK_SLEW_MS,
+                           pb_clock_position_ms(&c, t + PLAYBACK_SLEW_MS));
+}
+
+static void test_seek_snaps() {
+    pb_clock_reset(&c, 10000, 200000, true, 1000);
+    pb_clock_sync(&c, 100000, 200000, true, 2000);
+    TEST_ASSERT_EQUAL_UINT32(1, c.snaps);
+    TEST_ASSERT_EQUAL_UINT32(100000, pb_clock_position_ms(&c, 2000));
+}
+
+static void test_new_duration_snaps() {
+    pb_clock_reset(&c, 10000, 200000, true, 1000);
+    pb_clock_sync(&c, 11000, 180000, true, 2000);   // close, but a new track
+    TEST_ASSERT_EQUAL_UINT32(1, c.snaps);
+    TEST_ASSERT_EQUAL_UINT32(11000, pb_clock_position_ms(&c, 2000));
+}
+
+static void test_pause_freezes_and_resume_continues() {
+    pb_clock_reset(&c, 100000, 200000, true, 0);
+    pb_clock_set_playing(&c, false, 1000);
+    TEST_ASSERT_EQUAL_UINT32(101000, pb_clock_position_ms(&c, 9000));
+    pb_clock_set_playing(&c, true, 9000);
+    TEST_ASSERT_EQUAL_UINT32(102000, pb_clock_position_ms(&c, 10000));
+}
+
+static void test_capped_at_duration() {
+    pb_clock_reset(&c, 0, 200000, true, 0);
+    TEST_ASSERT_EQUAL_UINT32(200000, pb_clock_position_ms(&c, 10000000));
+    TEST_ASSERT_EQUAL_INT(1000, pb_clock_permille(&c, 10000000));
+}
+
+static void test_duration_learned_later() {
+    pb_clock_reset(&c, 0, 0, true, 0);              // KEF: track started, length unknown
+    TEST_ASSERT_EQUAL_INT(0, pb_clock_permille(&c, 5000));
+    pb_clock_set_duration(&c, 100000);
+    TEST_ASSERT_EQUAL_INT(50, pb_clock_permille(&c, 5000));
+}
+
+static void test_clock_wrap() {
+    pb_clock_reset(&c, 0, 300000, true, 0xFFFFFF00u);
+    TEST_ASSERT_EQUAL_UINT32(0x200, pb_clock_position_ms(&c, 0x100));
+}
+
+static void test_jittered_polls_stay_smooth() {
+    // Spotify every 10 s, each report off by up to ±400 ms of latency.
+    srand(1);
+    pb_clock_reset(&c, 0, 600000, true, 0);
+    int32_t worst = 0;
+    for (uint32_t t = 10000; t < 300000; t += 10000) {
+        int32_t jitter = (rand() % 801) - 400;
+        pb_clock_sync(&c, (uint32_t)((int32_t)t + jitter), 600000, true, t);
+        if (abs(c.last_error_ms) > worst) worst = abs(c.last_error_ms);
+        assert_monotonic(t, t + 10000 - 16);
+    }
+    char msg[64];
+    snprintf(msg, sizeof(msg), "worst sync error %d ms, %u snaps", (int)worst, (unsigned)c.snaps);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_UINT32(0, c.snaps);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_stopped_at_zero_after_init);
+    RUN_TEST(test_extrapolates_while_playing);
+    RUN_TEST(test_small_lead_is_slewed);
+    RUN_TEST(test_small_lag_slows_without_going_backwards);
+    RUN_TEST(test_seek_snaps);
+    RUN_TEST(test_new_duration_snaps);
+    RUN_TEST(test_pause_freezes_and_resume_continues);
+    RUN_TEST(test_capped_at_duration);
+    RUN_TEST(test_duration_learned_later);
+    RUN_TEST(test_clock_wrap);
+    RUN_TEST(test_jittered_polls_stay_smooth);
+    return UNITY_END();
+}
@@ -0,0 +1,124 @@
+// Host tests for audio/spectrum at the mic's settings: FFT band levels
+// against the direct DFT, tone separation between bands, RMS calibration,
+// spectral flux, and short blocks.
+#include <unity.h>
+#include "audio/spectrum.h"
+#include "config.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static Spectrum s;   // ~9 KB: keep it off the stack
+static int16_t  s_pcm[SPECTRUM_N];
+
+void setUp() {
+    spectrum_init(&s, MIC_BANDS, MIC_BAND_LO_HZ, MIC_BAND_HI_HZ, MIC_SAMPLE_RATE);
+}
+
+void tearDown() {}
+
+static void tone(float hz, float amp, float dc = 0.0f, int offset = 0) {
+    for (int i = 0; i < SPECTRUM_N; i++) {
+        s_pcm[i] = (int16_t)lrintf(dc + amp * sinf(6.2831853f * hz * (i + offset) / MIC_SAMPLE_RATE));
+    }
+}
+
+static float bin_hz() { return (float)MIC_SAMPLE_RATE / SPECTRUM_N; }
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+static void test_bands_cover_range_in_order() {
+    TEST_ASSERT_EQUAL_INT(MIC_BANDS, s.n_bands);
+    TEST_ASSERT_INT_WITHIN(1, (int)(MIC_BAND_LO_HZ / bin_hz()), s.edge[0]);
+    for (int b = 0; b < s.n_bands; b++) TEST_ASSERT_GREATER_THAN(s.edge[b], s.edge[b + 1]);
+    TEST_ASSERT_LESS_OR_EQUAL(SPECTRUM_BINS + 1, s.edge[s.n_bands]);
+}
+
+static void test_fft_matches_dft() {
+    static float power[SPECTRUM_BINS + 1];
+    tone(440.0f, 3000.0f, 500.0f);
+    for (int i = 0; i < SPECTRUM_N; i++) s_pcm[i] += (int16_t)((i * 7919) % 200 - 100);
+
+    SpectrumFrame f;
+    spectrum_run(&s, s_pcm, SPECTRUM_N, &f);
+    spectrum_power_ref(&s, s_pcm, SPECTRUM_N, power);
+    for (int b = 0; b < s.n_bands; b++) {
+        double acc = 0;
+        for (int k = s.edge[b]; k < s.edge[b + 1]; k++) acc += power[k];
+        float ref = (float)sqrt(acc * s.power_scale);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f * ref + 1e-3f, ref, f.band_rms[b]);
+    }
+}
+
+static void test_tone_lands_in_its_band() {
+    for (int b = 0; b < s.n_bands; b++) {
+        float hz = bin_hz() * sqrtf((float)s.edge[b] * (s.edge[b + 1] - 1));   // geometric centre
+        spectrum_init(&s, MIC_BANDS, MIC_BAND_LO_HZ, MIC_BAND_HI_HZ, MIC_SAMPLE_RATE);
+        tone(hz, 8000.0f);
+        SpectrumFrame f;
+        spectrum_run(&s, s_pcm, SPECTRUM_N, &f);
+
+        float other = 0.0f;
+        for (int j = 0; j < s.n_bands; j++) {
+            if (j != b && f.band_rms[j] > other) other = f.band_rms[j];
+        }
+        float sep_db = 20.0f * log10f(f.band_rms[b] / (other + 1e-6f));
+        char msg[96];
+        snprintf(msg, sizeof(msg), "band %d: %.0f Hz tone, %.2f of RMS in band, %.1f dB over the next band",
+                 b, hz, f.band_rms[b] / f.rms, sep_db);
+        TEST_MESSAGE(msg);
+
+        TEST_ASSERT_GREATER_THAN(0.8f * f.rms, f.band_rms[b]);
+        TEST_ASSERT_LESS_THAN(1.05f * f.rms, f.band_rms[b]);
+        TEST_ASSERT_GREATER_THAN(20.0f, sep_db);
+    }
+}
+
+static void test_rms_ignores_dc() {
+    tone(1000.0f, 4000.0f, 3000.0f);
+    SpectrumFrame f;
+    spectrum_run(&s, s_pcm, SPECTRUM_N, &f);
+    TEST_ASSERT_FLOAT_WITHIN(40.0f, 4000.0f / sqrtf(2.0f), f.rms);
+}
+
+static void test_flux_marks_onsets_only() {
+    SpectrumFrame f;
+    memset(s_pcm, 0, sizeof(s_pcm));
+    spectrum_run(&s, s_pcm, SPECTRUM_N, &f);
+    TEST_ASSERT_EQUAL_INT(0, (int)f.flux);
+
+    tone(1000.0f, 4000.0f);
+    spectrum_run(&s, s_pcm, SPECTRUM_N, &f);
+    float onset = f.flux;
+    tone(1000.0f, 4000.0f, 0.0f, SPECTRUM_N);   // same tone, next block
+    spectrum_run(&s, s_pcm, SPECTRUM_N, &f);
+
+    TEST_ASSERT_GREATER_THAN(100.0f, onset);
+    TEST_ASSERT_LESS_THAN(0.05f * onset, f.flux);
+}
+
+static void test_short_block_and_many_bands() {
+    spectrum_init(&s, SPECTRUM_MAX_BANDS, 40.0f, 8000.0f, MIC_SAMPLE_RATE);
+    TEST_ASSERT_GREATER_OR_EQUAL(12, s.n_bands);
+    for (int b = 0; b < s.n_bands; b++) TEST_ASSERT_GREATER_THAN(s.edge[b], s.edge[b + 1]);
+
+    tone(300.0f, 1000.0f);
+    SpectrumFrame f;
+    spectrum_run(&s, s_pcm, 300, &f);   // rest of the block treated as silence
+    TEST_ASSERT_GREATER_THAN(600.0f, f.rms);
+    TEST_ASSERT_LESS_THAN(800.0f, f.rms);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bands_cover_range_in_order);
+    RUN_TEST(test_fft_matches_dft);
+    RUN_TEST(test_tone_lands_in_its_band);
+    RUN_TEST(test_rms_ignores_dc);
+    RUN_TEST(test_flux_marks_onsets_only);
+    RUN_TEST(test_short_block_and_many_bands);
+    return UNITY_END();
+}
@@ -0,0 +1,144 @@
+// Host tests for state/spotify_sync with a fake clock: poll intervals per
+// state, track-end prediction, command follow-ups, error backoff, and a
+// simulated listening session against a stand-in Spotify.
+#include <unity.h>
+#include "state/spotify_sync.h"
+#include "config.h"
+
+#include <stdio.h>
+
+static SpotifySync s;
+static uint32_t    t;   // fake clock
+
+void setUp() {
+    t = 1000;
+    sp_sync_init(&s, t);
+}
+
+void tearDown() {}
+
+// ---------------------------------------------------------------------------
+// Intervals
+// ---------------------------------------------------------------------------
+
+static void test_first_poll_is_immediate() {
+    TEST_ASSERT_EQUAL_UINT32(0, sp_sync_wait_ms(&s, t));
+    TEST_ASSERT_EQUAL_INT(SP_SYNC_UNKNOWN, s.state);
+}
+
+static void test_playing_polls_at_most_every_playing_interval() {
+    sp_sync_on_track(&s, true, 10000, 200000, t);
+    TEST_ASSERT_EQUAL_UINT32(SPOTIFY_POLL_PLAYING_MS, sp_sync_wait_ms(&s, t));
+    TEST_ASSERT_EQUAL_UINT32(0, s.track_end_polls);
+}
+
+static void test_polls_just_after_predicted_track_end() {
+    sp_sync_on_track(&s, true, 196000, 200000, t);
+    TEST_ASSERT_EQUAL_UINT32(4000 + SPOTIFY_POLL_END_MARGIN_MS, sp_sync_wait_ms(&s, t));
+    TEST_ASSERT_EQUAL_UINT32(1, s.track_end_polls);
+}
+
+static void test_unknown_duration_uses_playing_interval() {
+    sp_sync_on_track(&s, true, 5000, 0, t);
+    TEST_ASSERT_EQUAL_UINT32(SPOTIFY_POLL_PLAYING_MS, sp_sync_wait_ms(&s, t));
+}
+
+static void test_paused_and_nothing_intervals() {
+    sp_sync_on_track(&s, false, 1000, 200000, t);
+    TEST_ASSERT_EQUAL_UINT32(SPOTIFY_POLL_PAUSED_MS, sp_sync_wait_ms(&s, t));
+    sp_sync_on_nothing(&s, t);
+    TEST_ASSERT_EQUAL_UINT32(SPOTIFY_POLL_IDLE_MS, sp_sync_wait_ms(&s, t));
+    TEST_ASSERT_EQUAL_INT(SP_SYNC_NOTHING, s.state);
+}
+
+static void test_command_polls_now_then_follows_up() {
+    sp_sync_on_nothing(&s, t);
+    sp_sync_on_command(&s, t);
+    TEST_ASSERT_EQUAL_UINT32(0, sp_sync_wait_ms(&s, t));
+    for (int i = 0; i < 3; i++) {
+        sp_sync_on_nothing(&s, t);
+        TEST_ASSERT_EQUAL_UINT32(SPOTIFY_POLL_CONFIRM_MS, sp_sync_wait_ms(&s, t));
+    }
+    sp_sync_on_nothing(&s, t);
+    TEST_ASSERT_EQUAL_UINT32(SPOTIFY_POLL_IDLE_MS, sp_sync_wait_ms(&s, t));
+}
+
+static void test_follow_up_keeps_a_sooner_track_end() {
+    sp_sync_on_command(&s, t);
+    sp_sync_on_track(&s, true, 199500, 200000, t);
+    TEST_ASSERT_LESS_OR_EQUAL(SPOTIFY_POLL_CONFIRM_MS, sp_sync_wait_ms(&s, t));
+}
+
+static void test_errors_back_off_to_idle_interval() {
+    uint32_t want = SPOTIFY_POLL_RETRY_MS;
+    for (int i = 0; i < 8; i++) {
+        sp_sync_on_error(&s, t);
+        TEST_ASSERT_EQUAL_UINT32(want, sp_sync_wait_ms(&s, t));
+        want = (want * 2 > SPOTIFY_POLL_IDLE_MS) ? SPOTIFY_POLL_IDLE_MS : want * 2;
+    }
+    sp_sync_on_track(&s, true, 0, 0, t);
+    TEST_ASSERT_EQUAL_INT(0, s.failures);
+    TEST_ASSERT_EQUAL_UINT32(SPOTIFY_POLL_PLAYING_MS, sp_sync_wait_ms(&s, t));
+}
+
+static void test_many_errors_do_not_overflow() {
+    for (int i = 0; i < 300; i++) sp_sync_on_error(&s, t);
+    TEST_ASSERT_EQUAL_UINT32(SPOTIFY_POLL_IDLE_MS, sp_sync_wait_ms(&s, t));
+}
+
+static void test_clock_wrap() {
+    t = 0xFFFFF000u;
+    sp_sync_on_track(&s, true, 0, 300000, t);
+    TEST_ASSERT_EQUAL_UINT32(SPOTIFY_POLL_PLAYING_MS - 8000, sp_sync_wait_ms(&s, t + 8000));
+    TEST_ASSERT_EQUAL_UINT32(0, sp_sync_wait_ms(&s, t + SPOTIFY_POLL_PLAYING_MS + 1));
+}
+
+// ---------------------------------------------------------------------------
+// Listening session against a stand-in Spotify
+// ---------------------------------------------------------------------------
+
+static void test_session_polls_rarely_and_catches_track_changes() {
+    // Back-to-back 3-minute tracks for 6 minutes, fake clock in 100 ms steps,
+    // joined 3.7 s into the first track so its end is off the poll grid.
+    const uint32_t track_ms = 180000, session_ms = 360000, step = 100, joined = 3700;
+    sp_sync_init(&s, 0);
+    int polls = 0;
+    uint32_t seen_track = 0, worst_lag = 0;
+    for (uint32_t now = 0; now < session_ms; now += step) {
+        if (sp_sync_wait_ms(&s, now) != 0) continue;
+        polls++;
+        uint32_t pos   = now + joined;
+        uint32_t track = pos / track_ms;
+        if (track != seen_track) {
+            uint32_t lag = pos - track * track_ms;
+            if (lag > worst_lag) worst_lag = lag;
+            seen_track = track;
+        }
+        sp_sync_on_track(&s, true, pos % track_ms, track_ms, now);
+    }
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "6 min session: %d polls (1 s polling: %u), track change seen after %u ms",
+             polls, (unsigned)(session_ms / 1000), (unsigned)worst_lag);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_LESS_OR_EQUAL(session_ms / SPOTIFY_POLL_PLAYING_MS + 4, (uint32_t)polls);
+    TEST_ASSERT_EQUAL_UINT32(2, seen_track);
+    TEST_ASSERT_LESS_OR_EQUAL(SPOTIFY_POLL_END_MARGIN_MS + step, worst_lag);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_poll_is_immediate);
+    RUN_TEST(test_playing_polls_at_most_every_playing_interval);
+    RUN_TEST(test_polls_just_after_predicted_track_end);
+    RUN_TEST(test_unknown_duration_uses_playing_interval);
+    RUN_TEST(test_paused_and_nothing_intervals);
+    RUN_TEST(test_command_polls_now_then_follows_up);
+    RUN_TEST(test_follow_up_keeps_a_sooner_track_end);
+    RUN_TEST(test_errors_back_off_to_idle_interval);
+    RUN_TEST(test_many_errors_do_not_overflow);
+    RUN_TEST(test_clock_wrap);
+    RUN_TEST(test_session_polls_rarely_and_catches_track_changes);
+    return UNITY_END();
+}
@@ -0,0 +1,239 @@
+// Host tests for state/volume_scheduler: leading/trailing edge, learning the
+// gap, retry cap, changes made elsewhere, and encoder bursts against a
+// stand-in speaker with a configurable rate limit.
+#include <unity.h>
+#include "state/volume_scheduler.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <vector>
+
+static VolumeScheduler s;
+
+void setUp() {
+    vol_sched_init(&s, VOLUME_DEBOUNCE_MS);
+    vol_sched_on_readback(&s, 20, 0);   // speaker volume known, as at boot
+}
+
+void tearDown() {}
+
+// Send whatever is due at t and report it accepted.
+static int send_ok(uint32_t t) {
+    int v = vol_sched_poll(&s, t);
+    if (v >= 0) vol_sched_on_sent(&s, v, true, t);
+    return v;
+}
+
+// ---------------------------------------------------------------------------
+// Unit behaviour
+// ---------------------------------------------------------------------------
+
+static void test_first_change_goes_out_at_once() {
+    vol_sched_set_target(&s, 21);
+    TEST_ASSERT_EQUAL_UINT32(0, vol_sched_wait_ms(&s, 1000));
+    TEST_ASSERT_EQUAL_INT(21, send_ok(1000));
+    TEST_ASSERT_EQUAL_INT(-1, vol_sched_poll(&s, 1000));
+}
+
+static void test_changes_inside_the_gap_coalesce() {
+    vol_sched_set_target(&s, 21);
+    send_ok(1000);
+    vol_sched_set_target(&s, 22);
+    vol_sched_set_target(&s, 23);
+    TEST_ASSERT_EQUAL_INT(-1, vol_sched_poll(&s, 1000 + VOLUME_DEBOUNCE_MS - 1));
+    TEST_ASSERT_EQUAL_INT(23, send_ok(1000 + VOLUME_DEBOUNCE_MS));
+    TEST_ASSERT_EQUAL_UINT32(1, s.coalesced);
+}
+
+static void test_confirm_shrinks_the_gap() {
+    vol_sched_set_target(&s, 21);
+    send_ok(1000);
+    vol_sched_on_readback(&s, 21, 1100);
+    TEST_ASSERT_EQUAL_UINT32(VOLUME_DEBOUNCE_MS - VOLUME_GAP_STEP_MS, s.gap_ms);
+    TEST_ASSERT_EQUAL_UINT32(1, s.confirmed);
+}
+
+static void test_old_value_is_a_rejection() {
+    vol_sched_set_target(&s, 21);
+    send_ok(1000);
+    TEST_ASSERT_FALSE(vol_sched_on_readback(&s, 20, 1100));   // speaker kept 20
+    TEST_ASSERT_EQUAL_UINT32(1, s.rejected);
+    TEST_ASSERT_GREATER_THAN(VOLUME_DEBOUNCE_MS, s.gap_ms);
+    TEST_ASSERT_EQUAL_INT(21, s.pending);                      // queued again
+}
+
+static void test_retries_are_capped() {
+    vol_sched_set_target(&s, 30);
+    uint32_t t = 1000;
+    int sends = 0;
+    for (int i = 0; i < 10; i++, t += VOLUME_GAP_MAX_MS) {
+        int v = vol_sched_poll(&s, t);
+        if (v < 0) break;
+        vol_sched_on_sent(&s, v, false, t);   // speaker unreachable
+        sends++;
+    }
+    TEST_ASSERT_EQUAL_INT(1 + VOLUME_MAX_RETRIES, sends);
+    TEST_ASSERT_EQUAL_INT(-1, s.pending);
+    TEST_ASSERT_EQUAL_UINT32(1, s.dropped);
+    TEST_ASSERT_FALSE(vol_sched_busy(&s, t));
+}
+
+static void test_new_target_resets_retries() {
+    vol_sched_set_target(&s, 30);
+    uint32_t t = 1000;
+    for (int i = 0; i <= VOLUME_MAX_RETRIES; i++, t += VOLUME_GAP_MAX_MS) {
+        vol_sched_on_sent(&s, vol_sched_poll(&s, t), false, t);
+    }
+    vol_sched_set_target(&s, 31);
+    TEST_ASSERT_EQUAL_INT(31, vol_sched_poll(&s, t));
+    vol_sched_on_sent(&s, 31, false, t);
+    TEST_ASSERT_EQUAL_INT(31, s.pending);   // a fresh target gets its retries
+}
+
+static void test_change_made_elsewhere_wins() {
+    vol_sched_set_target(&s, 21);
+    send_ok(1000);
+    vol_sched_set_target(&s, 22);           // waiting for the gap
+    TEST_ASSERT_TRUE(vol_sched_on_readback(&s, 45, 1100));   // app set 45
+    TEST_ASSERT_EQUAL_INT(-1, s.pending);
+    TEST_ASSERT_EQUAL_UINT32(1, s.external);
+    TEST_ASSERT_EQUAL_UINT32(0, s.rejected);
+    TEST_ASSERT_EQUAL_INT(-1, vol_sched_poll(&s, 5000));     // nothing pushed back
+}
+
+static void test_earlier_send_is_still_catching_up() {
+    vol_sched_set_target(&s, 21);
+    send_ok(1000);
+    vol_sched_set_target(&s, 22);
+    send_ok(1000 + VOLUME_DEBOUNCE_MS);
+    TEST_ASSERT_FALSE(vol_sched_on_readback(&s, 21, 1300));
+    TEST_ASSERT_EQUAL_UINT32(0, s.rejected);
+    TEST_ASSERT_EQUAL_UINT32(0, s.external);
+    vol_sched_on_readback(&s, 22, 1400);
+    TEST_ASSERT_EQUAL_UINT32(1, s.confirmed);
+}
+
+static void test_confirm_window_outlasts_poll_hold_off() {
+    // Under fallback polling the first volume read comes after the settle
+    // hold-off plus up to one poll interval; it must still count.
+    vol_sched_set_target(&s, 21);
+    send_ok(1000);
+    vol_sched_on_readback(&s, 21, 1000 + VOLUME_SETTLE_MS + KEF_STATE_POLL_INTERVAL);
+    TEST_ASSERT_EQUAL_UINT32(1, s.confirmed);
+}
+
+// ---------------------------------------------------------------------------
+// Encoder bursts against a stand-in speaker
+// ---------------------------------------------------------------------------
+
+// Ignores writes closer than limit_ms to the last one it accepted, and
+// reports its volume rtt_ms + 30 ms after each write, like the event queue.
+struct Speaker {
+    uint32_t limit_ms = 0, rtt_ms = 0;
+    int      vol = 20;
+    bool     any = false;
+    uint32_t last_accept = 0;
+    std::vector<std::pair<uint32_t, int>> events;
+
+    void write(uint32_t t, int v) {
+        if (!any || t - last_accept >= limit_ms) {
+            vol = v;
+            last_accept = t;
+            any = true;
+        }
+        events.push_back({ t + rtt_ms + 30, vol });
+    }
+};
+
+static uint32_t s_rng = 1;
+static uint32_t rnd(uint32_t n) {
+    s_rng = s_rng * 1103515245u + 12345u;
+    return (s_rng >> 16) % n;
+}
+
+struct BurstResult {
+    int      dropped;
+    uint32_t mean_latency_ms;
+};
+
+static BurstResult run_bursts(uint32_t limit_ms) {
+    Speaker sp;
+    sp.limit_ms = limit_ms;
+    sp.rtt_ms   = 40;
+    s_rng = 1;
+    uint32_t t = 0;
+    int target = 20, dropped = 0, reached_n = 0;
+    uint64_t latency_sum = 0;
+
+    auto step = [&](uint32_t until, uint32_t *reached) {
+        for (; t < until; t++) {
+            int v = vol_sched_poll(&s, t);
+            if (v >= 0) {
+                sp.write(t, v);
+                vol_sched_on_sent(&s, v, true, t + sp.rtt_ms);
+            }
+            for (auto it = sp.events.begin(); it != sp.events.end();) {
+                if (it->first <= t) {
+                    vol_sched_on_readback(&s, it->second, t);
+                    it = sp.events.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            if (reached && !*reached && sp.vol == target) *reached = t;
+        }
+    };
+
+    for (int burst = 0; burst < 200; burst++) {
+        int clicks = 1 + (int)rnd(12);
+        uint32_t last_click = t;
+        for (int c = 0; c < clicks; c++) {
+            target += rnd(2) ? 1 : -1;
+            if (target < 0) target = 0;
+            vol_sched_set_target(&s, target);
+            last_click = t;
+            step(t + 10 + rnd(60), nullptr);
+        }
+        uint32_t reached = 0;
+        step(t + 3000, &reached);
+        if (!reached) dropped++;
+        else { latency_sum += reached - last_click; reached_n++; }
+    }
+    return { dropped, (uint32_t)(reached_n ? latency_sum / reached_n : 0) };
+}
+
+static void test_bursts_against_rate_limited_speaker() {
+    const uint32_t limits[] = { 150, 250, 400 };
+    for (uint32_t limit : limits) {
+        vol_sched_init(&s, VOLUME_DEBOUNCE_MS);
+        vol_sched_on_readback(&s, 20, 0);
+        BurstResult r = run_bursts(limit);
+
+        char msg[160];
+        snprintf(msg, sizeof(msg),
+                 "limit %u ms: gap %u ms, latency %u ms, dropped %d, sent %u, rejected %u, coalesced %u",
+                 (unsigned)limit, (unsigned)s.gap_ms, (unsigned)r.mean_latency_ms, r.dropped,
+                 (unsigned)s.sends, (unsigned)s.rejected, (unsigned)s.coalesced);
+        TEST_MESSAGE(msg);
+
+        TEST_ASSERT_EQUAL_INT(0, r.dropped);
+        TEST_ASSERT_GREATER_OR_EQUAL(limit - VOLUME_GAP_STEP_MS, s.gap_ms);
+        TEST_ASSERT_LESS_OR_EQUAL(limit + limit / 2, s.gap_ms);
+        TEST_ASSERT_EQUAL_UINT32(0, s.external);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_change_goes_out_at_once);
+    RUN_TEST(test_changes_inside_the_gap_coalesce);
+    RUN_TEST(test_confirm_shrinks_the_gap);
+    RUN_TEST(test_old_value_is_a_rejection);
+    RUN_TEST(test_retries_are_capped);
+    RUN_TEST(test_new_target_resets_retries);
+    RUN_TEST(test_change_made_elsewhere_wins);
+    RUN_TEST(test_earlier_send_is_still_catching_up);
+    RUN_TEST(test_confirm_window_outlasts_poll_hold_off);
+    RUN_TEST(test_bursts_against_rate_limited_speaker);
+    return UNITY_END();
+}
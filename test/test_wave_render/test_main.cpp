@@ -0,0 +1,153 @@
+// Host tests for ui/wave_render: the fixed-point renderer against the float
+// reference within a per-pixel tolerance, plus a µs/frame benchmark of both.
+// Host timings only compare the two paths; they are not ESP32 numbers.
+#include <unity.h>
+#include "ui/wave_render.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+#define FRAME_BYTES (WAVE_CANVAS_W * WAVE_CANVAS_H * 3)
+
+// Pixels both renderers draw may differ by one RGB565 step per channel.
+// A pixel is drawn (alpha 255) only once a channel passes the renderer's
+// threshold of 10/255, so rounding can flip pixels right at it; those must
+// be that dim and rare.
+#define COLOR_TOL    1
+#define EDGE_MAX     12       // brightest channel of a flipped pixel, 0..255
+#define EDGE_MAX_PPM 500      // flipped pixels per million
+
+static std::vector<uint8_t> s_fast(FRAME_BYTES), s_ref(FRAME_BYTES);
+
+void setUp() { srand(1); }
+
+void tearDown() {}
+
+static void random_params(WaveParams *p, int frame) {
+    for (int k = 0; k < WAVE_BANDS; k++) {
+        p->amp_q15[k] = (frame % 10 == 0) ? 32768 : (uint16_t)(rand() % 32769);
+        p->phase[k]   = (uint32_t)rand() * 2654435761u;
+    }
+    if (frame % 50 == 0) {
+        for (int k = 0; k < WAVE_BANDS; k++) p->amp_q15[k] = 0;
+    }
+}
+
+struct Diff {
+    int max_color;   // largest per-channel RGB565 step difference
+    int flipped;     // pixels drawn by only one renderer
+    int max_edge;    // brightest channel among those, 0..255
+};
+
+// Lower bound of a pixel's brightest channel, back in 0..255.
+static int brightest(uint16_t c) {
+    int r = (c >> 11) << 3, g = ((c >> 5) & 63) << 2, b = (c & 31) << 3;
+    int m = r > g ? r : g;
+    return m > b ? m : b;
+}
+
+static Diff compare(const uint8_t *a, const uint8_t *b) {
+    Diff d = { 0, 0, 0 };
+    for (int i = 0; i < FRAME_BYTES; i += 3) {
+        uint16_t ca = a[i] | (a[i + 1] << 8), cb = b[i] | (b[i + 1] << 8);
+        if (!a[i + 2] && !b[i + 2]) continue;
+        if (!a[i + 2] || !b[i + 2]) {
+            int e = brightest(a[i + 2] ? ca : cb);
+            if (e > d.max_edge) d.max_edge = e;
+            d.flipped++;
+            continue;
+        }
+        int dr = abs((ca >> 11) - (cb >> 11));
+        int dg = abs(((ca >> 5) & 63) - ((cb >> 5) & 63));
+        int db = abs((ca & 31) - (cb & 31));
+        int m = dr > dg ? dr : dg;
+        m = m > db ? m : db;
+        if (m > d.max_color) d.max_color = m;
+    }
+    return d;
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+static void test_silence_is_transparent() {
+    WaveParams p = {};
+    s_fast.assign(FRAME_BYTES, 0xAA);
+    wave_render(s_fast.data(), &p);
+    for (int i = 2; i < FRAME_BYTES; i += 3) TEST_ASSERT_EQUAL_INT(0, s_fast[i]);
+}
+
+static void test_matches_float_reference() {
+    const int frames = 500;
+    Diff worst = { 0, 0, 0 };
+    for (int f = 0; f < frames; f++) {
+        WaveParams p;
+        random_params(&p, f);
+        wave_render(s_fast.data(), &p);
+        wave_render_ref(s_ref.data(), &p);
+        Diff d = compare(s_fast.data(), s_ref.data());
+        if (d.max_color > worst.max_color) worst.max_color = d.max_color;
+        if (d.max_edge > worst.max_edge) worst.max_edge = d.max_edge;
+        worst.flipped += d.flipped;
+    }
+    const long pixels = (long)frames * WAVE_CANVAS_W * WAVE_CANVAS_H;
+    const long ppm    = worst.flipped * 1000000L / pixels;
+    char msg[112];
+    snprintf(msg, sizeof(msg), "worst colour difference %d RGB565 steps; %d threshold pixels (%ld ppm), max %d/255",
+             worst.max_color, worst.flipped, ppm, worst.max_edge);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_OR_EQUAL(COLOR_TOL, worst.max_color);
+    TEST_ASSERT_LESS_OR_EQUAL(EDGE_MAX, worst.max_edge);
+    TEST_ASSERT_LESS_OR_EQUAL(EDGE_MAX_PPM, ppm);
+}
+
+static void test_full_scale_stays_on_canvas() {
+    // Every band at full level: glow must reach but not overrun the edges.
+    WaveParams p;
+    for (int k = 0; k < WAVE_BANDS; k++) {
+        p.amp_q15[k] = 32768;
+        p.phase[k]   = WAVE_RADIANS(1.5707963f);   // peaks at the centre
+    }
+    std::vector<uint8_t> guarded(FRAME_BYTES + 64, 0x5A);
+    wave_render(guarded.data(), &p);
+    for (int i = FRAME_BYTES; i < FRAME_BYTES + 64; i++) TEST_ASSERT_EQUAL_INT(0x5A, guarded[i]);
+    wave_render_ref(s_ref.data(), &p);
+    Diff d = compare(guarded.data(), s_ref.data());
+    TEST_ASSERT_LESS_OR_EQUAL(COLOR_TOL, d.max_color);
+}
+
+static void test_benchmark() {
+    WaveParams p;
+    for (int k = 0; k < WAVE_BANDS; k++) {
+        p.amp_q15[k] = 30000;
+        p.phase[k]   = k * 1000000000u;
+    }
+    const int frames = 1000;
+    double us[2];
+    for (int pass = 0; pass < 2; pass++) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            p.phase[0] += 12345678;
+            (pass ? wave_render_ref : wave_render)(s_fast.data(), &p);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        us[pass] = std::chrono::duration<double, std::micro>(t1 - t0).count() / frames;
+    }
+    char msg[96];
+    snprintf(msg, sizeof(msg), "host: fixed-point %.1f us/frame, float reference %.1f us/frame",
+             us[0], us[1]);
+    TEST_MESSAGE(msg);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_silence_is_transparent);
+    RUN_TEST(test_matches_float_reference);
+    RUN_TEST(test_full_scale_stays_on_canvas);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}